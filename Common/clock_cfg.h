@@ -0,0 +1,31 @@
+ /******************************************************************************
+ *
+ * Module: Common - Clock Configuration
+ *
+ * File Name: clock_cfg.h
+ *
+ * Description: Single source of the system clock frequencies. The kernel,
+ *              the clock manager and every driver timing derive from it.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef CLOCK_CFG_H_
+#define CLOCK_CFG_H_
+
+/* Main oscillator (crystal) of the Tiva C LaunchPad, used directly in low power mode */
+#define CLOCK_MOSC_HZ                   (16000000UL)
+
+/* 400 MHz PLL divided by (CLOCK_PLL_SYSDIV2 + 1) in high performance mode */
+#define CLOCK_PLL_SYSDIV2               (4U)
+#define CLOCK_PLL_HZ                    (400000000UL / (CLOCK_PLL_SYSDIV2 + 1U))
+
+/* Frequency the system runs at from boot until the first mode switch,
+ * the kernel programs SysTick for it when the scheduler starts */
+#define CLOCK_BOOT_HZ                   CLOCK_PLL_HZ
+
+/* Delay_MS busy loop iterations per millisecond, measured at 10 MHz */
+#define CLOCK_DELAY_ITERATIONS_PER_MS_AT_10MHZ  (369UL)
+
+#endif /* CLOCK_CFG_H_ */
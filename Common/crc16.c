@@ -0,0 +1,35 @@
+ /******************************************************************************
+ *
+ * Module: Common - CRC-16
+ *
+ * File Name: crc16.c
+ *
+ * Description: CRC-16/CCITT-FALSE computed a nibble at a time, a 16 entry
+ *              table is a good trade between flash and speed on the M4.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#include "crc16.h"
+
+static const uint16 usCrcNibbleTable[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+uint16 CRC16_Update(uint16 usCrc, const uint8 *pucData, uint32 ulLength)
+{
+    while (ulLength-- > 0)
+    {
+        usCrc = (uint16)((usCrc << 4) ^ usCrcNibbleTable[((usCrc >> 12) ^ (*pucData >> 4)) & 0x0F]);
+        usCrc = (uint16)((usCrc << 4) ^ usCrcNibbleTable[((usCrc >> 12) ^ (*pucData & 0x0F)) & 0x0F]);
+        pucData++;
+    }
+    return usCrc;
+}
+
+uint16 CRC16_Compute(const uint8 *pucData, uint32 ulLength)
+{
+    return CRC16_Update(CRC16_INITIAL_VALUE, pucData, ulLength);
+}
@@ -0,0 +1,26 @@
+ /******************************************************************************
+ *
+ * Module: Common - CRC-16
+ *
+ * File Name: crc16.h
+ *
+ * Description: CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF,
+ *              no reflection, no final XOR). Check value of "123456789" is 0x29B1.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef CRC16_H_
+#define CRC16_H_
+
+#include "std_types.h"
+
+#define CRC16_INITIAL_VALUE     ((uint16)0xFFFF)
+
+/* Continue a CRC over more data, start with CRC16_INITIAL_VALUE */
+extern uint16 CRC16_Update(uint16 usCrc, const uint8 *pucData, uint32 ulLength);
+
+extern uint16 CRC16_Compute(const uint8 *pucData, uint32 ulLength);
+
+#endif /* CRC16_H_ */
@@ -0,0 +1,149 @@
+ /******************************************************************************
+ *
+ * Module: Common - SPSC Ring
+ *
+ * File Name: spsc_ring.h
+ *
+ * Description: Wait-free single-producer / single-consumer ring buffer for
+ *              the interrupt to task data paths. Header only. The producer
+ *              only writes the head and the consumer only writes the tail,
+ *              both free running, so neither side ever locks, disables
+ *              interrupts or waits for the other. A full ring drops the new
+ *              elements and counts them.
+ *
+ *              The element storage and the indices are accessed as volatile,
+ *              which keeps the element writes before the head update on the
+ *              single Cortex-M4 core. A multi-core target would also need a
+ *              DMB between them.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef SPSC_RING_H_
+#define SPSC_RING_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* The size must be a power of two, check it with
+ * #if !SPSC_RING_IS_POWER_OF_TWO(SIZE) ... #error */
+#define SPSC_RING_IS_POWER_OF_TWO(SIZE)     (((SIZE) != 0U) && (((SIZE) & ((SIZE) - 1U)) == 0U))
+
+/* Static initializer over an array whose size is a power of two, e.g.
+ * static SpscRing xRing = SPSC_RING_INITIALIZER(ucStorage); */
+#define SPSC_RING_INITIALIZER(STORAGE)      { (STORAGE), (sizeof(STORAGE) / sizeof((STORAGE)[0])) - 1U, 0U, 0U, 0U }
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct
+{
+    volatile void *pvStorage;
+    uint32 ulMask;                  /* Elements - 1 */
+    volatile uint32 ulHead;         /* Free running, written by the producer only */
+    volatile uint32 ulTail;         /* Free running, written by the consumer only */
+    volatile uint32 ulOverflows;    /* Elements dropped because the ring was full, written by the producer only */
+}SpscRing;
+
+/*******************************************************************************
+ *                            Functions Definitions                            *
+ *******************************************************************************/
+
+/* Elements waiting for the consumer, exact for the consumer, a lower bound for the producer */
+static inline uint32 SpscRing_Count(const SpscRing *pxRing)
+{
+    return pxRing->ulHead - pxRing->ulTail;
+}
+
+/* Free elements, exact for the producer, a lower bound for the consumer */
+static inline uint32 SpscRing_Free(const SpscRing *pxRing)
+{
+    return (pxRing->ulMask + 1U) - (pxRing->ulHead - pxRing->ulTail);
+}
+
+static inline uint32 SpscRing_GetOverflows(const SpscRing *pxRing)
+{
+    return pxRing->ulOverflows;
+}
+
+/* Push, pop and their batch versions for one element type. Push returns
+ * FALSE when the ring is full, the batch push returns the elements it could
+ * take and counts the others as overflows. Pop returns FALSE when the ring is
+ * empty, the batch pop returns the elements it copied. A batch publishes its
+ * elements with a single index update. */
+#define SPSC_RING_DEFINE_TYPE(SUFFIX, TYPE)                                                     \
+static inline boolean SpscRing_Push##SUFFIX(SpscRing *pxRing, TYPE xValue)                      \
+{                                                                                               \
+    uint32 ulHead = pxRing->ulHead;                                                             \
+                                                                                                \
+    if ((ulHead - pxRing->ulTail) > pxRing->ulMask)                                             \
+    {                                                                                           \
+        pxRing->ulOverflows++;                                                                  \
+        return FALSE;                                                                           \
+    }                                                                                           \
+    ((volatile TYPE *) pxRing->pvStorage)[ulHead & pxRing->ulMask] = xValue;                    \
+    pxRing->ulHead = ulHead + 1U;                                                               \
+    return TRUE;                                                                                \
+}                                                                                               \
+                                                                                                \
+static inline uint32 SpscRing_PushBatch##SUFFIX(SpscRing *pxRing, const TYPE *pxValues, uint32 ulCount) \
+{                                                                                               \
+    uint32 ulHead = pxRing->ulHead;                                                             \
+    uint32 ulFree = (pxRing->ulMask + 1U) - (ulHead - pxRing->ulTail);                          \
+    uint32 ulIndex;                                                                             \
+                                                                                                \
+    if (ulCount > ulFree)                                                                       \
+    {                                                                                           \
+        pxRing->ulOverflows += ulCount - ulFree;                                                \
+        ulCount = ulFree;                                                                       \
+    }                                                                                           \
+    for (ulIndex = 0; ulIndex < ulCount; ulIndex++)                                             \
+    {                                                                                           \
+        ((volatile TYPE *) pxRing->pvStorage)[(ulHead + ulIndex) & pxRing->ulMask] = pxValues[ulIndex]; \
+    }                                                                                           \
+    pxRing->ulHead = ulHead + ulCount;                                                          \
+    return ulCount;                                                                             \
+}                                                                                               \
+                                                                                                \
+static inline boolean SpscRing_Pop##SUFFIX(SpscRing *pxRing, TYPE *pxValue)                     \
+{                                                                                               \
+    uint32 ulTail = pxRing->ulTail;                                                             \
+                                                                                                \
+    if (pxRing->ulHead == ulTail)                                                               \
+    {                                                                                           \
+        return FALSE;                                                                           \
+    }                                                                                           \
+    *pxValue = ((volatile TYPE *) pxRing->pvStorage)[ulTail & pxRing->ulMask];                  \
+    pxRing->ulTail = ulTail + 1U;                                                               \
+    return TRUE;                                                                                \
+}                                                                                               \
+                                                                                                \
+static inline uint32 SpscRing_PopBatch##SUFFIX(SpscRing *pxRing, TYPE *pxValues, uint32 ulCount) \
+{                                                                                               \
+    uint32 ulTail = pxRing->ulTail;                                                             \
+    uint32 ulAvailable = pxRing->ulHead - ulTail;                                               \
+    uint32 ulIndex;                                                                             \
+                                                                                                \
+    if (ulCount > ulAvailable)                                                                  \
+    {                                                                                           \
+        ulCount = ulAvailable;                                                                  \
+    }                                                                                           \
+    for (ulIndex = 0; ulIndex < ulCount; ulIndex++)                                             \
+    {                                                                                           \
+        pxValues[ulIndex] = ((volatile TYPE *) pxRing->pvStorage)[(ulTail + ulIndex) & pxRing->ulMask]; \
+    }                                                                                           \
+    pxRing->ulTail = ulTail + ulCount;                                                          \
+    return ulCount;                                                                             \
+}
+
+/* SpscRing_PushU8(), SpscRing_PopBatchU32(), ... */
+SPSC_RING_DEFINE_TYPE(U8, uint8)
+SPSC_RING_DEFINE_TYPE(U16, uint16)
+SPSC_RING_DEFINE_TYPE(U32, uint32)
+
+#endif /* SPSC_RING_H_ */
@@ -0,0 +1,72 @@
+ /******************************************************************************
+ *
+ * Module: Common - Temperature
+ *
+ * File Name: temperature.h
+ *
+ * Description: Representation of the seat temperatures from the ADC to the
+ *              display. The fixed-point variant keeps the reading, controller
+ *              and display tasks off the FPU: on the ARM_CM4F port a task that
+ *              used a floating point instruction once stacks 34 more words at
+ *              every context switch. The float variant is the original one,
+ *              kept to compare the two (TEMPERATURE_FIXED_POINT).
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef TEMPERATURE_H_
+#define TEMPERATURE_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* 1: sint16 temperatures in 0.1 C, 0: float32 temperatures in C. The host
+ * tests (Tools/host) set it on the command line to build both. */
+#ifndef TEMPERATURE_FIXED_POINT
+#define TEMPERATURE_FIXED_POINT         (1U)
+#endif
+
+/* Sensor temperature at the ADC full scale count */
+#define TEMPERATURE_FULL_SCALE_C        (45U)
+
+#if (TEMPERATURE_FIXED_POINT == 1U)
+
+/* Whole C and 0.1 C constants */
+#define TEMPERATURE_FROM_C(C)           ((Temperature) ((C) * 10))
+#define TEMPERATURE_FROM_TENTHS(T)      ((Temperature) (T))
+
+/* Rounded down to 0.1 C, like the float variant shown on the display, and
+ * held at the largest sint16 where the float variant would go beyond it */
+#define TEMPERATURE_SATURATE(T)         (((T) > 32767UL) ? 32767UL : (T))
+#define TEMPERATURE_FROM_COUNTS(COUNTS, MAX_COUNT)  \
+    ((Temperature) TEMPERATURE_SATURATE(((uint32) (COUNTS) * (TEMPERATURE_FULL_SCALE_C * 10U)) / (MAX_COUNT)))
+
+#define TEMPERATURE_TO_TENTHS(T)        ((sint16) (T))
+
+#else
+
+#define TEMPERATURE_FROM_C(C)           ((Temperature) (C))
+#define TEMPERATURE_FROM_TENTHS(T)      ((Temperature) (T) / 10.0f)
+
+#define TEMPERATURE_FROM_COUNTS(COUNTS, MAX_COUNT)  \
+    ((Temperature) (COUNTS) * ((Temperature) TEMPERATURE_FULL_SCALE_C / (MAX_COUNT)))
+
+#define TEMPERATURE_TO_TENTHS(T)        ((sint16) ((T) * 10.0f))
+
+#endif
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+#if (TEMPERATURE_FIXED_POINT == 1U)
+typedef sint16 Temperature;             /* 0.1 C */
+#else
+typedef float32 Temperature;            /* C */
+#endif
+
+#endif /* TEMPERATURE_H_ */
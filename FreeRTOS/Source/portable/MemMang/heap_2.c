@@ -48,6 +48,9 @@
 
 #undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
 
+/* Services/Heap replaces this file when configHEAP_COALESCING is 1 */
+#if !defined( configHEAP_COALESCING ) || ( configHEAP_COALESCING == 0 )
+
 #if ( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
     #error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
 #endif
@@ -360,3 +363,5 @@ static void prvHeapInit( void ) /* PRIVILEGED_FUNCTION */
     pxFirstFreeBlock->pxNextFreeBlock = &xEnd;
 }
 /*-----------------------------------------------------------*/
+
+#endif /* configHEAP_COALESCING */
@@ -19,6 +19,7 @@
 #define FREERTOS_CONFIG_H
 
 #include "std_types.h"
+#include "clock_cfg.h"
 /******************************************************************************/
 /* Scheduling behavior related definitions. **********************************/
 /******************************************************************************/
@@ -26,8 +27,9 @@
 /* configCPU_CLOCK_HZ must be set to the frequency of the clock that drives 
  * the peripheral used to generate the kernels periodic tick interrupt.
  * This is very often, but not always, equal to the main system clock frequency.
- * Default frequency in Tiva-C Micro-controllers is 16Mhz */
-#define configCPU_CLOCK_HZ                    (( unsigned long )16000000)
+ * It is the boot frequency of Common/clock_cfg.h, the clock manager (Services/Clock)
+ * reprograms SysTick when it switches the system clock at runtime. */
+#define configCPU_CLOCK_HZ                    (( unsigned long )CLOCK_BOOT_HZ)
 
 /* configTICK_RATE_HZ sets frequency of the tick interrupt in Hz, so
  * in our case Tick time will be 10ms */
@@ -49,6 +51,14 @@
  * to be an unsigned 16-bit type. When configUSE_16_BIT_TICKS is set to 0, 
  * TickType_t is defined to be an unsigned 32-bit type. */
 #define configUSE_16_BIT_TICKS                0
+
+/* configUSE_TICKLESS_IDLE set to 2 stops the tick interrupt while the Idle task
+ * runs and uses the application vPortSuppressTicksAndSleep() (Services/Power)
+ * that wakes up with WTimer1 instead of the port SysTick implementation. */
+#define configUSE_TICKLESS_IDLE               2
+
+/* Minimum number of idle ticks before the tick interrupt is suppressed */
+#define configEXPECTED_IDLE_TIME_BEFORE_SLEEP 2
 /* Set the following configUSE_* constants to 1 to include the named feature in
  * the build, or 0 to exclude the named feature from the build. */
 #define configUSE_APPLICATION_TASK_TAG         1
@@ -63,7 +73,10 @@
  * or heap_4.c are included in the build. This value is defaulted to 4096 bytes but
  * it must be tailored to each application. Note the heap will appear in the .bss
  * section. */
-#define configTOTAL_HEAP_SIZE                 ((size_t)(4096))
+#define configTOTAL_HEAP_SIZE                 ((size_t)(22 * 1024))
+/* 1: Services/Heap, bounded-time allocation that merges the adjacent free
+ * blocks and keeps fragmentation and latency statistics. 0: heap_2.c */
+#define configHEAP_COALESCING                 1
 /* Set the following configUSE_* constants to 1 to include the named feature in
  * the build, or 0 to exclude the named feature from the build. */
 #define configUSE_MUTEXES                      1
@@ -78,6 +91,14 @@
 #define INCLUDE_vTaskDelay                      1
 #define INCLUDE_vTaskDelayUntil               1
 #define INCLUDE_xTimerPendFunctionCall          1
+/* Also fills every new stack with a known value for the stack profiling */
+#define INCLUDE_uxTaskGetStackHighWaterMark     1
+/* The context switch measurement deletes its tasks */
+#define INCLUDE_vTaskDelete                     1
+
+/* 2: at every context switch check the stack pointer and the last words of
+ * the stack pattern, vApplicationStackOverflowHook() is called on overflow */
+#define configCHECK_FOR_STACK_OVERFLOW          2
 
 /******************************************************************************/
 /* Software timer related definitions. ****************************************/
@@ -114,7 +135,7 @@
  * build.  The application writer is responsible for providing the hook function
  * for any set to 1. */
 #define configUSE_IDLE_HOOK                   0
-#define configUSE_TICK_HOOK                   0
+#define configUSE_TICK_HOOK                   1
 
 /******************************************************************************/
 /* ARM Cortex-M Specific Definitions. *****************************************/
@@ -148,22 +169,4 @@ PRIORITY THAN THIS! (higher priorities are lower numeric values. */
 /* Normal assert() semantics without relying on the provision of an assert.h header file. */
 #define configASSERT( x ) if( ( x ) == 0 ) { taskDISABLE_INTERRUPTS(); for( ;; ); }
 
-
-//extern uint32 ullTasksOutTime[13];
-//extern uint32 ullTasksInTime[13];
-//extern uint32 ullTasksExecutionTime[13];
-//
-//#define traceTASK_SWITCHED_IN()                                    \
-//do{                                                                \
-//    uint32 taskInTag = (uint32)(pxCurrentTCB->pxTaskTag);          \
-//    ullTasksInTime[taskInTag] = GPTM_WTimer0Read();                \
-//}while(0);
-//
-//#define traceTASK_SWITCHED_OUT()                                                                  \
-//do{                                                                                               \
-//    uint32 taskOutTag = (uint32)(pxCurrentTCB->pxTaskTag);                                        \
-//    ullTasksOutTime[taskOutTag] = GPTM_WTimer0Read();                                             \
-//    ullTasksExecutionTime[taskOutTag] = ullTasksOutTime[taskOutTag] - ullTasksInTime[taskOutTag]; \
-//}while(0);
-
 #endif /* FREERTOS_CONFIG_H */
@@ -6,23 +6,26 @@
  */
 
 #include "adc.h"
-#include "pll.h"
+#include "spsc_ring.h"
 
-volatile static uint32 adc0Res = 0 ;    /* PE2 */
-volatile static uint32 adc1Res = 0 ;    /* PE3 */
+#if !SPSC_RING_IS_POWER_OF_TWO(ADC_SAMPLE_BUFFER_SIZE)
+#error "ADC_SAMPLE_BUFFER_SIZE must be a power of two"
+#endif
 
-volatile static uint8  flag0      =0 ;
-volatile static uint8  flag1      =0 ;
+/* Conversion results: the sequencer handler is the producer, the reader the
+ * consumer (the callers of ADCn_readChannel() take turns) */
+static uint16 adc0Storage[ADC_SAMPLE_BUFFER_SIZE];    /* AIN0 */
+static uint16 adc1Storage[ADC_SAMPLE_BUFFER_SIZE];    /* AIN1 */
+static SpscRing adc0Samples = SPSC_RING_INITIALIZER(adc0Storage);
+static SpscRing adc1Samples = SPSC_RING_INITIALIZER(adc1Storage);
 
 void ADC0SS3_handler(void){
-    adc0Res = ADC0_ADCSSFIFO3 ;
-    flag0=1;
+    (void) SpscRing_PushU16(&adc0Samples, (uint16) ADC0_ADCSSFIFO3);
     ADC0_ADCISC= (1<<3)       ;
 }
 
 void ADC1SS3_handler(void){
-    adc1Res = ADC1_ADCSSFIFO3 ;
-    flag1=1;
+    (void) SpscRing_PushU16(&adc1Samples, (uint16) ADC1_ADCSSFIFO3);
     ADC1_ADCISC = (1<<3)          ;
 }
 
@@ -31,6 +34,12 @@ void ADC_ModuleInit(void){
     NVIC_EN0_R |= (1 << 17);
     //activate clock for ADC 1 and 2
     SYSCTL_RCGCADC_REG |= (0x03);
+    while(!(SYSCTL_PRADC_REG & 0x03));
+
+    /* Convert from the 16 MHz PIOSC instead of the PLL, so the ADC keeps
+     * working when the clock manager powers the PLL down */
+    ADC0_ADCCC = ADC_CC_CS_PIOSC;
+    ADC1_ADCCC = ADC_CC_CS_PIOSC;
 
     SYSCTL_RCGCGPIO_REG|=(1<<4) ;
 
@@ -87,26 +96,29 @@ void ADC_SampleSeqInit(void){
 
 
 void ADC_Init(void){
-    PLL_Init();
-
     ADC_ModuleInit();
     ADC_SampleSeqInit();
 }
 
+/* A conversion takes ~1 us, shorter than blocking the task would */
 uint32 ADC0_readChannel (void){
-    ADC0_ADCPSSI|=(1<<3) ;
-    while(flag0==0);
+    uint16 sample;
 
-    flag0=0;
+    ADC0_ADCPSSI|=(1<<3) ;
+    while(SpscRing_PopU16(&adc0Samples, &sample) == FALSE);
 
-    return  adc0Res ;
+    return  sample ;
 }
 
 uint32 ADC1_readChannel (void){
+    uint16 sample;
+
     ADC1_ADCPSSI|=(1<<3) ;
-    while(flag1==0);
+    while(SpscRing_PopU16(&adc1Samples, &sample) == FALSE);
 
-    flag1=0;
+    return  sample ;
+}
 
-    return  adc1Res ;
+uint32 ADC_GetOverflows (void){
+    return SpscRing_GetOverflows(&adc0Samples) + SpscRing_GetOverflows(&adc1Samples);
 }
@@ -19,6 +19,7 @@
 #define ADC0_ADCSSFIFO3 (*((volatile unsigned long*)0x400380A8))
 #define ADC0_ADCRIS (*((volatile unsigned long*)0x40038004))
 #define ADC0_ADCIM  (*((volatile unsigned long*)0x40038008))
+#define ADC0_ADCCC  (*((volatile unsigned long*)0x40038FC8))
 
 /*******************************************************************************************************************/
 /*ADC1 module*/
@@ -31,6 +32,12 @@
 #define ADC1_ADCSSFIFO3 (*((volatile unsigned long*)0x400390A8))
 #define ADC1_ADCRIS (*((volatile unsigned long*)0x40039004))
 #define ADC1_ADCIM  (*((volatile unsigned long*)0x40039008))
+#define ADC1_ADCCC  (*((volatile unsigned long*)0x40039FC8))
+
+#define ADC_CC_CS_PIOSC 0x1
+
+/* Conversion results buffered between the sequencer interrupt and the reader, power of two */
+#define ADC_SAMPLE_BUFFER_SIZE 4U
 
 /*******************************************************************************************************************/
 
@@ -42,6 +49,9 @@ void ADC_ModuleInit(void);
 uint32 ADC0_readChannel (void);
 uint32 ADC1_readChannel (void);
 
+/* Conversion results lost because the reader did not take them */
+uint32 ADC_GetOverflows (void);
+
 /* u32 ADC_Get_Data(ADC_PIN_ID PIN); */
 
 #endif /* ADC_H_ */
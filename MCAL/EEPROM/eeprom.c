@@ -0,0 +1,81 @@
+ /******************************************************************************
+ *
+ * Module: EEPROM
+ *
+ * File Name: eeprom.c
+ *
+ * Description: Source file for the TM4C123GH6PM on-chip EEPROM driver. The
+ *              EEPROM is addressed by word, a write only starts the
+ *              programming so the caller chooses how to wait for it.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#include "eeprom.h"
+#include "tm4c123gh6pm_registers.h"
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void prvWaitDone(void)
+{
+    while (EEPROM_EEDONE_REG & EEPROM_EEDONE_WORKING_MASK);
+}
+
+static void prvSelect(uint16 usWord)
+{
+    EEPROM_EEBLOCK_REG = usWord / EEPROM_WORDS_PER_BLOCK;
+    EEPROM_EEOFFSET_REG = usWord % EEPROM_WORDS_PER_BLOCK;
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+boolean EEPROM_Init(void)
+{
+    volatile uint32 ulDelay;
+
+    SYSCTL_RCGCEEPROM_REG |= (1<<0);  /* Enable clock EEPROM in run mode */
+    while(!(SYSCTL_PREEPROM_REG & (1<<0)));
+    prvWaitDone();
+    if (EEPROM_EESUPP_REG & EEPROM_EESUPP_RETRY_MASK)
+    {
+        return FALSE;
+    }
+
+    /* Reset to finish a write cut by a power loss */
+    SYSCTL_SREEPROM_REG |= (1<<0);
+    for (ulDelay = 0; ulDelay < 6U; ulDelay++);
+    SYSCTL_SREEPROM_REG &= ~(1<<0);
+    while(!(SYSCTL_PREEPROM_REG & (1<<0)));
+    prvWaitDone();
+
+    return (EEPROM_EESUPP_REG & EEPROM_EESUPP_RETRY_MASK) ? FALSE : TRUE;
+}
+
+uint32 EEPROM_ReadWord(uint16 usWord)
+{
+    prvWaitDone();
+    prvSelect(usWord);
+    return EEPROM_EERDWR_REG;
+}
+
+void EEPROM_StartWrite(uint16 usWord, uint32 ulValue)
+{
+    prvWaitDone();
+    prvSelect(usWord);
+    EEPROM_EERDWR_REG = ulValue;
+}
+
+boolean EEPROM_IsBusy(void)
+{
+    return (EEPROM_EEDONE_REG & EEPROM_EEDONE_WORKING_MASK) ? TRUE : FALSE;
+}
+
+boolean EEPROM_WriteFailed(void)
+{
+    return (EEPROM_EEDONE_REG & EEPROM_EEDONE_ERROR_MASK) ? TRUE : FALSE;
+}
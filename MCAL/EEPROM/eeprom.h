@@ -0,0 +1,52 @@
+ /******************************************************************************
+ *
+ * Module: EEPROM
+ *
+ * File Name: eeprom.h
+ *
+ * Description: Header file for the TM4C123GH6PM on-chip EEPROM driver
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef EEPROM_H_
+#define EEPROM_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* 2 KB: 32 blocks of 16 words */
+#define EEPROM_BLOCKS                   (32U)
+#define EEPROM_WORDS_PER_BLOCK          (16U)
+#define EEPROM_WORDS                    (EEPROM_BLOCKS * EEPROM_WORDS_PER_BLOCK)
+
+#define EEPROM_EEDONE_WORKING_MASK      0x00000001
+#define EEPROM_EEDONE_ERROR_MASK        0x00000034   /* WKERASE, NOPERM, WRBUSY */
+#define EEPROM_EESUPP_RETRY_MASK        0x0000000C   /* PRETRY, ERETRY */
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Power up and reset the EEPROM, FALSE if it reports a failed program or
+ * erase and cannot be used */
+extern boolean EEPROM_Init(void);
+
+/* Word 0 to EEPROM_WORDS - 1, waits while a write is in progress */
+extern uint32 EEPROM_ReadWord(uint16 usWord);
+
+/* Start programming one word and return, poll EEPROM_IsBusy() before the
+ * next access. Programming takes from about 100 us up to several ms when
+ * the EEPROM has to erase and copy a sector. */
+extern void EEPROM_StartWrite(uint16 usWord, uint32 ulValue);
+
+extern boolean EEPROM_IsBusy(void);
+
+/* TRUE if the last write finished with an error */
+extern boolean EEPROM_WriteFailed(void);
+
+#endif /* EEPROM_H_ */
@@ -12,19 +12,121 @@
 #include "GPTM.h"
 #include "tm4c123gh6pm_registers.h"
 
-void GPTM_WTimer0Init(void)
+static void (*pfWTimer2Timeout)(void) = NULL_PTR;
+
+void GPTM_WTimer0Init(uint32 ulSysClock)
 {
     /* Configure one shot down 32bit timer with tick time = 0.1msec */
     SYSCTL_RCGCWTIMER_REG |= (1<<0);  /* Enable clock WTimer0 in run mode */
     WTIMER0_CTL_REG = 0;              /* Disable WTimer0 output */
     WTIMER0_CFG_REG = 0x04;           /* Select 32-bit configuration option */
     WTIMER0_TAMR_REG = 0x01;          /* Select one-shot down counter mode of WTimer0A */
-    WTIMER0_TAPR_REG = 1600 -1;       /* Set the prescaler for WTimer0A */
+    GPTM_WTimer0SetClock(ulSysClock); /* Set the prescaler for WTimer0A */
     WTIMER0_CTL_REG |= (0x01);        /* Enable WTimer0A module */
 }
 
+void GPTM_WTimer0SetClock(uint32 ulSysClock)
+{
+    /* Keep the 0.1msec tick when the system clock changes, the count is not disturbed */
+    WTIMER0_TAPR_REG = (ulSysClock / WTIMER0_TICKS_PER_SECOND) - 1;
+}
+
 uint32 GPTM_WTimer0Read(void)
 {
     return (uint32) (0xFFFFFFFFUL - WTIMER0_TAR_REG);
 }
 
+void GPTM_WTimer1Init(void)
+{
+    /* Configure periodic down 32bit timer clocked by the system clock, used as wake up timer */
+    SYSCTL_RCGCWTIMER_REG |= (1<<1);  /* Enable clock WTimer1 in run mode */
+    while(!(SYSCTL_PRWTIMER_REG & (1<<1)));
+    WTIMER1_CTL_REG = 0;              /* Disable WTimer1 */
+    WTIMER1_CFG_REG = 0x04;           /* Select 32-bit configuration option */
+    WTIMER1_TAMR_REG = 0x02;          /* Select periodic down counter mode of WTimer1A */
+    WTIMER1_TAPR_REG = 0;             /* No prescaler, one count per system clock */
+    WTIMER1_ICR_REG = WTIMER1A_TATO_MASK;
+    WTIMER1_IMR_REG = WTIMER1A_TATO_MASK;  /* Interrupt on time-out to wake up the core */
+    /* WTimer1A is interrupt number 96: priority bits 5~7 of PRI24, enable bit 0 of EN3 */
+    NVIC_PRI24_REG = (NVIC_PRI24_REG & WTIMER1A_PRIORITY_MASK) | (WTIMER1A_INTERRUPT_PRIORITY<<WTIMER1A_PRIORITY_BITS_POS);
+    NVIC_EN3_REG |= (1<<0);
+}
+
+void GPTM_WTimer1Start(uint32 ulCounts)
+{
+    WTIMER1_CTL_REG = 0;
+    WTIMER1_ICR_REG = WTIMER1A_TATO_MASK;
+    WTIMER1_TAILR_REG = ulCounts;     /* Time-out after ulCounts then reload and keep counting */
+    WTIMER1_TAV_REG = ulCounts;
+    WTIMER1_CTL_REG |= (0x01);        /* Enable WTimer1A */
+}
+
+void GPTM_WTimer1Stop(void)
+{
+    WTIMER1_CTL_REG = 0;
+    WTIMER1_ICR_REG = WTIMER1A_TATO_MASK;
+}
+
+uint32 GPTM_WTimer1Read(void)
+{
+    return WTIMER1_TAR_REG;
+}
+
+uint8 GPTM_WTimer1TimedOut(void)
+{
+    return (WTIMER1_RIS_REG & WTIMER1A_TATO_MASK) ? TRUE : FALSE;
+}
+
+void WTimer1A_Handler(void)
+{
+    /* Only used to wake up the core, the sleeping code reads the timer itself */
+    WTIMER1_ICR_REG = WTIMER1A_TATO_MASK;
+}
+
+void GPTM_WTimer2Init(uint32 ulSysClock, void (*pfTimeout)(void))
+{
+    /* Configure periodic down 32bit timer with tick time = 0.1msec, stopped until started */
+    pfWTimer2Timeout = pfTimeout;
+    SYSCTL_RCGCWTIMER_REG |= (1<<2);  /* Enable clock WTimer2 in run mode */
+    while(!(SYSCTL_PRWTIMER_REG & (1<<2)));
+    WTIMER2_CTL_REG = 0;              /* Disable WTimer2 */
+    WTIMER2_CFG_REG = 0x04;           /* Select 32-bit configuration option */
+    WTIMER2_TAMR_REG = 0x02;          /* Select periodic down counter mode of WTimer2A */
+    GPTM_WTimer2SetClock(ulSysClock); /* Set the prescaler for WTimer2A */
+    WTIMER2_ICR_REG = WTIMER2A_TATO_MASK;
+    WTIMER2_IMR_REG = WTIMER2A_TATO_MASK;
+    /* WTimer2A is interrupt number 98: priority bits 21~23 of PRI24, enable bit 2 of EN3 */
+    NVIC_PRI24_REG = (NVIC_PRI24_REG & WTIMER2A_PRIORITY_MASK) | (WTIMER2A_INTERRUPT_PRIORITY<<WTIMER2A_PRIORITY_BITS_POS);
+    NVIC_EN3_REG |= (1<<2);
+}
+
+void GPTM_WTimer2SetClock(uint32 ulSysClock)
+{
+    /* Keep the 0.1msec tick when the system clock changes */
+    WTIMER2_TAPR_REG = (ulSysClock / WTIMER0_TICKS_PER_SECOND) - 1;
+}
+
+void GPTM_WTimer2Start(uint32 ulTicks)
+{
+    WTIMER2_CTL_REG = 0;
+    WTIMER2_ICR_REG = WTIMER2A_TATO_MASK;
+    WTIMER2_TAILR_REG = ulTicks - 1;  /* Time-out every ulTicks */
+    WTIMER2_TAV_REG = ulTicks - 1;
+    WTIMER2_CTL_REG |= (0x01);        /* Enable WTimer2A */
+}
+
+void GPTM_WTimer2Stop(void)
+{
+    WTIMER2_CTL_REG = 0;
+    WTIMER2_ICR_REG = WTIMER2A_TATO_MASK;
+}
+
+void WTimer2A_Handler(void)
+{
+    WTIMER2_ICR_REG = WTIMER2A_TATO_MASK;
+    if (pfWTimer2Timeout != NULL_PTR)
+    {
+        pfWTimer2Timeout();
+    }
+}
+
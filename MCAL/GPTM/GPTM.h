@@ -15,8 +15,33 @@
 
 #include "std_types.h"
 
-void GPTM_WTimer0Init(void);
+#define WTIMER1A_INTERRUPT_PRIORITY   5
+#define WTIMER1A_PRIORITY_MASK        0xFFFFFF1F
+#define WTIMER1A_PRIORITY_BITS_POS    5
+#define WTIMER1A_TATO_MASK            0x00000001
+
+#define WTIMER2A_INTERRUPT_PRIORITY   5
+#define WTIMER2A_PRIORITY_MASK        0xFF1FFFFF
+#define WTIMER2A_PRIORITY_BITS_POS    21
+#define WTIMER2A_TATO_MASK            0x00000001
+
+#define WTIMER0_TICKS_PER_SECOND      10000UL   /* 0.1 msec resolution */
+
+void GPTM_WTimer0Init(uint32 ulSysClock);
+void GPTM_WTimer0SetClock(uint32 ulSysClock);
 uint32 GPTM_WTimer0Read(void);
 
+void GPTM_WTimer1Init(void);
+void GPTM_WTimer1Start(uint32 ulCounts);
+void GPTM_WTimer1Stop(void);
+uint32 GPTM_WTimer1Read(void);
+uint8 GPTM_WTimer1TimedOut(void);
+
+/* WTimer2 counts in WTIMER0_TICKS_PER_SECOND too, pfTimeout is called from its interrupt */
+void GPTM_WTimer2Init(uint32 ulSysClock, void (*pfTimeout)(void));
+void GPTM_WTimer2SetClock(uint32 ulSysClock);
+void GPTM_WTimer2Start(uint32 ulTicks);
+void GPTM_WTimer2Stop(void);
+
 
 #endif /* GPTM_H_ */
@@ -6,8 +6,8 @@
  */
 #include "pll.h"
 
-/* configure the system to get its clock from the PLL with Frequency 80Mhz */
-void PLL_Init(void)
+/* configure the system to get its clock from the PLL with Frequency 400Mhz / (ucSysDiv2 + 1) */
+void PLL_Init(uint8 ucSysDiv2)
 {
     /* 1) Configure the system to use RCC2 for advanced features
           such as 400 MHz PLL and non-integer System Clock Divisor */
@@ -30,11 +30,27 @@ void PLL_Init(void)
     SYSCTL_RCC2_REG |= SYSCTL_RCC2_DIV400_MASK;  /* use 400 MHz PLL */
 
     SYSCTL_RCC2_REG  = (SYSCTL_RCC2_REG & ~SYSCTL_RCC2_SYSDIV2_MASK)        /* clear system clock divider field */
-                       | (SYSDIV2_VALUE << SYSCTL_RCC2_SYSDIV2_BIT_POS);      /* configure for 10MHz clock */
+                       | ((uint32)ucSysDiv2 << SYSCTL_RCC2_SYSDIV2_BIT_POS);  /* configure the system clock divider */
 
-    /* 6) Wait for the PLL to lock by polling PLLLRIS bit */
-    while(!(SYSCTL_RIS_REG & SYSCTL_RIS_PLLLRIS_MASK));
+    /* 6) Wait for the PLL to lock by polling the LOCK bit, unlike PLLLRIS it
+          is cleared while the PLL is powered down so it is valid on a re-lock */
+    while(!(SYSCTL_PLLSTAT_REG & SYSCTL_PLLSTAT_LOCK_MASK));
 
     /* 7) Enable use of PLL by clearing BYPASS2 */
     SYSCTL_RCC2_REG &= ~SYSCTL_RCC2_BYPASS2_MASK;
 }
+
+/* configure the system to get its clock directly from the 16Mhz main oscillator */
+void PLL_SelectMainOscillator(void)
+{
+    SYSCTL_RCC2_REG |= SYSCTL_RCC2_USERCC2_MASK;
+
+    /* 1) Bypass the PLL, the system clock switches to the oscillator source */
+    SYSCTL_RCC2_REG |= SYSCTL_RCC2_BYPASS2_MASK;
+
+    /* 2) Do not divide the oscillator */
+    SYSCTL_RCC_REG &= ~SYSCTL_RCC_USESYSDIV_MASK;
+
+    /* 3) Power the PLL down */
+    SYSCTL_RCC2_REG |= SYSCTL_RCC2_PWRDN2_MASK;
+}
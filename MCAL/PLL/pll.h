@@ -18,9 +18,14 @@
 #define SYSCTL_RCC2_SYSDIV2_MASK        0x1FC00000  /* SYSDIV2 Bits MASK */
 #define SYSCTL_RIS_PLLLRIS_MASK         0x00000040  /* PLLLRIS Bit MASK */
 #define SYSCTL_RCC2_SYSDIV2_BIT_POS     22       /* SYSDIV2 Bits Position start from bit number 22 */
-#define SYSDIV2_VALUE                   39
+#define SYSCTL_RCC_USESYSDIV_MASK       0x00400000  /* USESYSDIV Bit MASK */
+#define SYSCTL_PLLSTAT_LOCK_MASK        0x00000001  /* PLL LOCK Bit MASK */
 
 /*******************************************************************************************************************/
-void PLL_Init(void);
+/* Run from the PLL divided by (ucSysDiv2 + 1), from 400 MHz */
+void PLL_Init(uint8 ucSysDiv2);
+
+/* Run directly from the 16 MHz main oscillator and power the PLL down */
+void PLL_SelectMainOscillator(void);
 
 #endif /* PLL_H_ */
@@ -12,6 +12,31 @@
 
 #include "uart0.h"
 #include "tm4c123gh6pm_registers.h"
+#include "spsc_ring.h"
+
+#if !SPSC_RING_IS_POWER_OF_TWO(UART0_RX_BUFFER_SIZE)
+#error "UART0_RX_BUFFER_SIZE must be a power of two"
+#endif
+#if !SPSC_RING_IS_POWER_OF_TWO(UART0_TX_BUFFER_SIZE)
+#error "UART0_TX_BUFFER_SIZE must be a power of two"
+#endif
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static uint32 ulTxCount = 0;    /* Bytes sent since reset, wraps around */
+
+/* RX buffer: the handler is the producer, the reader the consumer */
+static uint8 ucRxStorage[UART0_RX_BUFFER_SIZE];
+static SpscRing xRxRing = SPSC_RING_INITIALIZER(ucRxStorage);
+static volatile uint32 ulRxOverruns = 0;    /* Lost in the receiver itself */
+static void (*pfRxNotify)(void) = NULL_PTR;
+
+/* TX buffer: the writing task is the producer, the handler the consumer */
+static uint8 ucTxStorage[UART0_TX_BUFFER_SIZE];
+static SpscRing xTxRing = SPSC_RING_INITIALIZER(ucTxStorage);
+static void (*pfTxDrained)(void) = NULL_PTR;
 
 /*******************************************************************************
  *                         Private Functions Definitions                       *
@@ -31,11 +56,17 @@ static void GPIO_SetupUART0Pins(void)
     GPIO_PORTA_DEN_REG   |= 0x03;         /* Enable Digital I/O on PA0 & PA1 */
 }
 
+static void UART0_EnableInterrupt(void)
+{
+    NVIC_PRI1_REG = (NVIC_PRI1_REG & UART0_PRIORITY_MASK) | (UART0_INTERRUPT_PRIORITY<<UART0_PRIORITY_BITS_POS);
+    NVIC_EN0_REG |= UART0_INTERRUPT_BIT;
+}
+
 /*******************************************************************************
  *                         Public Functions Definitions                        *
  *******************************************************************************/
 
-void UART0_Init(void) /* UART0 configuration: 1 start, 8 bits data, No Parity, 1 stop bit and 9600BPS */
+void UART0_Init(uint32 ulSysClock) /* UART0 configuration: 1 start, 8 bits data, No Parity, 1 stop bit and 9600BPS */
 {
     /* Setup UART0 pins PA0 --> U0RX & PA1 --> U0TX */
     GPIO_SetupUART0Pins();
@@ -47,9 +78,8 @@ void UART0_Init(void) /* UART0 configuration: 1 start, 8 bits data, No Parity, 1
 
     UART0_CC_REG  = 0;                    /* Use System Clock*/
     
-    /* To Configure UART0 with Baud Rate 9600 */
-    UART0_IBRD_REG = 104;
-    UART0_FBRD_REG = 11;
+    /* To Configure UART0 with Baud Rate 9600 from the current system clock */
+    UART0_SetBaudRate(ulSysClock, UART0_BAUD_RATE);
     
     /* UART Line Control Register Settings
      * BRK = 0 Normal Use
@@ -73,8 +103,36 @@ void UART0_Init(void) /* UART0 configuration: 1 start, 8 bits data, No Parity, 1
        
 void UART0_SendByte(uint8 data)
 {
+    while(SpscRing_Count(&xTxRing) != 0); /* Let the interrupt send the buffered bytes first */
     while(!(UART0_FR_REG & UART_FR_TXFE_MASK)); /* Wait until the transmit FIFO is empty */
     UART0_DR_REG = data; /* Send the byte */
+    ulTxCount++;
+}
+
+void UART0_SetBaudRate(uint32 ulSysClock, uint32 ulBaudRate)
+{
+    /* BRD = SysClk / (16 * BaudRate), kept in 1/64 units rounded to nearest:
+     * the integer part goes to IBRD and the 6 fraction bits to FBRD */
+    uint32 ulDivisor = ((ulSysClock * 4U) + (ulBaudRate / 2U)) / ulBaudRate;
+    uint32 ulControl = UART0_CTL_REG;
+
+    while(UART0_FR_REG & UART_FR_BUSY_MASK); /* Let the current byte leave at the old rate */
+    UART0_CTL_REG = 0;
+    UART0_IBRD_REG = ulDivisor >> 6;
+    UART0_FBRD_REG = ulDivisor & 0x3F;
+    UART0_LCRH_REG = UART0_LCRH_REG;         /* The divisors are only latched by a write to LCRH */
+    UART0_CTL_REG = ulControl;
+}
+
+uint32 UART0_GetTxCount(void)
+{
+    return ulTxCount;
+}
+
+uint8 UART0_IsBusy(void)
+{
+    /* Bytes still buffered for the interrupt or the last one shifting out */
+    return ((SpscRing_Count(&xTxRing) != 0) || (UART0_FR_REG & UART_FR_BUSY_MASK)) ? TRUE : FALSE;
 }
 
 uint8 UART0_ReceiveByte(void)
@@ -94,26 +152,28 @@ void UART0_SendString(const uint8 *pData)
     }
 }
 
-void UART0_SendInteger(sint64 sNumber)
+void UART0_SendInteger(sint32 sNumber)
 {
 
-    uint8 uDigits[20];
+    uint8 uDigits[10];
     sint8 uCounter = 0;
+    /* 32-bit magnitude, the M4 divides it in hardware (no 64-bit library calls) */
+    uint32 uMagnitude = (uint32)sNumber;
 
     /* Send the negative sign in case of negative numbers */
     if (sNumber < 0)
     {
         UART0_SendByte('-');
-        sNumber *= -1;
+        uMagnitude = 0UL - uMagnitude;
     }
 
     /* Convert the number to an array of characters */
     do
     {
-        uDigits[uCounter++] = sNumber % 10 + '0'; /* Convert each digit to its corresponding ASCI character */
-        sNumber /= 10; /* Remove the already converted digit */
+        uDigits[uCounter++] = uMagnitude % 10 + '0'; /* Convert each digit to its corresponding ASCI character */
+        uMagnitude /= 10; /* Remove the already converted digit */
     }
-    while (sNumber != 0);
+    while (uMagnitude != 0);
 
     /* Send the array of characters in a reverse order as the digits were converted from right to left */
     for( uCounter--; uCounter>= 0; uCounter--)
@@ -121,3 +181,84 @@ void UART0_SendInteger(sint64 sNumber)
         UART0_SendByte(uDigits[uCounter]);
     }
 }
+
+void UART0_RxInterruptInit(void (*pfRxCallback)(void))
+{
+    pfRxNotify = pfRxCallback;
+
+    UART0_ICR_REG = UART_ICR_ALL_MASK;
+    UART0_IM_REG |= UART_IM_RXIM_MASK | UART_IM_OEIM_MASK;
+
+    UART0_EnableInterrupt();
+}
+
+boolean UART0_ReadRxByte(uint8 *pucByte)
+{
+    return SpscRing_PopU8(&xRxRing, pucByte);
+}
+
+uint32 UART0_GetRxOverruns(void)
+{
+    return ulRxOverruns + SpscRing_GetOverflows(&xRxRing);
+}
+
+void UART0_TxInterruptInit(void (*pfTxCallback)(void))
+{
+    pfTxDrained = pfTxCallback;
+
+    UART0_IM_REG |= UART_IM_TXIM_MASK;
+    UART0_EnableInterrupt();
+}
+
+uint32 UART0_WriteTxBytes(const uint8 *pucData, uint32 ulLength)
+{
+    uint32 ulFree = SpscRing_Free(&xTxRing);
+
+    if (ulLength > ulFree)
+    {
+        ulLength = ulFree;
+    }
+    (void) SpscRing_PushBatchU8(&xTxRing, pucData, ulLength);
+    ulTxCount += ulLength;
+
+    /* The TX interrupt only fires when a byte leaves the holding register, so
+     * an idle line is started by pending the handler: it stays the only consumer */
+    NVIC_PEND0_REG = UART0_INTERRUPT_BIT;
+    return ulLength;
+}
+
+uint32 UART0_GetTxPending(void)
+{
+    return SpscRing_Count(&xTxRing);
+}
+
+void UART0_Handler(void)
+{
+    uint32 ulStatus = UART0_MIS_REG;
+    uint8 ucByte;
+
+    if (ulStatus & UART_IM_OEIM_MASK)
+    {
+        ulRxOverruns++; /* A byte was lost in the receiver itself */
+    }
+    UART0_ICR_REG = UART_ICR_ALL_MASK;
+
+    while(!(UART0_FR_REG & UART_FR_RXFE_MASK))
+    {
+        (void) SpscRing_PushU8(&xRxRing, (uint8)UART0_DR_REG);
+    }
+    if ((ulStatus & (UART_IM_RXIM_MASK | UART_IM_OEIM_MASK)) && (pfRxNotify != NULL_PTR))
+    {
+        pfRxNotify();
+    }
+
+    /* Also on a pended entry, the holding register may be empty on an idle line */
+    while(!(UART0_FR_REG & UART_FR_TXFF_MASK) && SpscRing_PopU8(&xTxRing, &ucByte))
+    {
+        UART0_DR_REG = ucByte;
+    }
+    if ((ulStatus & UART_IM_TXIM_MASK) && (SpscRing_Count(&xTxRing) == 0) && (pfTxDrained != NULL_PTR))
+    {
+        pfTxDrained();
+    }
+}
@@ -27,20 +27,68 @@
 #define UART_CTL_TXE_MASK        0x00000100
 #define UART_CTL_RXE_MASK        0x00000200
 #define UART_FR_TXFE_MASK        0x00000080
+#define UART_FR_TXFF_MASK        0x00000020
 #define UART_FR_RXFE_MASK        0x00000010
+#define UART_FR_BUSY_MASK        0x00000008
+#define UART0_BAUD_RATE          9600
+#define UART_IM_RXIM_MASK        0x00000010
+#define UART_IM_TXIM_MASK        0x00000020
+#define UART_IM_OEIM_MASK        0x00000400
+#define UART_ICR_ALL_MASK        0x000007F2
+
+/* UART0 is interrupt number 5: priority bits 13~15 of PRI1, enable bit 5 of EN0.
+ * Lower urgency than the seat buttons, the handler only queues bytes. */
+#define UART0_INTERRUPT_PRIORITY 6
+#define UART0_PRIORITY_MASK      0xFFFF1FFF
+#define UART0_PRIORITY_BITS_POS  13
+#define UART0_INTERRUPT_BIT      (1U<<5)
+
+/* Received bytes buffered between the interrupt and the reader, power of two */
+#define UART0_RX_BUFFER_SIZE     64U
+
+/* Bytes buffered between the writer and the interrupt, power of two. It holds
+ * the longest gatekeeper message, so a message is one write. */
+#define UART0_TX_BUFFER_SIZE     128U
 
 /*******************************************************************************
  *                            Functions Prototypes                             *
  *******************************************************************************/
 
-extern void UART0_Init(void);
+extern void UART0_Init(uint32 ulSysClock);
+
+extern void UART0_SetBaudRate(uint32 ulSysClock, uint32 ulBaudRate);
 
 extern void UART0_SendByte(uint8 data);
 
 extern uint8 UART0_ReceiveByte(void);
 
+/* Receive by interrupt into the RX buffer, pfRxCallback is called from the
+ * handler after new bytes were buffered (NULL_PTR for none) */
+extern void UART0_RxInterruptInit(void (*pfRxCallback)(void));
+
+/* Take one byte out of the RX buffer, FALSE when it is empty */
+extern boolean UART0_ReadRxByte(uint8 *pucByte);
+
+/* Bytes lost because the RX buffer was full */
+extern uint32 UART0_GetRxOverruns(void);
+
+/* Send by interrupt from the TX buffer, pfTxDrained is called from the
+ * handler when the buffer has emptied (NULL_PTR for none). Only one task may
+ * write to the buffer. */
+extern void UART0_TxInterruptInit(void (*pfTxDrained)(void));
+
+/* Buffer up to ulLength bytes for the interrupt, returns how many fit */
+extern uint32 UART0_WriteTxBytes(const uint8 *pucData, uint32 ulLength);
+
+/* Bytes in the TX buffer that the interrupt has not sent yet */
+extern uint32 UART0_GetTxPending(void);
+
 extern void UART0_SendString(const uint8 *pData);
 
-extern void UART0_SendInteger(sint64 sNumber);
+extern void UART0_SendInteger(sint32 sNumber);
+
+extern uint8 UART0_IsBusy(void);
+
+extern uint32 UART0_GetTxCount(void);
 
 #endif
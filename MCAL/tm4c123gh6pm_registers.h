@@ -191,6 +191,7 @@ NVIC Registers
 #define NVIC_DIS2_REG             (*((volatile uint32 *)0xE000E188))
 #define NVIC_DIS3_REG             (*((volatile uint32 *)0xE000E18C))
 #define NVIC_DIS4_REG             (*((volatile uint32 *)0xE000E190))
+#define NVIC_PEND0_REG            (*((volatile uint32 *)0xE000E200))
 
 /*****************************************************************************
 System Control Block Registers
@@ -200,6 +201,7 @@ System Control Block Registers
 #define NVIC_SYSTEM_PRI3_REG      (*((volatile uint32 *)0xE000ED20))
 #define NVIC_SYSTEM_SYSHNDCTRL    (*((volatile uint32 *)0xE000ED24))
 #define NVIC_SYSTEM_INTCTRL       (*((volatile uint32 *)0xE000ED04))
+#define NVIC_SYSTEM_SYSCTRL       (*((volatile uint32 *)0xE000ED10))
 #define NVIC_SYSTEM_CFGCTRL       (*((volatile uint32 *)0xE000ED14))
 
 /*****************************************************************************
@@ -452,4 +454,49 @@ Timer Registers (WTIMER0)
 #define WTIMER0_TAR_REG           (*((volatile uint32 *)0x40036048))
 #define WTIMER0_TBR_REG           (*((volatile uint32 *)0x4003604C))
 
+/*****************************************************************************
+Timer Registers (WTIMER1)
+*****************************************************************************/
+#define WTIMER1_CFG_REG           (*((volatile uint32 *)0x40037000))
+#define WTIMER1_TAMR_REG          (*((volatile uint32 *)0x40037004))
+#define WTIMER1_CTL_REG           (*((volatile uint32 *)0x4003700C))
+#define WTIMER1_IMR_REG           (*((volatile uint32 *)0x40037018))
+#define WTIMER1_RIS_REG           (*((volatile uint32 *)0x4003701C))
+#define WTIMER1_ICR_REG           (*((volatile uint32 *)0x40037024))
+#define WTIMER1_TAILR_REG         (*((volatile uint32 *)0x40037028))
+#define WTIMER1_TAPR_REG          (*((volatile uint32 *)0x40037038))
+#define WTIMER1_TAR_REG           (*((volatile uint32 *)0x40037048))
+#define WTIMER1_TAV_REG           (*((volatile uint32 *)0x40037050))
+
+/*****************************************************************************
+Timer Registers (WTIMER2)
+*****************************************************************************/
+#define WTIMER2_CFG_REG           (*((volatile uint32 *)0x4004C000))
+#define WTIMER2_TAMR_REG          (*((volatile uint32 *)0x4004C004))
+#define WTIMER2_CTL_REG           (*((volatile uint32 *)0x4004C00C))
+#define WTIMER2_IMR_REG           (*((volatile uint32 *)0x4004C018))
+#define WTIMER2_ICR_REG           (*((volatile uint32 *)0x4004C024))
+#define WTIMER2_TAILR_REG         (*((volatile uint32 *)0x4004C028))
+#define WTIMER2_TAPR_REG          (*((volatile uint32 *)0x4004C038))
+#define WTIMER2_TAV_REG           (*((volatile uint32 *)0x4004C050))
+
+/*****************************************************************************
+EEPROM Registers
+*****************************************************************************/
+#define EEPROM_EESIZE_REG         (*((volatile uint32 *)0x400AF000))
+#define EEPROM_EEBLOCK_REG        (*((volatile uint32 *)0x400AF004))
+#define EEPROM_EEOFFSET_REG       (*((volatile uint32 *)0x400AF008))
+#define EEPROM_EERDWR_REG         (*((volatile uint32 *)0x400AF010))
+#define EEPROM_EEDONE_REG         (*((volatile uint32 *)0x400AF018))
+#define EEPROM_EESUPP_REG         (*((volatile uint32 *)0x400AF01C))
+
+/*****************************************************************************
+Debug Registers (DWT cycle counter)
+*****************************************************************************/
+#define CORE_DEMCR_REG            (*((volatile uint32 *)0xE000EDFC))
+#define DWT_CTRL_REG              (*((volatile uint32 *)0xE0001000))
+#define DWT_CYCCNT_REG            (*((volatile uint32 *)0xE0001004))
+#define CORE_DEMCR_TRCENA_MASK    0x01000000
+#define DWT_CTRL_CYCCNTENA_MASK   0x00000001
+
 #endif
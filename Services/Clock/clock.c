@@ -0,0 +1,146 @@
+ /******************************************************************************
+ *
+ * Module: Clock
+ *
+ * File Name: clock.c
+ *
+ * Description: Source file for the system clock manager. It is the only owner
+ *              of the system frequency: drivers are given the frequency at init
+ *              and are retimed here on every switch between the PLL and the
+ *              main oscillator, so the tick, the baud rate, the WTimer0
+ *              timestamps and Delay_MS stay correct in both modes.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#include "clock.h"
+#include "task.h"
+#include "pll.h"
+#include "uart0.h"
+#include "GPTM.h"
+#include "tm4c123gh6pm_registers.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define SYSTICK_ENABLE_MASK             (0x00000001)
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static ClockMode xMode;
+static uint32 ulFrequency = CLOCK_BOOT_HZ;
+static uint32 ulDelayIterationsPerMs;
+static uint32 ulSwitches = 0;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void prvApplyMode(ClockMode eMode)
+{
+    if (eMode == CLOCK_MODE_HIGH_PERFORMANCE)
+    {
+        PLL_Init(CLOCK_PLL_SYSDIV2);
+        ulFrequency = CLOCK_PLL_HZ;
+    }
+    else
+    {
+        PLL_SelectMainOscillator();
+        ulFrequency = CLOCK_MOSC_HZ;
+    }
+    xMode = eMode;
+    ulDelayIterationsPerMs = (CLOCK_DELAY_ITERATIONS_PER_MS_AT_10MHZ * (ulFrequency / 1000000UL)) / 10UL;
+}
+
+/* Reload SysTick for the new frequency. The part of the tick in progress that
+ * is left is converted too, so the kernel time does not jump. */
+static void prvRetimeSysTick(uint32 ulOldFrequency)
+{
+    uint32 ulCountsPerTick = ulFrequency / configTICK_RATE_HZ;
+    uint32 ulRemaining;
+
+    SYSTICK_CTRL_REG &= ~SYSTICK_ENABLE_MASK;
+    ulRemaining = (uint32)(((unsigned long long)SYSTICK_CURRENT_REG * ulFrequency) / ulOldFrequency);
+    if (ulRemaining == 0)
+    {
+        ulRemaining = 1;
+    }
+    SYSTICK_RELOAD_REG = ulRemaining - 1UL;
+    SYSTICK_CURRENT_REG = 0;
+    SYSTICK_CTRL_REG |= SYSTICK_ENABLE_MASK;
+    SYSTICK_RELOAD_REG = ulCountsPerTick - 1UL;
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void Clock_Init(void)
+{
+    prvApplyMode((CLOCK_BOOT_HZ == CLOCK_PLL_HZ) ? CLOCK_MODE_HIGH_PERFORMANCE : CLOCK_MODE_LOW_POWER);
+}
+
+void Clock_SetMode(ClockMode eMode)
+{
+    uint32 ulOldFrequency;
+
+    if (eMode == xMode)
+    {
+        return;
+    }
+
+    while (UART0_IsBusy());
+
+    taskENTER_CRITICAL();
+    ulOldFrequency = ulFrequency;
+    prvApplyMode(eMode);
+    prvRetimeSysTick(ulOldFrequency);
+    UART0_SetBaudRate(ulFrequency, UART0_BAUD_RATE);
+    GPTM_WTimer0SetClock(ulFrequency);
+    GPTM_WTimer2SetClock(ulFrequency);
+    ulSwitches++;
+    taskEXIT_CRITICAL();
+}
+
+void Clock_UpdateLoad(uint8 ucLoadPercent)
+{
+    uint32 ulLowPowerLoad;
+
+    if (xMode == CLOCK_MODE_HIGH_PERFORMANCE)
+    {
+        /* Load the same work would cause at the main oscillator frequency */
+        ulLowPowerLoad = ((uint32)ucLoadPercent * (CLOCK_PLL_HZ / 1000000UL)) / (CLOCK_MOSC_HZ / 1000000UL);
+        if (ulLowPowerLoad < CLOCK_LOW_POWER_ENTER_LOAD)
+        {
+            Clock_SetMode(CLOCK_MODE_LOW_POWER);
+        }
+    }
+    else if (ucLoadPercent > CLOCK_LOW_POWER_EXIT_LOAD)
+    {
+        Clock_SetMode(CLOCK_MODE_HIGH_PERFORMANCE);
+    }
+}
+
+ClockMode Clock_GetMode(void)
+{
+    return xMode;
+}
+
+uint32 Clock_GetFrequency(void)
+{
+    return ulFrequency;
+}
+
+uint32 Clock_GetDelayIterationsPerMs(void)
+{
+    return ulDelayIterationsPerMs;
+}
+
+uint32 Clock_GetSwitches(void)
+{
+    return ulSwitches;
+}
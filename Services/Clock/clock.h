@@ -0,0 +1,62 @@
+ /******************************************************************************
+ *
+ * Module: Clock
+ *
+ * File Name: clock.h
+ *
+ * Description: Header file for the system clock manager
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef CLOCK_H_
+#define CLOCK_H_
+
+#include "FreeRTOS.h"
+#include "std_types.h"
+#include "clock_cfg.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Load governor thresholds in percent of CPU time. The load measured in high
+ * performance mode is scaled to what it would be in low power mode, so the
+ * gap between the two thresholds is the hysteresis. */
+#define CLOCK_LOW_POWER_ENTER_LOAD      (50U)
+#define CLOCK_LOW_POWER_EXIT_LOAD       (75U)
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef enum
+{
+    CLOCK_MODE_LOW_POWER,           /* 16 MHz main oscillator, PLL powered down */
+    CLOCK_MODE_HIGH_PERFORMANCE     /* 80 MHz from the PLL */
+}ClockMode;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Call first, before any peripheral is initialized: runs at CLOCK_BOOT_HZ */
+extern void Clock_Init(void);
+
+/* Switch the system clock and retime SysTick, UART0, WTimer0, WTimer2 and Delay_MS.
+ * Call from the UART gatekeeper (UartGatekeeper_Call) so no byte is cut in half. */
+extern void Clock_SetMode(ClockMode eMode);
+
+/* Load governor, call with the CPU load of the last measurement window */
+extern void Clock_UpdateLoad(uint8 ucLoadPercent);
+
+extern ClockMode Clock_GetMode(void);
+
+extern uint32 Clock_GetFrequency(void);
+
+extern uint32 Clock_GetDelayIterationsPerMs(void);
+
+extern uint32 Clock_GetSwitches(void);
+
+#endif /* CLOCK_H_ */
@@ -0,0 +1,256 @@
+ /******************************************************************************
+ *
+ * Module: Console
+ *
+ * File Name: console.c
+ *
+ * Description: Source file for the UART0 command console. The receive
+ *              interrupt only buffers the bytes and wakes the console task,
+ *              which runs at the lowest priority so the control tasks never
+ *              wait for the line editing or the commands.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#include "console.h"
+#include "task.h"
+#include "uart0.h"
+#include "format.h"
+#include "uart_gatekeeper.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#if (CONSOLE_REPLY_SIZE > UART_GATEKEEPER_MESSAGE_SIZE)
+#error "A console reply line must fit in one UART gatekeeper message"
+#endif
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static const ConsoleCommand *pxCommandTable = NULL_PTR;
+static uint8 ucCommandsCount = 0;
+static TaskHandle_t xConsoleTask = NULL_PTR;
+
+static char cLine[CONSOLE_LINE_SIZE];
+static uint8 ucLineLength = 0;
+static boolean bLineOverflow = FALSE;
+
+static char cReply[CONSOLE_REPLY_SIZE];
+static uint8 ucReplyLength = 0;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+/* Called by the UART0 handler */
+static void prvRxCallback(void)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    if (xConsoleTask != NULL_PTR)
+    {
+        vTaskNotifyGiveFromISR(xConsoleTask, &xHigherPriorityTaskWoken);
+    }
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+static boolean prvEquals(const char *pcA, const char *pcB)
+{
+    while ((*pcA != '\0') && (*pcA == *pcB))
+    {
+        pcA++;
+        pcB++;
+    }
+    return (*pcA == *pcB) ? TRUE : FALSE;
+}
+
+static void prvHelp(void)
+{
+    uint8 ucIndex;
+
+    for (ucIndex = 0; ucIndex < ucCommandsCount; ucIndex++)
+    {
+        Console_Append(pxCommandTable[ucIndex].pcName);
+        Console_Append(" ");
+        Console_Append(pxCommandTable[ucIndex].pcUsage);
+        Console_Flush();
+    }
+}
+
+/* Split the line in place and run its command */
+static void prvExecute(void)
+{
+    char *pcArgv[CONSOLE_MAX_ARGS];
+    uint8 ucArgc = 0;
+    uint8 ucIndex = 0;
+
+    while ((ucIndex < ucLineLength) && (ucArgc < CONSOLE_MAX_ARGS))
+    {
+        while ((ucIndex < ucLineLength) && (cLine[ucIndex] == ' '))
+        {
+            cLine[ucIndex++] = '\0';
+        }
+        if (ucIndex == ucLineLength)
+        {
+            break;
+        }
+        pcArgv[ucArgc++] = &cLine[ucIndex];
+        while ((ucIndex < ucLineLength) && (cLine[ucIndex] != ' '))
+        {
+            ucIndex++;
+        }
+    }
+    cLine[ucIndex] = '\0';
+
+    if (ucArgc == 0)
+    {
+        return;
+    }
+    if (prvEquals(pcArgv[0], "help"))
+    {
+        prvHelp();
+        return;
+    }
+    for (ucIndex = 0; ucIndex < ucCommandsCount; ucIndex++)
+    {
+        if (prvEquals(pcArgv[0], pxCommandTable[ucIndex].pcName))
+        {
+            pxCommandTable[ucIndex].pfHandler(ucArgc, pcArgv);
+            return;
+        }
+    }
+    Console_Append("unknown command, try help");
+    Console_Flush();
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void Console_Init(const ConsoleCommand *pxCommands, uint8 ucCount)
+{
+    pxCommandTable = pxCommands;
+    ucCommandsCount = ucCount;
+    UART0_RxInterruptInit(prvRxCallback);
+}
+
+void Console_ProcessInput(void)
+{
+    uint8 ucByte;
+
+    xConsoleTask = xTaskGetCurrentTaskHandle();
+
+    while (UART0_ReadRxByte(&ucByte) == TRUE)
+    {
+        if ((ucByte == '\r') || (ucByte == '\n'))
+        {
+            if (bLineOverflow == TRUE)
+            {
+                Console_Append("line too long");
+                Console_Flush();
+            }
+            else
+            {
+                prvExecute();
+            }
+            ucLineLength = 0;
+            bLineOverflow = FALSE;
+        }
+        else if ((ucByte == '\b') || (ucByte == 0x7F))
+        {
+            if (ucLineLength > 0)
+            {
+                ucLineLength--;
+            }
+        }
+        else if (ucLineLength < (CONSOLE_LINE_SIZE - 1U))
+        {
+            cLine[ucLineLength++] = (char)ucByte;
+        }
+        else
+        {
+            bLineOverflow = TRUE;
+        }
+    }
+
+    /* Bytes received from now on notify the task */
+    (void) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+}
+
+void Console_Append(const char *pcText)
+{
+    while ((*pcText != '\0') && (ucReplyLength < (CONSOLE_REPLY_SIZE - 3U)))
+    {
+        cReply[ucReplyLength++] = *pcText++;
+    }
+}
+
+void Console_AppendUnsigned(uint32 ulValue)
+{
+    uint8 ucNumber[FORMAT_BUFFER_SIZE];
+
+    (void) Format_Unsigned(ulValue, ucNumber);
+    Console_Append((const char *)ucNumber);
+}
+
+void Console_AppendFixed(sint32 slValue, uint8 ucDecimals)
+{
+    uint8 ucNumber[FORMAT_BUFFER_SIZE];
+
+    (void) Format_Fixed(slValue, ucDecimals, ucNumber);
+    Console_Append((const char *)ucNumber);
+}
+
+void Console_Flush(void)
+{
+    UartMessage *pxMessage = UartGatekeeper_Alloc(TRUE);
+
+    cReply[ucReplyLength++] = '\r';
+    cReply[ucReplyLength++] = '\n';
+    cReply[ucReplyLength] = '\0';
+
+    UartGatekeeper_Append(pxMessage, cReply);
+    UartGatekeeper_Send(pxMessage);
+    ucReplyLength = 0;
+}
+
+boolean Console_ParseUnsigned(const char *pcText, uint32 *pulValue)
+{
+    uint32 ulValue = 0;
+
+    if (*pcText == '\0')
+    {
+        return FALSE;
+    }
+    while (*pcText != '\0')
+    {
+        if ((*pcText < '0') || (*pcText > '9') ||
+            (ulValue > ((0xFFFFFFFFUL - (uint32)(*pcText - '0')) / 10U)))
+        {
+            return FALSE;
+        }
+        ulValue = (ulValue * 10U) + (uint32)(*pcText++ - '0');
+    }
+    *pulValue = ulValue;
+
+    return TRUE;
+}
+
+uint8 Console_ParseChoice(const char *pcText, const char *const *ppcChoices, uint8 ucCount)
+{
+    uint8 ucIndex;
+
+    for (ucIndex = 0; ucIndex < ucCount; ucIndex++)
+    {
+        if (prvEquals(pcText, ppcChoices[ucIndex]))
+        {
+            break;
+        }
+    }
+
+    return ucIndex;
+}
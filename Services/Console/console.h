@@ -0,0 +1,69 @@
+ /******************************************************************************
+ *
+ * Module: Console
+ *
+ * File Name: console.h
+ *
+ * Description: Header file for the UART0 command console
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef CONSOLE_H_
+#define CONSOLE_H_
+
+#include "FreeRTOS.h"
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Longest command line, longer lines are discarded */
+#define CONSOLE_LINE_SIZE           (48U)
+
+/* Command name included */
+#define CONSOLE_MAX_ARGS            (6U)
+
+/* Longest reply line, it is handed to the UART gatekeeper as one message */
+#define CONSOLE_REPLY_SIZE          (56U)
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef void (*ConsoleHandler)(uint8 ucArgc, char *pcArgv[]);
+
+typedef struct
+{
+    const char *pcName;
+    const char *pcUsage;
+    ConsoleHandler pfHandler;
+}ConsoleCommand;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Call before the scheduler starts: enables the UART0 receive interrupt.
+ * Replies are sent through the UART gatekeeper. */
+extern void Console_Init(const ConsoleCommand *pxCommands, uint8 ucCount);
+
+/* Body of the console task: parses and runs every complete line received,
+ * then blocks until more input arrives */
+extern void Console_ProcessInput(void);
+
+/* Reply line: append pieces then send the line with Console_Flush() */
+extern void Console_Append(const char *pcText);
+extern void Console_AppendUnsigned(uint32 ulValue);
+extern void Console_AppendFixed(sint32 slValue, uint8 ucDecimals);
+extern void Console_Flush(void);
+
+/* Parse a decimal argument, FALSE if it is not a number */
+extern boolean Console_ParseUnsigned(const char *pcText, uint32 *pulValue);
+
+/* Index of pcText in a list of names, ucCount if it is not in the list */
+extern uint8 Console_ParseChoice(const char *pcText, const char *const *ppcChoices, uint8 ucCount);
+
+#endif /* CONSOLE_H_ */
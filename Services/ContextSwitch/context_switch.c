@@ -0,0 +1,132 @@
+ /******************************************************************************
+ *
+ * Module: ContextSwitch
+ *
+ * File Name: context_switch.c
+ *
+ * Description: Source file for the context switch cost measurement. Two
+ *              tasks ping-pong a notification and the round trips are timed
+ *              with the DWT cycle counter. Once a task executed a floating
+ *              point instruction, the ARM_CM4F port saves its s16-s31 and
+ *              the core stacks s0-s15 and the FPSCR at every switch, so the
+ *              FPU variant shows that cost in cycles and stack words.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#include "context_switch.h"
+#include "tm4c123gh6pm_registers.h"
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static TaskHandle_t xCaller = NULL;
+static TaskHandle_t xPing = NULL;
+static TaskHandle_t xPong = NULL;
+
+static volatile boolean bDone;
+static volatile uint32 ulCycles;
+
+/* Work between two switches, keeps the result live */
+static volatile uint32 ulIntegerWork;
+static volatile float32 fFloatWork;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+/* Kept apart so the integer tasks never execute an FPU instruction */
+static void prvIntegerWork(void)
+{
+    ulIntegerWork = (ulIntegerWork * 3U) + 1U;
+}
+
+static void prvFloatWork(void)
+{
+    fFloatWork = (fFloatWork * 0.5f) + 1.0f;
+}
+
+static void prvPingTask(void *pvParameters)
+{
+    void (*pfWork)(void) = ((uint32) pvParameters != 0) ? prvFloatWork : prvIntegerWork;
+    uint32 ulStart;
+    uint32 ulRound;
+
+    pfWork();
+    ulStart = DWT_CYCCNT_REG;
+    for (ulRound = 0; ulRound < CONTEXT_SWITCH_ROUND_TRIPS; ulRound++)
+    {
+        xTaskNotifyGive(xPong);
+        (void) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        pfWork();
+    }
+    ulCycles = DWT_CYCCNT_REG - ulStart;
+
+    bDone = TRUE;
+    xTaskNotifyGive(xCaller);
+    for (;;)
+    {
+        /* Deleted by the caller */
+        (void) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
+
+static void prvPongTask(void *pvParameters)
+{
+    void (*pfWork)(void) = ((uint32) pvParameters != 0) ? prvFloatWork : prvIntegerWork;
+
+    pfWork();
+    for (;;)
+    {
+        (void) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        pfWork();
+        xTaskNotifyGive(xPing);
+    }
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+boolean ContextSwitch_Measure(boolean bUseFpu, ContextSwitchCost *pxCost)
+{
+    UBaseType_t uxPingFree, uxPongFree;
+
+    CORE_DEMCR_REG |= CORE_DEMCR_TRCENA_MASK;
+    DWT_CTRL_REG |= DWT_CTRL_CYCCNTENA_MASK;
+
+    xCaller = xTaskGetCurrentTaskHandle();
+    bDone = FALSE;
+
+    /* Pong preempts the caller and waits, ping then runs all the round trips */
+    if (xTaskCreate(prvPongTask, "Pong", CONTEXT_SWITCH_STACK_DEPTH, (void *) (uint32) bUseFpu,
+                    configMAX_PRIORITIES - 1, &xPong) != pdPASS)
+    {
+        return FALSE;
+    }
+    if (xTaskCreate(prvPingTask, "Ping", CONTEXT_SWITCH_STACK_DEPTH, (void *) (uint32) bUseFpu,
+                    configMAX_PRIORITIES - 1, &xPing) != pdPASS)
+    {
+        vTaskDelete(xPong);
+        return FALSE;
+    }
+
+    while (bDone == FALSE)
+    {
+        (void) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+
+    uxPingFree = uxTaskGetStackHighWaterMark(xPing);
+    uxPongFree = uxTaskGetStackHighWaterMark(xPong);
+    vTaskDelete(xPing);
+    vTaskDelete(xPong);
+
+    /* The wait may have taken a notification meant for the caller */
+    xTaskNotifyGive(xCaller);
+
+    pxCost->ulCyclesPerSwitch = ulCycles / (2U * CONTEXT_SWITCH_ROUND_TRIPS);
+    pxCost->usStackUsed = (uint16) (CONTEXT_SWITCH_STACK_DEPTH - ((uxPingFree < uxPongFree) ? uxPingFree : uxPongFree));
+    return TRUE;
+}
@@ -0,0 +1,52 @@
+ /******************************************************************************
+ *
+ * Module: ContextSwitch
+ *
+ * File Name: context_switch.h
+ *
+ * Description: Header file for the context switch cost measurement
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef CONTEXT_SWITCH_H_
+#define CONTEXT_SWITCH_H_
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Notifications passed back and forth, two context switches each */
+#define CONTEXT_SWITCH_ROUND_TRIPS          (500U)
+
+/* Stack of each of the two measurement tasks, in words */
+#define CONTEXT_SWITCH_STACK_DEPTH          (configMINIMAL_STACK_SIZE)
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint32 ulCyclesPerSwitch;       /* Including the notification calls */
+    uint16 usStackUsed;             /* Most words used by one of the tasks */
+}ContextSwitchCost;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Create two tasks at the highest priority that pass a notification back and
+ * forth, with an integer or a floating point operation (bUseFpu) between the
+ * switches, and delete them again. With bUseFpu both switch with an FPU
+ * context. Call from a low priority task: the other tasks wait for about
+ * CONTEXT_SWITCH_ROUND_TRIPS * 10 us. Returns FALSE when the tasks could not
+ * be created. */
+extern boolean ContextSwitch_Measure(boolean bUseFpu, ContextSwitchCost *pxCost);
+
+#endif /* CONTEXT_SWITCH_H_ */
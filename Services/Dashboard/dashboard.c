@@ -0,0 +1,254 @@
+ /******************************************************************************
+ *
+ * Module: Dashboard
+ *
+ * File Name: dashboard.c
+ *
+ * Description: Source file for the ANSI terminal dashboard renderer. The
+ *              layout is drawn into a back buffer, the front buffer holds
+ *              what the terminal shows. A refresh only sends the runs of
+ *              cells that differ, each behind a cursor position sequence, so
+ *              a digit that changed costs a few bytes instead of a screen.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#include "dashboard.h"
+#include "uart_gatekeeper.h"
+#include "format.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* DECSC / DECRC around every update, so the console cursor stays where it was */
+#define DASHBOARD_CURSOR_SAVE           "\0337"
+#define DASHBOARD_CURSOR_RESTORE        "\0338"
+#define DASHBOARD_CURSOR_RESTORE_SIZE   (2U)
+
+/* ESC [ row ; col H */
+#define DASHBOARD_MOVE_MAX              (8U)
+
+#if (DASHBOARD_COLS + DASHBOARD_MOVE_MAX + 4U > UART_GATEKEEPER_MESSAGE_SIZE)
+#error "A full dashboard row must fit in one UART gatekeeper message"
+#endif
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static char cBack[DASHBOARD_ROWS][DASHBOARD_COLS];
+static char cFront[DASHBOARD_ROWS][DASHBOARD_COLS];
+static boolean bInvalid = TRUE;
+
+static DashboardStats xStats = { 0, 0, 0, 0 };
+
+/* Only the dashboard task draws and refreshes */
+static UartMessage *pxMessage = NULL;     /* Update message being built */
+static uint32 ulRefreshBytes;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void prvAppendNumber(uint32 ulValue)
+{
+    uint8 ucNumber[FORMAT_BUFFER_SIZE];
+
+    (void) Format_Unsigned(ulValue, ucNumber);
+    UartGatekeeper_Append(pxMessage, (const char *) ucNumber);
+}
+
+static void prvSendMessage(void)
+{
+    ulRefreshBytes += pxMessage->ucLength;
+    UartGatekeeper_Send(pxMessage);
+    pxMessage = NULL;
+}
+
+/* Close the current update message if ucBytes more would not fit */
+static void prvReserve(uint8 ucBytes)
+{
+    if ((pxMessage != NULL) &&
+        ((pxMessage->ucLength + ucBytes + DASHBOARD_CURSOR_RESTORE_SIZE) > UART_GATEKEEPER_MESSAGE_SIZE))
+    {
+        UartGatekeeper_Append(pxMessage, DASHBOARD_CURSOR_RESTORE);
+        prvSendMessage();
+    }
+    if (pxMessage == NULL)
+    {
+        pxMessage = UartGatekeeper_Alloc(TRUE);
+        UartGatekeeper_Append(pxMessage, DASHBOARD_CURSOR_SAVE);
+    }
+}
+
+/* Clear the terminal, keep the rows below the dashboard for the console */
+static void prvSetupTerminal(void)
+{
+    uint8 ucRow, ucCol;
+
+    pxMessage = UartGatekeeper_Alloc(TRUE);
+    UartGatekeeper_Append(pxMessage, "\033[2J\033[");
+    prvAppendNumber(DASHBOARD_ROWS + 2U);
+    UartGatekeeper_Append(pxMessage, ";");
+    prvAppendNumber(DASHBOARD_TERMINAL_ROWS);
+    UartGatekeeper_Append(pxMessage, "r\033[");
+    prvAppendNumber(DASHBOARD_TERMINAL_ROWS);
+    UartGatekeeper_Append(pxMessage, ";1H");
+    prvSendMessage();
+
+    for (ucRow = 0; ucRow < DASHBOARD_ROWS; ucRow++)
+    {
+        for (ucCol = 0; ucCol < DASHBOARD_COLS; ucCol++)
+        {
+            cFront[ucRow][ucCol] = ' ';
+        }
+    }
+}
+
+static void prvPutRight(uint8 ucRow, uint8 ucCol, const uint8 *pucText, uint8 ucLength, uint8 ucWidth)
+{
+    uint8 ucIndex;
+
+    for (ucIndex = 0; (ucIndex < ucWidth) && ((ucCol + ucIndex) < DASHBOARD_COLS); ucIndex++)
+    {
+        if (ucLength > ucWidth)
+        {
+            cBack[ucRow][ucCol + ucIndex] = '*';
+        }
+        else
+        {
+            cBack[ucRow][ucCol + ucIndex] = (ucIndex < (ucWidth - ucLength)) ?
+                                            ' ' : (char) pucText[ucIndex - (ucWidth - ucLength)];
+        }
+    }
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void Dashboard_Init(void)
+{
+    uint8 ucRow, ucCol;
+
+    for (ucRow = 0; ucRow < DASHBOARD_ROWS; ucRow++)
+    {
+        for (ucCol = 0; ucCol < DASHBOARD_COLS; ucCol++)
+        {
+            cBack[ucRow][ucCol] = ' ';
+        }
+    }
+    bInvalid = TRUE;
+}
+
+void Dashboard_Invalidate(void)
+{
+    bInvalid = TRUE;
+}
+
+void Dashboard_PutText(uint8 ucRow, uint8 ucCol, const char *pcText, uint8 ucWidth)
+{
+    uint8 ucIndex;
+
+    if (ucRow >= DASHBOARD_ROWS)
+    {
+        return;
+    }
+    for (ucIndex = 0; (ucIndex < ucWidth) && ((ucCol + ucIndex) < DASHBOARD_COLS); ucIndex++)
+    {
+        cBack[ucRow][ucCol + ucIndex] = (*pcText != '\0') ? *pcText++ : ' ';
+    }
+}
+
+void Dashboard_PutUnsigned(uint8 ucRow, uint8 ucCol, uint32 ulValue, uint8 ucWidth)
+{
+    uint8 ucNumber[FORMAT_BUFFER_SIZE];
+
+    if (ucRow < DASHBOARD_ROWS)
+    {
+        prvPutRight(ucRow, ucCol, ucNumber, Format_Unsigned(ulValue, ucNumber), ucWidth);
+    }
+}
+
+void Dashboard_PutFixed(uint8 ucRow, uint8 ucCol, sint32 slValue, uint8 ucDecimals, uint8 ucWidth)
+{
+    uint8 ucNumber[FORMAT_BUFFER_SIZE];
+
+    if (ucRow < DASHBOARD_ROWS)
+    {
+        prvPutRight(ucRow, ucCol, ucNumber, Format_Fixed(slValue, ucDecimals, ucNumber), ucWidth);
+    }
+}
+
+uint32 Dashboard_Refresh(void)
+{
+    uint8 ucRow, ucCol, ucLast, ucIndex;
+
+    ulRefreshBytes = 0;
+    if (bInvalid == TRUE)
+    {
+        prvSetupTerminal();
+        bInvalid = FALSE;
+    }
+
+    for (ucRow = 0; ucRow < DASHBOARD_ROWS; ucRow++)
+    {
+        ucCol = 0;
+        while (ucCol < DASHBOARD_COLS)
+        {
+            if (cBack[ucRow][ucCol] == cFront[ucRow][ucCol])
+            {
+                ucCol++;
+                continue;
+            }
+
+            /* Extend the run over short unchanged gaps */
+            ucLast = ucCol;
+            for (ucIndex = ucCol + 1U; (ucIndex < DASHBOARD_COLS) && ((uint8)(ucIndex - ucLast) <= DASHBOARD_MIN_GAP); ucIndex++)
+            {
+                if (cBack[ucRow][ucIndex] != cFront[ucRow][ucIndex])
+                {
+                    ucLast = ucIndex;
+                }
+            }
+
+            prvReserve(DASHBOARD_MOVE_MAX + (ucLast - ucCol) + 1U);
+            UartGatekeeper_Append(pxMessage, "\033[");
+            prvAppendNumber(ucRow + 1U);
+            UartGatekeeper_Append(pxMessage, ";");
+            prvAppendNumber(ucCol + 1U);
+            UartGatekeeper_Append(pxMessage, "H");
+            for (; ucCol <= ucLast; ucCol++)
+            {
+                pxMessage->ucData[pxMessage->ucLength++] = (uint8) cBack[ucRow][ucCol];
+                cFront[ucRow][ucCol] = cBack[ucRow][ucCol];
+            }
+        }
+    }
+
+    if (pxMessage != NULL)
+    {
+        UartGatekeeper_Append(pxMessage, DASHBOARD_CURSOR_RESTORE);
+        prvSendMessage();
+    }
+
+    if (ulRefreshBytes != 0)
+    {
+        xStats.ulRefreshes++;
+        xStats.ulLastBytes = ulRefreshBytes;
+        xStats.ulTotalBytes += ulRefreshBytes;
+        if (ulRefreshBytes > xStats.ulMaxBytes)
+        {
+            xStats.ulMaxBytes = ulRefreshBytes;
+        }
+    }
+
+    return ulRefreshBytes;
+}
+
+const DashboardStats *Dashboard_GetStats(void)
+{
+    return &xStats;
+}
@@ -0,0 +1,70 @@
+ /******************************************************************************
+ *
+ * Module: Dashboard
+ *
+ * File Name: dashboard.h
+ *
+ * Description: Header file for the ANSI terminal dashboard renderer
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef DASHBOARD_H_
+#define DASHBOARD_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Screen model at the top of the terminal */
+#define DASHBOARD_ROWS                  (10U)
+#define DASHBOARD_COLS                  (64U)
+
+/* The terminal rows below the dashboard scroll the console replies */
+#define DASHBOARD_TERMINAL_ROWS         (24U)
+
+/* Unchanged cells shorter than this between two changed runs are sent again
+ * instead of moving the cursor (a move is up to 8 bytes) */
+#define DASHBOARD_MIN_GAP               (6U)
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint32 ulRefreshes;             /* Refreshes that sent something */
+    uint32 ulLastBytes;             /* Bytes of the last refresh that sent something */
+    uint32 ulMaxBytes;
+    uint32 ulTotalBytes;
+}DashboardStats;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Call before the scheduler starts */
+extern void Dashboard_Init(void);
+
+/* The next refresh clears the terminal and draws the whole screen */
+extern void Dashboard_Invalidate(void);
+
+/* Draw in the back buffer, text and numbers are cut or padded with spaces to ucWidth */
+extern void Dashboard_PutText(uint8 ucRow, uint8 ucCol, const char *pcText, uint8 ucWidth);
+
+/* Right aligned in ucWidth */
+extern void Dashboard_PutUnsigned(uint8 ucRow, uint8 ucCol, uint32 ulValue, uint8 ucWidth);
+extern void Dashboard_PutFixed(uint8 ucRow, uint8 ucCol, sint32 slValue, uint8 ucDecimals, uint8 ucWidth);
+
+/* Send the cells of the back buffer that differ from the terminal through the
+ * UART gatekeeper FIFO (may block, call from a low priority task). Every
+ * message saves and restores the cursor, so the console lines can go out
+ * between them. Returns the bytes sent. */
+extern uint32 Dashboard_Refresh(void);
+
+extern const DashboardStats *Dashboard_GetStats(void);
+
+#endif /* DASHBOARD_H_ */
@@ -0,0 +1,226 @@
+ /******************************************************************************
+ *
+ * Module: Display
+ *
+ * File Name: display.c
+ *
+ * Description: Source file for the change-driven seat state display. Every
+ *              seat remembers the values the host was sent and only the
+ *              fields that changed go out, no more often than the minimum
+ *              interval, with a full keyframe from time to time. A seat that
+ *              is stable costs one comparison per sample and no UART time.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#include "display.h"
+#include "task.h"
+#include "uart_gatekeeper.h"
+#include "format.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* The text lines do not show the sampling mode */
+#if (DISPLAY_FORMAT == DISPLAY_FORMAT_TELEMETRY)
+#define DISPLAY_FIELDS  (TELEMETRY_FIELDS_ALL)
+#else
+#define DISPLAY_FIELDS  (TELEMETRY_FIELD_TEMPERATURE | TELEMETRY_FIELD_DESIRED | TELEMETRY_FIELD_INTENSITY)
+#endif
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static uint8 prvChangedFields(const TelemetrySeatState *pxShown, const TelemetrySeatState *pxState)
+{
+    sint32 slDelta = (sint32)pxState->sTemperature - (sint32)pxShown->sTemperature;
+    uint8 ucFields = 0;
+
+    if ((slDelta >= DISPLAY_TEMPERATURE_DEADBAND) || (slDelta <= -DISPLAY_TEMPERATURE_DEADBAND))
+    {
+        ucFields |= TELEMETRY_FIELD_TEMPERATURE;
+    }
+    if (pxState->ucDesired != pxShown->ucDesired)
+    {
+        ucFields |= TELEMETRY_FIELD_DESIRED;
+    }
+    if (pxState->ucIntensity != pxShown->ucIntensity)
+    {
+        ucFields |= TELEMETRY_FIELD_INTENSITY;
+    }
+    if (pxState->ucFlags != pxShown->ucFlags)
+    {
+        ucFields |= TELEMETRY_FIELD_FLAGS;
+    }
+
+    return ucFields & DISPLAY_FIELDS;
+}
+
+#if (DISPLAY_FORMAT == DISPLAY_FORMAT_TELEMETRY)
+static uint8 prvSend(const TelemetrySeatState *pxState, uint8 ucFields)
+{
+    return (ucFields == TELEMETRY_FIELDS_ALL) ? Telemetry_SendSeatState(pxState) :
+                                                Telemetry_SendSeatDelta(pxState, ucFields);
+}
+#else
+static void prvAppendField(UartMessage *pxMessage, const TelemetrySeatState *pxState, uint8 ucField)
+{
+    static const char *const pcIntensities[] = {
+        "NO Intensity", "LOW Intensity", "MEDIUM Intensity", "HIGH Intensity", "NO Intensity due to error"
+    };
+    uint8 ucNumber[FORMAT_BUFFER_SIZE];
+
+    switch (ucField)
+    {
+    case TELEMETRY_FIELD_TEMPERATURE:
+        UartGatekeeper_Append(pxMessage, "Current Temperature = ");
+        (void) Format_Fixed(pxState->sTemperature, 1, ucNumber);
+        UartGatekeeper_Append(pxMessage, (const char *) ucNumber);
+        break;
+    case TELEMETRY_FIELD_DESIRED:
+        UartGatekeeper_Append(pxMessage, "Required Heat Level = ");
+        (void) Format_Unsigned(pxState->ucDesired, ucNumber);
+        UartGatekeeper_Append(pxMessage, (const char *) ucNumber);
+        break;
+    default:
+        UartGatekeeper_Append(pxMessage, "The Heater is Working with ");
+        UartGatekeeper_Append(pxMessage, (pxState->ucIntensity <= ERROR) ?
+                              pcIntensities[pxState->ucIntensity] : "?");
+        break;
+    }
+}
+
+/* The original block for a keyframe, one "Seat: field" line per change otherwise */
+static uint8 prvSend(const TelemetrySeatState *pxState, uint8 ucFields)
+{
+    const char *pcSeat = (pxState->ucSeat == 0) ? "Driver:" : "Passenger:";
+    boolean bKeyframe = (ucFields == DISPLAY_FIELDS) ? TRUE : FALSE;
+    UartMessage *pxMessage = UartGatekeeper_Alloc(FALSE);
+    uint8 ucLength;
+    uint8 ucField;
+
+    if (pxMessage == NULL)
+    {
+        return 0;
+    }
+    if (bKeyframe == TRUE)
+    {
+        UartGatekeeper_Append(pxMessage, pcSeat);
+    }
+    for (ucField = TELEMETRY_FIELD_TEMPERATURE; ucField <= TELEMETRY_FIELD_INTENSITY; ucField <<= 1)
+    {
+        if ((ucFields & ucField) == 0)
+        {
+            continue;
+        }
+        if (bKeyframe == TRUE)
+        {
+            UartGatekeeper_Append(pxMessage, "\n");
+            prvAppendField(pxMessage, pxState, ucField);
+        }
+        else
+        {
+            UartGatekeeper_Append(pxMessage, pcSeat);
+            UartGatekeeper_Append(pxMessage, " ");
+            prvAppendField(pxMessage, pxState, ucField);
+            UartGatekeeper_Append(pxMessage, "\n");
+        }
+    }
+    if (bKeyframe == TRUE)
+    {
+        UartGatekeeper_Append(pxMessage, "\n");
+    }
+
+    /* The message belongs to the gatekeeper once posted */
+    ucLength = pxMessage->ucLength;
+    UartGatekeeper_Post(pxState->ucSeat, pxMessage);
+    return ucLength;
+}
+#endif
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void Display_Init(DisplaySeat *pxSeat)
+{
+    pxSeat->bStarted = FALSE;
+    pxSeat->ucLastFields = 0;
+    pxSeat->xLastUpdate = 0;
+    pxSeat->xLastKeyframe = 0;
+    pxSeat->ulUpdates = 0;
+    pxSeat->ulKeyframes = 0;
+    pxSeat->ulUnchanged = 0;
+    pxSeat->ulDeferred = 0;
+}
+
+uint8 Display_Update(DisplaySeat *pxSeat, const TelemetrySeatState *pxState)
+{
+    TickType_t xNow = xTaskGetTickCount();
+    uint8 ucFields = DISPLAY_FIELDS;
+    uint8 ucBytes;
+
+    if ((pxSeat->bStarted == TRUE) &&
+        ((xNow - pxSeat->xLastKeyframe) < pdMS_TO_TICKS(DISPLAY_KEYFRAME_INTERVAL_MS)))
+    {
+        ucFields = prvChangedFields(&pxSeat->xShown, pxState);
+        if (ucFields == 0)
+        {
+            pxSeat->ulUnchanged++;
+            return 0;
+        }
+        if ((xNow - pxSeat->xLastUpdate) < pdMS_TO_TICKS(DISPLAY_MIN_INTERVAL_MS))
+        {
+            pxSeat->ulDeferred++;
+            return 0;
+        }
+        /* The last message is still waiting and this one replaces it */
+        if (UartGatekeeper_IsPending(pxState->ucSeat) == TRUE)
+        {
+            ucFields |= pxSeat->ucLastFields;
+        }
+    }
+
+    ucBytes = prvSend(pxState, ucFields);
+    if (ucBytes == 0)
+    {
+        /* No free message block, try again on the next update */
+        pxSeat->ulDeferred++;
+        return 0;
+    }
+
+    if (ucFields == DISPLAY_FIELDS)
+    {
+        pxSeat->xShown = *pxState;
+        pxSeat->xLastKeyframe = xNow;
+        pxSeat->ulKeyframes++;
+    }
+    else
+    {
+        if (ucFields & TELEMETRY_FIELD_TEMPERATURE)
+        {
+            pxSeat->xShown.sTemperature = pxState->sTemperature;
+        }
+        if (ucFields & TELEMETRY_FIELD_DESIRED)
+        {
+            pxSeat->xShown.ucDesired = pxState->ucDesired;
+        }
+        if (ucFields & TELEMETRY_FIELD_INTENSITY)
+        {
+            pxSeat->xShown.ucIntensity = pxState->ucIntensity;
+        }
+        if (ucFields & TELEMETRY_FIELD_FLAGS)
+        {
+            pxSeat->xShown.ucFlags = pxState->ucFlags;
+        }
+        pxSeat->ulUpdates++;
+    }
+    pxSeat->xLastUpdate = xNow;
+    pxSeat->ucLastFields = ucFields;
+    pxSeat->bStarted = TRUE;
+
+    return ucBytes;
+}
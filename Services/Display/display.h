@@ -0,0 +1,70 @@
+ /******************************************************************************
+ *
+ * Module: Display
+ *
+ * File Name: display.h
+ *
+ * Description: Header file for the change-driven seat state display
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef DISPLAY_H_
+#define DISPLAY_H_
+
+#include "FreeRTOS.h"
+#include "telemetry.h"
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Seat state output: the original text lines, the binary telemetry frames
+ * decoded on the host by Tools/telemetry or the ANSI terminal dashboard */
+#define DISPLAY_FORMAT_TEXT             (0U)
+#define DISPLAY_FORMAT_TELEMETRY        (1U)
+#define DISPLAY_FORMAT_DASHBOARD        (2U)
+#define DISPLAY_FORMAT                  DISPLAY_FORMAT_TELEMETRY
+
+/* Changes are sent at most once per interval, a change that comes earlier
+ * goes out with the first sample after it */
+#define DISPLAY_MIN_INTERVAL_MS         (400U)
+
+/* The full state is sent at this interval even without changes, so a host
+ * that starts late or lost a frame catches up */
+#define DISPLAY_KEYFRAME_INTERVAL_MS    (5000U)
+
+/* Temperature changes smaller than this (0.1 C) from the shown value are not sent */
+#define DISPLAY_TEMPERATURE_DEADBAND    (2)
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct
+{
+    TelemetrySeatState xShown;      /* Values the host has been sent */
+    TickType_t xLastUpdate;
+    TickType_t xLastKeyframe;
+    uint8 ucLastFields;             /* Fields of the last message, in case the next one replaces it */
+    boolean bStarted;
+    uint32 ulUpdates;               /* Delta messages */
+    uint32 ulKeyframes;
+    uint32 ulUnchanged;             /* States with nothing to send */
+    uint32 ulDeferred;              /* Changes held back by the minimum interval or an empty pool */
+}DisplaySeat;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+extern void Display_Init(DisplaySeat *pxSeat);
+
+/* Call with every new state of the seat: sends the fields that changed, or
+ * the whole state when a keyframe is due. Returns the bytes handed to the
+ * UART gatekeeper, 0 when nothing was sent. */
+extern uint8 Display_Update(DisplaySeat *pxSeat, const TelemetrySeatState *pxState);
+
+#endif /* DISPLAY_H_ */
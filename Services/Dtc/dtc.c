@@ -0,0 +1,221 @@
+ /******************************************************************************
+ *
+ * Module: Dtc
+ *
+ * File Name: dtc.c
+ *
+ * Description: Source file for the diagnostic trouble code manager. Every
+ *              DTC has a debounce counter that qualifies the raw test
+ *              results, a status byte, an aging counter and a freeze frame
+ *              of the first and last failure. A report updates only its own
+ *              record, so a fault is evaluated in constant time inside the
+ *              reading task.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#include "dtc.h"
+#include "task.h"
+#include "intensity_cfg.h"
+#include "store.h"
+#include "tm4c123gh6pm_registers.h"
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static const char *const pcDtcNames[DTC_COUNT] = {
+    "driver sensor low", "driver sensor high",
+    "passenger sensor low", "passenger sensor high",
+};
+
+static DtcRecord xDtcRecords[DTC_COUNT];
+static DtcSnapshotRead pfDtcSnapshot = NULL;
+static DtcStats xDtcStats;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void prvTakeSnapshot(DtcSnapshot *pxSnapshot)
+{
+    pfDtcSnapshot(pxSnapshot);
+    pxSnapshot->ulTime = xTaskGetTickCount() / configTICK_RATE_HZ;
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void Dtc_Init(DtcSnapshotRead pfSnapshot)
+{
+    uint8 ucId;
+
+    pfDtcSnapshot = pfSnapshot;
+    for (ucId = 0; ucId < DTC_COUNT; ucId++)
+    {
+        xDtcRecords[ucId].ucStatus = 0;
+        xDtcRecords[ucId].scCounter = 0;
+        xDtcRecords[ucId].ucAging = 0;
+        xDtcRecords[ucId].ucOccurrences = 0;
+    }
+
+    /* The report time is measured in CPU cycles */
+    CORE_DEMCR_REG |= CORE_DEMCR_TRCENA_MASK;
+    DWT_CTRL_REG |= DWT_CTRL_CYCCNTENA_MASK;
+}
+
+void Dtc_Report(uint8 ucId, boolean bFailed)
+{
+    DtcRecord *pxRecord = &xDtcRecords[ucId];
+    DtcSnapshot xSnapshot;
+    sint8 scCounter = pxRecord->scCounter;
+    boolean bQualified = FALSE, bConfirmed = FALSE;
+
+    /* Only this task writes the counter, the console reads the record */
+    if (bFailed == TRUE)
+    {
+        scCounter = (scCounter > (DTC_FAIL_LIMIT - DTC_FAIL_STEP)) ? DTC_FAIL_LIMIT : (scCounter + DTC_FAIL_STEP);
+        bQualified = ((scCounter == DTC_FAIL_LIMIT) && !(pxRecord->ucStatus & DTC_STATUS_TEST_FAILED)) ? TRUE : FALSE;
+    }
+    else
+    {
+        scCounter = (scCounter < (DTC_PASS_STEP - DTC_PASS_LIMIT)) ? -DTC_PASS_LIMIT : (scCounter - DTC_PASS_STEP);
+    }
+
+    if (bQualified == TRUE)
+    {
+        prvTakeSnapshot(&xSnapshot);
+    }
+
+    taskENTER_CRITICAL();
+    pxRecord->scCounter = scCounter;
+    if (bQualified == TRUE)
+    {
+        bConfirmed = (pxRecord->ucStatus & DTC_STATUS_CONFIRMED) ? FALSE : TRUE;
+        pxRecord->ucStatus |= DTC_STATUS_CONFIRMED;
+        if (pxRecord->ucOccurrences < 0xFFU)
+        {
+            pxRecord->ucOccurrences++;
+        }
+        if (bConfirmed == TRUE)
+        {
+            pxRecord->xFirst = xSnapshot;
+            xDtcStats.ulConfirmed++;
+        }
+        pxRecord->xLast = xSnapshot;
+    }
+    if (scCounter == DTC_FAIL_LIMIT)
+    {
+        /* Also a fault that stays failed over a new cycle, it does not age */
+        pxRecord->ucStatus |= DTC_STATUS_TEST_FAILED | DTC_STATUS_FAILED_THIS_CYCLE | DTC_STATUS_PENDING;
+        pxRecord->ucAging = 0;
+    }
+    else if (scCounter == -DTC_PASS_LIMIT)
+    {
+        pxRecord->ucStatus &= ~DTC_STATUS_TEST_FAILED;
+    }
+    xDtcStats.ulReports++;
+    taskEXIT_CRITICAL();
+
+    /* A new confirmed fault is kept over a power cycle, its repeats are counted here */
+    if (bConfirmed == TRUE)
+    {
+        Store_LogFault(ucId / DTC_SEAT_FAULTS, ucId, xSnapshot.sTemperature[ucId / DTC_SEAT_FAULTS],
+                       xSnapshot.ucLevel[ucId / DTC_SEAT_FAULTS]);
+    }
+}
+
+void Dtc_ReportSensor(uint8 ucSeat, Temperature xTemp)
+{
+    uint32 ulStart = DWT_CYCCNT_REG;
+    uint32 ulCycles;
+
+    Dtc_Report(DTC_ID(ucSeat, DTC_SENSOR_LOW), (xTemp < TEMPERATURE_FROM_C(INTENSITY_SENSOR_MIN_C)) ? TRUE : FALSE);
+    Dtc_Report(DTC_ID(ucSeat, DTC_SENSOR_HIGH), (xTemp > TEMPERATURE_FROM_C(INTENSITY_SENSOR_MAX_C)) ? TRUE : FALSE);
+
+    ulCycles = DWT_CYCCNT_REG - ulStart;
+    if (ulCycles > xDtcStats.ulMaxCycles)
+    {
+        xDtcStats.ulMaxCycles = ulCycles;
+    }
+}
+
+void Dtc_StartCycle(uint8 ucSeat)
+{
+    DtcRecord *pxRecord;
+    uint8 ucId;
+
+    taskENTER_CRITICAL();
+    for (ucId = DTC_ID(ucSeat, 0); ucId < DTC_ID(ucSeat + 1U, 0); ucId++)
+    {
+        pxRecord = &xDtcRecords[ucId];
+        if (pxRecord->ucStatus & DTC_STATUS_FAILED_THIS_CYCLE)
+        {
+            pxRecord->ucStatus &= ~DTC_STATUS_FAILED_THIS_CYCLE;
+            continue;
+        }
+
+        /* No failure in the cycle that ended */
+        pxRecord->ucStatus &= ~DTC_STATUS_PENDING;
+        if ((pxRecord->ucStatus & DTC_STATUS_CONFIRMED) && (++pxRecord->ucAging >= DTC_AGING_CYCLES))
+        {
+            pxRecord->ucStatus = 0;
+            pxRecord->ucAging = 0;
+            pxRecord->ucOccurrences = 0;
+            xDtcStats.ulAged++;
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+
+uint8 Dtc_Find(uint8 ucMask, uint8 *pucIds)
+{
+    uint8 ucId, ucFound = 0;
+
+    for (ucId = 0; ucId < DTC_COUNT; ucId++)
+    {
+        if (xDtcRecords[ucId].ucStatus & ucMask)
+        {
+            pucIds[ucFound++] = ucId;
+        }
+    }
+    return ucFound;
+}
+
+uint8 Dtc_GetStatus(uint8 ucId)
+{
+    return xDtcRecords[ucId].ucStatus;
+}
+
+void Dtc_GetRecord(uint8 ucId, DtcRecord *pxRecord)
+{
+    taskENTER_CRITICAL();
+    *pxRecord = xDtcRecords[ucId];
+    taskEXIT_CRITICAL();
+}
+
+const char *Dtc_GetName(uint8 ucId)
+{
+    return (ucId < DTC_COUNT) ? pcDtcNames[ucId] : "?";
+}
+
+void Dtc_Clear(void)
+{
+    uint8 ucId;
+
+    taskENTER_CRITICAL();
+    for (ucId = 0; ucId < DTC_COUNT; ucId++)
+    {
+        xDtcRecords[ucId].ucStatus = 0;
+        xDtcRecords[ucId].ucAging = 0;
+        xDtcRecords[ucId].ucOccurrences = 0;
+    }
+    taskEXIT_CRITICAL();
+}
+
+const DtcStats *Dtc_GetStats(void)
+{
+    return &xDtcStats;
+}
@@ -0,0 +1,131 @@
+ /******************************************************************************
+ *
+ * Module: Dtc
+ *
+ * File Name: dtc.h
+ *
+ * Description: Header file for the diagnostic trouble code manager
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef DTC_H_
+#define DTC_H_
+
+#include "FreeRTOS.h"
+#include "std_types.h"
+#include "temperature.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define DTC_SEATS                       (2U)
+
+/* Status bits, a subset of the ISO 14229 DTC status byte */
+#define DTC_STATUS_TEST_FAILED          (0x01U)     /* Qualified failed at the last report */
+#define DTC_STATUS_FAILED_THIS_CYCLE    (0x02U)
+#define DTC_STATUS_PENDING              (0x04U)     /* Failed in this or the last operation cycle */
+#define DTC_STATUS_CONFIRMED            (0x08U)     /* Latched until aged or cleared */
+#define DTC_STATUS_ALL                  (0x0FU)
+
+/* Counter debounce: a failed report adds DTC_FAIL_STEP, a passed one takes
+ * DTC_PASS_STEP off. The fault is qualified failed at DTC_FAIL_LIMIT and
+ * passed again at -DTC_PASS_LIMIT. In samples: 5 failed ones qualify a
+ * failure from the count of 0 after Dtc_Init() (10 from a healed DTC), and
+ * 20 passed ones heal it. The sensor is reported on every sample, so at the
+ * fast 200 ms sampling that is 1 s (2 s) to fail and 4 s to heal, and 5 s
+ * (10 s) and 20 s when slow sampling takes one release out of
+ * SAMPLING_SLOW_DIVIDER. */
+#define DTC_FAIL_STEP                   (2)
+#define DTC_PASS_STEP                   (1)
+#define DTC_FAIL_LIMIT                  (10)
+#define DTC_PASS_LIMIT                  (10)
+
+/* Operation cycles (heating sessions between two deep sleeps) without a
+ * failure before a confirmed fault is forgotten */
+#define DTC_AGING_CYCLES                (3U)
+
+#if ((DTC_FAIL_LIMIT > 127) || (DTC_PASS_LIMIT > 128) || (DTC_FAIL_STEP > DTC_FAIL_LIMIT) || (DTC_PASS_STEP > DTC_PASS_LIMIT))
+#error "The debounce counter is a sint8 and a step must not skip a limit"
+#endif
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+/* Per seat faults, the DTC of a seat fault is DTC_ID(seat, fault) */
+typedef enum
+{
+    DTC_SENSOR_LOW,                 /* Reading below INTENSITY_SENSOR_MIN_C */
+    DTC_SENSOR_HIGH,                /* Reading above INTENSITY_SENSOR_MAX_C */
+    DTC_SEAT_FAULTS
+}DtcSeatFault;
+
+#define DTC_ID(SEAT, FAULT)             ((uint8) (((SEAT) * DTC_SEAT_FAULTS) + (FAULT)))
+#define DTC_COUNT                       (DTC_SEATS * DTC_SEAT_FAULTS)
+
+/* Freeze frame, taken when a failure is qualified */
+typedef struct
+{
+    uint32 ulTime;                  /* Seconds since boot */
+    sint16 sTemperature[DTC_SEATS]; /* 0.1 C */
+    uint8 ucLevel[DTC_SEATS];       /* 0 (off) to 3 (high) */
+}DtcSnapshot;
+
+typedef struct
+{
+    uint8 ucStatus;                 /* DTC_STATUS_* */
+    sint8 scCounter;                /* Debounce counter */
+    uint8 ucAging;                  /* Cycles without a failure since the last one */
+    uint8 ucOccurrences;            /* Qualified failures, saturates at 255 */
+    DtcSnapshot xFirst;             /* When the DTC was confirmed */
+    DtcSnapshot xLast;              /* Last qualified failure */
+}DtcRecord;
+
+typedef struct
+{
+    uint32 ulReports;
+    uint32 ulConfirmed;
+    uint32 ulAged;
+    uint32 ulMaxCycles;             /* Longest Dtc_ReportSensor(), in CPU cycles */
+}DtcStats;
+
+/* Fills the levels and temperatures of a snapshot, called from the reporting task */
+typedef void (*DtcSnapshotRead)(DtcSnapshot *pxSnapshot);
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Call before the scheduler starts, all DTCs passed */
+extern void Dtc_Init(DtcSnapshotRead pfSnapshot);
+
+/* Result of one test: O(1), a confirmation also goes to the EEPROM fault
+ * log. Every DTC must be reported by one task only. */
+extern void Dtc_Report(uint8 ucId, boolean bFailed);
+
+/* Tests all faults of a seat on a new reading, a fixed number of reports */
+extern void Dtc_ReportSensor(uint8 ucSeat, Temperature xTemp);
+
+/* New heating session of a seat: ages the confirmed faults that did not fail
+ * in the last one. Called by the task that reports the seat. */
+extern void Dtc_StartCycle(uint8 ucSeat);
+
+/* DTCs with any of the status bits of ucMask set, in DTC order. Returns how
+ * many, at most DTC_COUNT are written to pucIds. */
+extern uint8 Dtc_Find(uint8 ucMask, uint8 *pucIds);
+
+extern uint8 Dtc_GetStatus(uint8 ucId);
+
+extern void Dtc_GetRecord(uint8 ucId, DtcRecord *pxRecord);
+
+extern const char *Dtc_GetName(uint8 ucId);
+
+/* Clears the status and snapshots of every DTC, the EEPROM log is kept */
+extern void Dtc_Clear(void);
+
+extern const DtcStats *Dtc_GetStats(void);
+
+#endif /* DTC_H_ */
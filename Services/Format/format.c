@@ -0,0 +1,161 @@
+ /******************************************************************************
+ *
+ * Module: Format
+ *
+ * File Name: format.c
+ *
+ * Description: Source file for the integer, fixed-point and hex formatting.
+ *              Only 32-bit arithmetic is used (no runtime library calls for
+ *              64-bit division) and decimal digits are produced two at a time
+ *              from a table, so a conversion takes at most five divisions.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#include "format.h"
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static const uint8 ucDigitPairs[200] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static const uint32 ulPowersOf10[FORMAT_MAX_DECIMALS + 1] = {
+    1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL,
+    1000000UL, 10000000UL, 100000000UL, 1000000000UL
+};
+
+static const uint8 ucHexDigits[16] = "0123456789ABCDEF";
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static uint8 prvCountDigits(uint32 ulValue)
+{
+    uint8 ucDigits = 1;
+
+    while ((ucDigits <= FORMAT_MAX_DECIMALS) && (ulValue >= ulPowersOf10[ucDigits]))
+    {
+        ucDigits++;
+    }
+
+    return ucDigits;
+}
+
+/* Write exactly ucDigits digits of ulValue (zero padded) ending before pucEnd */
+static void prvWriteDigits(uint32 ulValue, uint8 ucDigits, uint8 *pucEnd)
+{
+    uint32 ulPair;
+
+    while (ucDigits >= 2)
+    {
+        ulPair = (ulValue % 100U) * 2U;
+        ulValue /= 100U;
+        *--pucEnd = ucDigitPairs[ulPair + 1];
+        *--pucEnd = ucDigitPairs[ulPair];
+        ucDigits -= 2;
+    }
+    if (ucDigits == 1)
+    {
+        *--pucEnd = (uint8)('0' + (ulValue % 10U));
+    }
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+uint8 Format_Unsigned(uint32 ulValue, uint8 *pucBuffer)
+{
+    uint8 ucLength = prvCountDigits(ulValue);
+
+    prvWriteDigits(ulValue, ucLength, &pucBuffer[ucLength]);
+    pucBuffer[ucLength] = '\0';
+
+    return ucLength;
+}
+
+uint8 Format_Signed(sint32 slValue, uint8 *pucBuffer)
+{
+    if (slValue < 0)
+    {
+        *pucBuffer = '-';
+        /* Unsigned negation also covers the most negative value */
+        return (uint8)(1U + Format_Unsigned(0UL - (uint32)slValue, pucBuffer + 1));
+    }
+
+    return Format_Unsigned((uint32)slValue, pucBuffer);
+}
+
+uint8 Format_Fixed(sint32 slValue, uint8 ucDecimals, uint8 *pucBuffer)
+{
+    uint32 ulMagnitude;
+    uint8 ucLength = 0;
+
+    if (ucDecimals == 0)
+    {
+        return Format_Signed(slValue, pucBuffer);
+    }
+    if (ucDecimals > FORMAT_MAX_DECIMALS)
+    {
+        ucDecimals = FORMAT_MAX_DECIMALS;
+    }
+
+    if (slValue < 0)
+    {
+        pucBuffer[ucLength++] = '-';
+        ulMagnitude = 0UL - (uint32)slValue;
+    }
+    else
+    {
+        ulMagnitude = (uint32)slValue;
+    }
+
+    ucLength += Format_Unsigned(ulMagnitude / ulPowersOf10[ucDecimals], &pucBuffer[ucLength]);
+    pucBuffer[ucLength++] = '.';
+    ucLength += ucDecimals;
+    prvWriteDigits(ulMagnitude % ulPowersOf10[ucDecimals], ucDecimals, &pucBuffer[ucLength]);
+    pucBuffer[ucLength] = '\0';
+
+    return ucLength;
+}
+
+uint8 Format_Hex(uint32 ulValue, uint8 ucMinDigits, uint8 *pucBuffer)
+{
+    uint8 ucLength = 1;
+    uint8 ucIndex;
+
+    while ((ucLength < 8U) && ((ulValue >> (4U * ucLength)) != 0))
+    {
+        ucLength++;
+    }
+    if (ucMinDigits > 8U)
+    {
+        ucMinDigits = 8U;
+    }
+    if (ucLength < ucMinDigits)
+    {
+        ucLength = ucMinDigits;
+    }
+
+    for (ucIndex = ucLength; ucIndex > 0; ucIndex--)
+    {
+        pucBuffer[ucIndex - 1] = ucHexDigits[ulValue & 0x0FU];
+        ulValue >>= 4;
+    }
+    pucBuffer[ucLength] = '\0';
+
+    return ucLength;
+}
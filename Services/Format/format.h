@@ -0,0 +1,45 @@
+ /******************************************************************************
+ *
+ * Module: Format
+ *
+ * File Name: format.h
+ *
+ * Description: Header file for the integer, fixed-point and hex formatting.
+ *              All conversions write a null terminated string into a buffer
+ *              of the caller and return its length (without the terminator).
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef FORMAT_H_
+#define FORMAT_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Fits any conversion of a 32-bit value: sign, ten digits, the decimal point,
+ * a leading zero before it and the terminator */
+#define FORMAT_BUFFER_SIZE          (14U)
+
+/* Largest number of decimals of Format_Fixed() */
+#define FORMAT_MAX_DECIMALS         (9U)
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+extern uint8 Format_Unsigned(uint32 ulValue, uint8 *pucBuffer);
+
+extern uint8 Format_Signed(sint32 slValue, uint8 *pucBuffer);
+
+/* slValue is scaled by 10^ucDecimals, e.g. Format_Fixed(-253, 1) is "-25.3" */
+extern uint8 Format_Fixed(sint32 slValue, uint8 ucDecimals, uint8 *pucBuffer);
+
+/* Upper case hexadecimal without prefix, padded with zeros to ucMinDigits */
+extern uint8 Format_Hex(uint32 ulValue, uint8 ucMinDigits, uint8 *pucBuffer);
+
+#endif /* FORMAT_H_ */
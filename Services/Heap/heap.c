@@ -0,0 +1,492 @@
+ /******************************************************************************
+ *
+ * Module: Heap
+ *
+ * File Name: heap.c
+ *
+ * Description: Source file for the coalescing FreeRTOS heap. The free blocks
+ *              are kept in segregated lists, one per size class: a first
+ *              level per power of two, split in 8 second level classes. Two
+ *              bitmaps find a free list that is large enough with a few bit
+ *              operations, so pvPortMalloc() and vPortFree() take bounded
+ *              time whatever the number of blocks. Every block knows the one
+ *              below it in memory and the free flag of the one above, so a
+ *              freed block is merged with its free neighbours right away.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#include <string.h>
+
+#include "heap.h"
+#include "task.h"
+#include "tm4c123gh6pm_registers.h"
+
+#if (configHEAP_COALESCING == 1)
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define HEAP_ALIGNMENT          (1UL << HEAP_ALIGNMENT_LOG2)
+#define HEAP_SL_COUNT           (1UL << HEAP_SL_LOG2)
+
+/* Below this size one first level list holds one second level list per 8 bytes */
+#define HEAP_FL_SHIFT           (HEAP_SL_LOG2 + HEAP_ALIGNMENT_LOG2)
+#define HEAP_SMALL_BLOCK        (1UL << HEAP_FL_SHIFT)
+#define HEAP_FL_COUNT           (HEAP_FL_MAX_LOG2 - HEAP_FL_SHIFT + 2U)
+#define HEAP_MAX_BLOCK          ((1UL << (HEAP_FL_MAX_LOG2 + 1U)) - HEAP_ALIGNMENT)
+
+/* Used blocks only keep the first two fields, the free list links overlay the payload */
+#define HEAP_HEADER_SIZE        (2U * sizeof(void *))
+#define HEAP_MIN_PAYLOAD        (2U * sizeof(void *))
+
+/* Flags in the low bits of xSize, the sizes are multiples of the alignment */
+#define HEAP_BLOCK_FREE         ((size_t) 1U)
+#define HEAP_BLOCK_PREV_FREE    ((size_t) 2U)
+#define HEAP_BLOCK_FLAGS        (HEAP_BLOCK_FREE | HEAP_BLOCK_PREV_FREE)
+
+#define HEAP_SIZE(BLOCK)        ((BLOCK)->xSize & ~HEAP_BLOCK_FLAGS)
+#define HEAP_NEXT_PHYS(BLOCK)   ((HeapBlock *) ((uint8 *) (BLOCK) + HEAP_HEADER_SIZE + HEAP_SIZE(BLOCK)))
+
+#define HEAP_BYTES              ((configTOTAL_HEAP_SIZE / HEAP_ALIGNMENT) * HEAP_ALIGNMENT)
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct HeapBlock
+{
+    struct HeapBlock *pxPrevPhys;   /* Block just below in memory, NULL for the first one */
+    size_t xSize;                   /* Payload bytes | HEAP_BLOCK_FREE | HEAP_BLOCK_PREV_FREE */
+    struct HeapBlock *pxNextFree;   /* Free blocks only */
+    struct HeapBlock *pxPrevFree;
+}HeapBlock;
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+/* 64-bit elements keep the heap on the 8-byte port alignment */
+static uint64 ullHeap[HEAP_BYTES / sizeof(uint64)];
+static boolean bInitialised = FALSE;
+
+static uint32 ulFlBitmap = 0;
+static uint32 ulSlBitmap[HEAP_FL_COUNT];
+static HeapBlock *pxFreeLists[HEAP_FL_COUNT][HEAP_SL_COUNT];
+
+/* Payload bytes of the free blocks */
+static size_t xFreeBytes = 0;
+static size_t xMinimumEverFreeBytes = 0;
+static size_t xAllocations = 0;
+static size_t xFrees = 0;
+
+static HeapLatency xLatency = { 0, 0, 0, 0, 0 };
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+/* Index of the highest set bit, ulValue must not be 0 */
+static uint32 prvFls(uint32 ulValue)
+{
+    uint32 ulBit = 0;
+
+    /* Binary search, the TI compiler has no portable count leading zeros */
+    if (ulValue & 0xFFFF0000UL)
+    {
+        ulBit += 16U;
+        ulValue >>= 16;
+    }
+    if (ulValue & 0x0000FF00UL)
+    {
+        ulBit += 8U;
+        ulValue >>= 8;
+    }
+    if (ulValue & 0x000000F0UL)
+    {
+        ulBit += 4U;
+        ulValue >>= 4;
+    }
+    if (ulValue & 0x0000000CUL)
+    {
+        ulBit += 2U;
+        ulValue >>= 2;
+    }
+    if (ulValue & 0x00000002UL)
+    {
+        ulBit += 1U;
+    }
+
+    return ulBit;
+}
+
+/* Index of the lowest set bit, ulValue must not be 0 */
+static uint32 prvFfs(uint32 ulValue)
+{
+    return prvFls(ulValue & (~ulValue + 1U));
+}
+
+/* Free list of the size class that holds xSize */
+static void prvMapping(size_t xSize, uint32 *pulFl, uint32 *pulSl)
+{
+    uint32 ulBit;
+
+    if (xSize < HEAP_SMALL_BLOCK)
+    {
+        *pulFl = 0;
+        *pulSl = (uint32) xSize >> HEAP_ALIGNMENT_LOG2;
+    }
+    else
+    {
+        ulBit = prvFls((uint32) xSize);
+        *pulSl = ((uint32) xSize >> (ulBit - HEAP_SL_LOG2)) ^ HEAP_SL_COUNT;
+        *pulFl = ulBit - HEAP_FL_SHIFT + 1U;
+    }
+}
+
+/* First non-empty free list whose every block holds xSize, NULL if none */
+static HeapBlock *prvFindSuitable(size_t xSize, uint32 *pulFl, uint32 *pulSl)
+{
+    uint32 ulSlMap, ulFlMap;
+
+    /* Round up to the next class, any block of it is large enough */
+    if (xSize >= HEAP_SMALL_BLOCK)
+    {
+        xSize += (1UL << (prvFls((uint32) xSize) - HEAP_SL_LOG2)) - 1U;
+    }
+    prvMapping(xSize, pulFl, pulSl);
+    if (*pulFl >= HEAP_FL_COUNT)
+    {
+        return NULL;
+    }
+
+    ulSlMap = ulSlBitmap[*pulFl] & (~0UL << *pulSl);
+    if (ulSlMap == 0)
+    {
+        ulFlMap = ulFlBitmap & (~0UL << (*pulFl + 1U));
+        if (ulFlMap == 0)
+        {
+            return NULL;
+        }
+        *pulFl = prvFfs(ulFlMap);
+        ulSlMap = ulSlBitmap[*pulFl];
+    }
+    *pulSl = prvFfs(ulSlMap);
+
+    return pxFreeLists[*pulFl][*pulSl];
+}
+
+static void prvInsertBlock(HeapBlock *pxBlock)
+{
+    uint32 ulFl, ulSl;
+
+    prvMapping(HEAP_SIZE(pxBlock), &ulFl, &ulSl);
+    pxBlock->pxPrevFree = NULL;
+    pxBlock->pxNextFree = pxFreeLists[ulFl][ulSl];
+    if (pxBlock->pxNextFree != NULL)
+    {
+        pxBlock->pxNextFree->pxPrevFree = pxBlock;
+    }
+    pxFreeLists[ulFl][ulSl] = pxBlock;
+    ulFlBitmap |= (1UL << ulFl);
+    ulSlBitmap[ulFl] |= (1UL << ulSl);
+}
+
+static void prvRemoveBlock(HeapBlock *pxBlock)
+{
+    uint32 ulFl, ulSl;
+
+    prvMapping(HEAP_SIZE(pxBlock), &ulFl, &ulSl);
+    if (pxBlock->pxNextFree != NULL)
+    {
+        pxBlock->pxNextFree->pxPrevFree = pxBlock->pxPrevFree;
+    }
+    if (pxBlock->pxPrevFree != NULL)
+    {
+        pxBlock->pxPrevFree->pxNextFree = pxBlock->pxNextFree;
+    }
+    else
+    {
+        pxFreeLists[ulFl][ulSl] = pxBlock->pxNextFree;
+        if (pxBlock->pxNextFree == NULL)
+        {
+            ulSlBitmap[ulFl] &= ~(1UL << ulSl);
+            if (ulSlBitmap[ulFl] == 0)
+            {
+                ulFlBitmap &= ~(1UL << ulFl);
+            }
+        }
+    }
+}
+
+/* One free block over the whole heap, closed by a used block of size 0 */
+static void prvHeapInit(void)
+{
+    HeapBlock *pxFirst = (HeapBlock *) ullHeap;
+    HeapBlock *pxEnd;
+
+    pxFirst->pxPrevPhys = NULL;
+    pxFirst->xSize = (HEAP_BYTES - (2U * HEAP_HEADER_SIZE)) | HEAP_BLOCK_FREE;
+    pxEnd = HEAP_NEXT_PHYS(pxFirst);
+    pxEnd->pxPrevPhys = pxFirst;
+    pxEnd->xSize = HEAP_BLOCK_PREV_FREE;
+    prvInsertBlock(pxFirst);
+
+    xFreeBytes = HEAP_SIZE(pxFirst);
+    xMinimumEverFreeBytes = xFreeBytes;
+
+    /* The latency is measured in CPU cycles */
+    CORE_DEMCR_REG |= CORE_DEMCR_TRCENA_MASK;
+    DWT_CTRL_REG |= DWT_CTRL_CYCCNTENA_MASK;
+
+    bInitialised = TRUE;
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void *pvPortMalloc(size_t xWantedSize)
+{
+    uint32 ulStart;
+    HeapBlock *pxBlock = NULL;
+    HeapBlock *pxRemainder, *pxNext;
+    uint32 ulFl, ulSl, ulCycles;
+    size_t xSize = 0, xBlockSize;
+    void *pvReturn = NULL;
+
+    vTaskSuspendAll();
+    {
+        if (bInitialised == FALSE)
+        {
+            prvHeapInit();
+        }
+        ulStart = DWT_CYCCNT_REG;     /* No task can preempt from here, interrupts still can */
+
+        if ((xWantedSize > 0) && (xWantedSize <= HEAP_MAX_BLOCK))
+        {
+            xSize = (xWantedSize + (HEAP_ALIGNMENT - 1U)) & ~(HEAP_ALIGNMENT - 1U);
+            if (xSize < HEAP_MIN_PAYLOAD)
+            {
+                xSize = HEAP_MIN_PAYLOAD;
+            }
+            pxBlock = prvFindSuitable(xSize, &ulFl, &ulSl);
+        }
+
+        if (pxBlock != NULL)
+        {
+            prvRemoveBlock(pxBlock);
+            xBlockSize = HEAP_SIZE(pxBlock);
+            pxNext = HEAP_NEXT_PHYS(pxBlock);
+
+            /* Give the end of the block back if it can make a block of its own */
+            if (xBlockSize >= (xSize + HEAP_HEADER_SIZE + HEAP_MIN_PAYLOAD))
+            {
+                pxRemainder = (HeapBlock *) ((uint8 *) pxBlock + HEAP_HEADER_SIZE + xSize);
+                pxRemainder->pxPrevPhys = pxBlock;
+                pxRemainder->xSize = (xBlockSize - xSize - HEAP_HEADER_SIZE) | HEAP_BLOCK_FREE;
+                pxNext->pxPrevPhys = pxRemainder;
+                prvInsertBlock(pxRemainder);
+                xFreeBytes -= xSize + HEAP_HEADER_SIZE;
+                xBlockSize = xSize;
+            }
+            else
+            {
+                pxNext->xSize &= ~HEAP_BLOCK_PREV_FREE;
+                xFreeBytes -= xBlockSize;
+            }
+
+            /* The block below a free block is never free, it would have been merged */
+            pxBlock->xSize = xBlockSize;
+            if (xFreeBytes < xMinimumEverFreeBytes)
+            {
+                xMinimumEverFreeBytes = xFreeBytes;
+            }
+            xAllocations++;
+            pvReturn = (uint8 *) pxBlock + HEAP_HEADER_SIZE;
+        }
+        else
+        {
+            xLatency.ulFailures++;
+        }
+
+        ulCycles = DWT_CYCCNT_REG - ulStart;
+        xLatency.ulTotalAllocCycles += ulCycles;
+        if (ulCycles > xLatency.ulMaxAllocCycles)
+        {
+            xLatency.ulMaxAllocCycles = ulCycles;
+        }
+    }
+    (void) xTaskResumeAll();
+
+    #if (configUSE_MALLOC_FAILED_HOOK == 1)
+    {
+        if (pvReturn == NULL)
+        {
+            vApplicationMallocFailedHook();
+        }
+    }
+    #endif
+
+    return pvReturn;
+}
+
+void vPortFree(void *pv)
+{
+    HeapBlock *pxBlock, *pxNeighbour;
+    uint32 ulStart, ulCycles;
+
+    if (pv == NULL)
+    {
+        return;
+    }
+
+    vTaskSuspendAll();
+    {
+        ulStart = DWT_CYCCNT_REG;
+        pxBlock = (HeapBlock *) ((uint8 *) pv - HEAP_HEADER_SIZE);
+        configASSERT((pxBlock->xSize & HEAP_BLOCK_FREE) == 0);
+
+        xFreeBytes += HEAP_SIZE(pxBlock);
+        pxBlock->xSize |= HEAP_BLOCK_FREE;
+
+        /* Merge with the free block below, its header becomes payload */
+        if (pxBlock->xSize & HEAP_BLOCK_PREV_FREE)
+        {
+            pxNeighbour = pxBlock->pxPrevPhys;
+            prvRemoveBlock(pxNeighbour);
+            pxNeighbour->xSize += HEAP_HEADER_SIZE + HEAP_SIZE(pxBlock);
+            xFreeBytes += HEAP_HEADER_SIZE;
+            pxBlock = pxNeighbour;
+        }
+
+        /* Merge with the free block above */
+        pxNeighbour = HEAP_NEXT_PHYS(pxBlock);
+        if (pxNeighbour->xSize & HEAP_BLOCK_FREE)
+        {
+            prvRemoveBlock(pxNeighbour);
+            pxBlock->xSize += HEAP_HEADER_SIZE + HEAP_SIZE(pxNeighbour);
+            xFreeBytes += HEAP_HEADER_SIZE;
+            pxNeighbour = HEAP_NEXT_PHYS(pxBlock);
+        }
+
+        pxNeighbour->pxPrevPhys = pxBlock;
+        pxNeighbour->xSize |= HEAP_BLOCK_PREV_FREE;
+        prvInsertBlock(pxBlock);
+        xFrees++;
+
+        ulCycles = DWT_CYCCNT_REG - ulStart;
+        xLatency.ulTotalFreeCycles += ulCycles;
+        if (ulCycles > xLatency.ulMaxFreeCycles)
+        {
+            xLatency.ulMaxFreeCycles = ulCycles;
+        }
+    }
+    (void) xTaskResumeAll();
+}
+
+void *pvPortCalloc(size_t xNum, size_t xSize)
+{
+    void *pv = NULL;
+
+    if ((xNum == 0) || (xSize <= (HEAP_MAX_BLOCK / xNum)))
+    {
+        pv = pvPortMalloc(xNum * xSize);
+        if (pv != NULL)
+        {
+            (void) memset(pv, 0, xNum * xSize);
+        }
+    }
+
+    return pv;
+}
+
+size_t xPortGetFreeHeapSize(void)
+{
+    return xFreeBytes;
+}
+
+size_t xPortGetMinimumEverFreeHeapSize(void)
+{
+    return xMinimumEverFreeBytes;
+}
+
+void vPortInitialiseBlocks(void)
+{
+    /* Done by the first pvPortMalloc() */
+}
+
+/* Walks every block, for reports only */
+void vPortGetHeapStats(HeapStats_t *pxHeapStats)
+{
+    HeapBlock *pxBlock = (HeapBlock *) ullHeap;
+    size_t xLargest = 0, xSmallest = 0, xBlocks = 0;
+
+    vTaskSuspendAll();
+    {
+        if (bInitialised == TRUE)
+        {
+            while (HEAP_SIZE(pxBlock) != 0)
+            {
+                if (pxBlock->xSize & HEAP_BLOCK_FREE)
+                {
+                    if (HEAP_SIZE(pxBlock) > xLargest)
+                    {
+                        xLargest = HEAP_SIZE(pxBlock);
+                    }
+                    if ((xBlocks == 0) || (HEAP_SIZE(pxBlock) < xSmallest))
+                    {
+                        xSmallest = HEAP_SIZE(pxBlock);
+                    }
+                    xBlocks++;
+                }
+                pxBlock = HEAP_NEXT_PHYS(pxBlock);
+            }
+        }
+        pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytes;
+        pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytes;
+        pxHeapStats->xNumberOfSuccessfulAllocations = xAllocations;
+        pxHeapStats->xNumberOfSuccessfulFrees = xFrees;
+    }
+    (void) xTaskResumeAll();
+
+    pxHeapStats->xSizeOfLargestFreeBlockInBytes = xLargest;
+    pxHeapStats->xSizeOfSmallestFreeBlockInBytes = xSmallest;
+    pxHeapStats->xNumberOfFreeBlocks = xBlocks;
+}
+
+/* The largest block is in the highest non-empty free list */
+size_t Heap_GetLargestFreeBlock(void)
+{
+    HeapBlock *pxBlock;
+    size_t xLargest = 0;
+    uint32 ulFl;
+
+    vTaskSuspendAll();
+    {
+        if (ulFlBitmap != 0)
+        {
+            ulFl = prvFls(ulFlBitmap);
+            for (pxBlock = pxFreeLists[ulFl][prvFls(ulSlBitmap[ulFl])]; pxBlock != NULL;
+                 pxBlock = pxBlock->pxNextFree)
+            {
+                if (HEAP_SIZE(pxBlock) > xLargest)
+                {
+                    xLargest = HEAP_SIZE(pxBlock);
+                }
+            }
+        }
+    }
+    (void) xTaskResumeAll();
+
+    return xLargest;
+}
+
+const HeapLatency *Heap_GetLatency(void)
+{
+    return &xLatency;
+}
+
+#endif /* configHEAP_COALESCING */
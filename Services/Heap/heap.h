@@ -0,0 +1,61 @@
+ /******************************************************************************
+ *
+ * Module: Heap
+ *
+ * File Name: heap.h
+ *
+ * Description: Header file for the coalescing FreeRTOS heap (two-level
+ *              segregated fit), built instead of heap_2.c when
+ *              configHEAP_COALESCING is 1
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef HEAP_H_
+#define HEAP_H_
+
+#include "FreeRTOS.h"
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Block sizes are multiples of the port alignment (8 bytes) */
+#define HEAP_ALIGNMENT_LOG2             (3U)
+
+/* Every power of two size range is split in 2^HEAP_SL_LOG2 free lists */
+#define HEAP_SL_LOG2                    (3U)
+
+/* Largest block: 2^(HEAP_FL_MAX_LOG2 + 1) - 1 bytes, must hold configTOTAL_HEAP_SIZE */
+#define HEAP_FL_MAX_LOG2                (15U)
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+/* Timed with the scheduler suspended, so other tasks are not counted. The
+ * interrupts that run meanwhile are. */
+typedef struct
+{
+    uint32 ulFailures;              /* pvPortMalloc() calls that returned NULL */
+    uint32 ulMaxAllocCycles;        /* Longest pvPortMalloc(), in CPU cycles */
+    uint32 ulMaxFreeCycles;         /* Longest vPortFree(), in CPU cycles */
+    uint32 ulTotalAllocCycles;      /* Sum over the successful and failed allocations */
+    uint32 ulTotalFreeCycles;
+}HeapLatency;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* The block sizes and counts go through the FreeRTOS API: xPortGetFreeHeapSize(),
+ * xPortGetMinimumEverFreeHeapSize() and vPortGetHeapStats() */
+
+/* Largest block pvPortMalloc() can return right now, in bytes */
+extern size_t Heap_GetLargestFreeBlock(void);
+
+extern const HeapLatency *Heap_GetLatency(void);
+
+#endif /* HEAP_H_ */
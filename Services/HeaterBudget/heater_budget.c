@@ -0,0 +1,347 @@
+ /******************************************************************************
+ *
+ * Module: HeaterBudget
+ *
+ * File Name: heater_budget.c
+ *
+ * Description: Source file for the heater power budget arbiter. Every seat
+ *              asks for a number of heater slots per PWM frame by intensity,
+ *              the arbiter shares HEATER_BUDGET_LIMIT_SLOTS between them by
+ *              policy and places the granted slots one seat after the other
+ *              around the frame, so no two heaters switch on in the same
+ *              slot and two heaters are only on together once the grants
+ *              exceed a frame. Arbitration and placement run in bounded
+ *              time: at most HEATER_BUDGET_SEATS + 1 passes over the seats
+ *              and HEATER_BUDGET_SEATS moves of a first slot.
+ *
+ *              WTimer2 steps through the slots and switches the heaters at
+ *              their edges. A new frame is played from the next frame start,
+ *              or at once when the timer was not running.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#include "heater_budget.h"
+#include "task.h"
+#include "clock.h"
+#include "GPTM.h"
+#include "tm4c123gh6pm_registers.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define HEATER_BUDGET_FRAME_MASK        ((1UL << HEATER_BUDGET_SLOTS) - 1UL)
+
+#define HEATER_BUDGET_SLOT_TICKS        ((HEATER_BUDGET_SLOT_MS * WTIMER0_TICKS_PER_SECOND) / 1000UL)
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint32 ulMask[HEATER_BUDGET_SEATS];         /* Bit n: heater on in slot n */
+    HeatIntensity eIntensity[HEATER_BUDGET_SEATS];
+}HeaterBudgetFrame;
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static HeaterBudgetOutput pfHeaterOutput;
+static HeaterBudgetPolicy eHeaterPolicy = HEATER_BUDGET_FAIR_SHARE;
+static HeaterBudgetSeat xHeaterSeats[HEATER_BUDGET_SEATS];
+static HeaterBudgetStats xHeaterStats;
+
+/* The slot timer plays xHeaterFrames[ucPlaying], the arbiter fills the other
+ * one and marks it pending. Both sides run with the slot interrupt masked. */
+static HeaterBudgetFrame xHeaterFrames[2];
+static uint8 ucPlaying = 0;
+static boolean bPending = FALSE;
+static boolean bTimerRunning = FALSE;
+static uint8 ucSlot = 0;
+static boolean bDriven[HEATER_BUDGET_SEATS];
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static uint8 prvDemand(HeatIntensity eIntensity)
+{
+    switch (eIntensity)
+    {
+    case LOWINTENSITY:
+        return HEATER_BUDGET_LOW_SLOTS;
+    case MEDIUMINTENSITY:
+        return HEATER_BUDGET_MEDIUM_SLOTS;
+    case HIGHINTENSITY:
+        return HEATER_BUDGET_HIGH_SLOTS;
+    default:
+        return 0;
+    }
+}
+
+static void prvArbitrate(void)
+{
+    uint8 ucRemaining = HEATER_BUDGET_LIMIT_SLOTS;
+    uint8 ucOpen = 0;
+    uint8 ucShare, ucGive, ucSeat;
+    uint32 ulDemanded = 0;
+
+    for (ucSeat = 0; ucSeat < HEATER_BUDGET_SEATS; ucSeat++)
+    {
+        xHeaterSeats[ucSeat].ucGranted = 0;
+        ulDemanded += xHeaterSeats[ucSeat].ucDemand;
+        if (xHeaterSeats[ucSeat].ucDemand > 0)
+        {
+            ucOpen++;
+        }
+    }
+
+    if (eHeaterPolicy == HEATER_BUDGET_DRIVER_PRIORITY)
+    {
+        for (ucSeat = 0; ucSeat < HEATER_BUDGET_SEATS; ucSeat++)
+        {
+            ucGive = xHeaterSeats[ucSeat].ucDemand;
+            if (ucGive > ucRemaining)
+            {
+                ucGive = ucRemaining;
+            }
+            xHeaterSeats[ucSeat].ucGranted = ucGive;
+            ucRemaining -= ucGive;
+        }
+    }
+    else
+    {
+        /* Every pass satisfies a seat or leaves fewer slots than open seats */
+        while (ucOpen > 0)
+        {
+            ucShare = ucRemaining / ucOpen;
+            if (ucShare == 0)
+            {
+                break;
+            }
+            for (ucSeat = 0; ucSeat < HEATER_BUDGET_SEATS; ucSeat++)
+            {
+                if (xHeaterSeats[ucSeat].ucGranted < xHeaterSeats[ucSeat].ucDemand)
+                {
+                    ucGive = xHeaterSeats[ucSeat].ucDemand - xHeaterSeats[ucSeat].ucGranted;
+                    if (ucGive > ucShare)
+                    {
+                        ucGive = ucShare;
+                    }
+                    xHeaterSeats[ucSeat].ucGranted += ucGive;
+                    ucRemaining -= ucGive;
+                    if (xHeaterSeats[ucSeat].ucGranted == xHeaterSeats[ucSeat].ucDemand)
+                    {
+                        ucOpen--;
+                    }
+                }
+            }
+        }
+
+        /* The last slots, fewer than the open seats, go in seat order */
+        for (ucSeat = 0; (ucSeat < HEATER_BUDGET_SEATS) && (ucRemaining > 0); ucSeat++)
+        {
+            if (xHeaterSeats[ucSeat].ucGranted < xHeaterSeats[ucSeat].ucDemand)
+            {
+                xHeaterSeats[ucSeat].ucGranted++;
+                ucRemaining--;
+            }
+        }
+    }
+
+    xHeaterStats.ulArbitrations++;
+    if ((HEATER_BUDGET_LIMIT_SLOTS - ucRemaining) < ulDemanded)
+    {
+        xHeaterStats.ulLimited++;
+    }
+}
+
+/* Fill a frame from the grants, TRUE if a heater switches within it */
+static boolean prvPlace(HeaterBudgetFrame *pxFrame)
+{
+    uint8 ucCursor = 0;
+    uint32 ulStarts = 0;
+    uint32 ulRun;
+    boolean bSwitching = FALSE;
+    uint8 ucSeat, ucGranted;
+
+    for (ucSeat = 0; ucSeat < HEATER_BUDGET_SEATS; ucSeat++)
+    {
+        ucGranted = xHeaterSeats[ucSeat].ucGranted;
+        pxFrame->eIntensity[ucSeat] = xHeaterSeats[ucSeat].eIntensity;
+        xHeaterSeats[ucSeat].ucFirstSlot = 0;
+
+        if (ucGranted == 0)
+        {
+            pxFrame->ulMask[ucSeat] = 0;
+        }
+        else if (ucGranted >= HEATER_BUDGET_SLOTS)
+        {
+            /* Always on, no edge in the frame */
+            pxFrame->ulMask[ucSeat] = HEATER_BUDGET_FRAME_MASK;
+        }
+        else
+        {
+            /* Never switch on in the slot another seat switches on */
+            while (ulStarts & (1UL << ucCursor))
+            {
+                ucCursor = (ucCursor + 1U) % HEATER_BUDGET_SLOTS;
+            }
+            ulStarts |= (1UL << ucCursor);
+
+            ulRun = (1UL << ucGranted) - 1UL;
+            pxFrame->ulMask[ucSeat] = ((ulRun << ucCursor) | (ulRun >> (HEATER_BUDGET_SLOTS - ucCursor))) &
+                                      HEATER_BUDGET_FRAME_MASK;
+            xHeaterSeats[ucSeat].ucFirstSlot = ucCursor;
+            ucCursor = (ucCursor + ucGranted) % HEATER_BUDGET_SLOTS;
+            bSwitching = TRUE;
+        }
+    }
+
+    return bSwitching;
+}
+
+/* Switch the heaters whose state in the current slot differs from their output */
+static void prvDrive(boolean bForce)
+{
+    const HeaterBudgetFrame *pxFrame = &xHeaterFrames[ucPlaying];
+    boolean bOn;
+    uint8 ucSeat;
+
+    for (ucSeat = 0; ucSeat < HEATER_BUDGET_SEATS; ucSeat++)
+    {
+        bOn = (pxFrame->ulMask[ucSeat] & (1UL << ucSlot)) ? TRUE : FALSE;
+        if ((bForce == TRUE) || (bOn != bDriven[ucSeat]))
+        {
+            bDriven[ucSeat] = bOn;
+            pfHeaterOutput(ucSeat, pxFrame->eIntensity[ucSeat], bOn);
+        }
+    }
+}
+
+/* WTimer2 interrupt, once per slot */
+static void prvSlotTimeout(void)
+{
+    boolean bForce = FALSE;
+
+    ucSlot++;
+    if (ucSlot >= HEATER_BUDGET_SLOTS)
+    {
+        ucSlot = 0;
+        xHeaterStats.ulFrames++;
+        if (bPending == TRUE)
+        {
+            ucPlaying ^= 1U;
+            bPending = FALSE;
+            bForce = TRUE;
+        }
+    }
+    prvDrive(bForce);
+}
+
+/* Called in a critical section */
+static void prvUpdate(void)
+{
+    uint32 ulStart = DWT_CYCCNT_REG;
+    uint32 ulCycles;
+    boolean bSwitching;
+
+    prvArbitrate();
+    bSwitching = prvPlace(&xHeaterFrames[ucPlaying ^ 1U]);
+
+    ulCycles = DWT_CYCCNT_REG - ulStart;
+    if (ulCycles > xHeaterStats.ulMaxCycles)
+    {
+        xHeaterStats.ulMaxCycles = ulCycles;
+    }
+
+    if ((bSwitching == TRUE) && (bTimerRunning == TRUE))
+    {
+        bPending = TRUE;
+        return;
+    }
+
+    /* Start the new frame now: no frame in progress, or no slot to time */
+    ucPlaying ^= 1U;
+    bPending = FALSE;
+    ucSlot = 0;
+    prvDrive(TRUE);
+    if (bSwitching == TRUE)
+    {
+        GPTM_WTimer2Start(HEATER_BUDGET_SLOT_TICKS);
+    }
+    else if (bTimerRunning == TRUE)
+    {
+        GPTM_WTimer2Stop();
+    }
+    bTimerRunning = bSwitching;
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void HeaterBudget_Init(HeaterBudgetOutput pfOutput)
+{
+    uint8 ucSeat;
+
+    pfHeaterOutput = pfOutput;
+    for (ucSeat = 0; ucSeat < HEATER_BUDGET_SEATS; ucSeat++)
+    {
+        xHeaterSeats[ucSeat].eIntensity = INTENSITYOFF;
+        xHeaterSeats[ucSeat].ucDemand = 0;
+        xHeaterSeats[ucSeat].ucGranted = 0;
+        xHeaterSeats[ucSeat].ucFirstSlot = 0;
+        xHeaterFrames[ucPlaying].ulMask[ucSeat] = 0;
+        xHeaterFrames[ucPlaying].eIntensity[ucSeat] = INTENSITYOFF;
+    }
+    prvDrive(TRUE);
+
+    /* The arbitration time is measured in CPU cycles */
+    CORE_DEMCR_REG |= CORE_DEMCR_TRCENA_MASK;
+    DWT_CTRL_REG |= DWT_CTRL_CYCCNTENA_MASK;
+
+    GPTM_WTimer2Init(Clock_GetFrequency(), prvSlotTimeout);
+}
+
+void HeaterBudget_Request(uint8 ucSeat, HeatIntensity eIntensity)
+{
+    configASSERT(ucSeat < HEATER_BUDGET_SEATS);
+
+    taskENTER_CRITICAL();
+    xHeaterSeats[ucSeat].eIntensity = eIntensity;
+    xHeaterSeats[ucSeat].ucDemand = prvDemand(eIntensity);
+    prvUpdate();
+    taskEXIT_CRITICAL();
+}
+
+void HeaterBudget_SetPolicy(HeaterBudgetPolicy ePolicy)
+{
+    taskENTER_CRITICAL();
+    eHeaterPolicy = ePolicy;
+    prvUpdate();
+    taskEXIT_CRITICAL();
+}
+
+HeaterBudgetPolicy HeaterBudget_GetPolicy(void)
+{
+    return eHeaterPolicy;
+}
+
+void HeaterBudget_GetSeat(uint8 ucSeat, HeaterBudgetSeat *pxSeat)
+{
+    configASSERT(ucSeat < HEATER_BUDGET_SEATS);
+
+    taskENTER_CRITICAL();
+    *pxSeat = xHeaterSeats[ucSeat];
+    taskEXIT_CRITICAL();
+}
+
+const HeaterBudgetStats *HeaterBudget_GetStats(void)
+{
+    return &xHeaterStats;
+}
@@ -0,0 +1,99 @@
+ /******************************************************************************
+ *
+ * Module: HeaterBudget
+ *
+ * File Name: heater_budget.h
+ *
+ * Description: Header file for the heater power budget arbiter
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef HEATER_BUDGET_H_
+#define HEATER_BUDGET_H_
+
+#include "FreeRTOS.h"
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define HEATER_BUDGET_SEATS             (2U)
+
+/* PWM frame: HEATER_BUDGET_SLOTS slots of HEATER_BUDGET_SLOT_MS, timed by WTimer2 */
+#define HEATER_BUDGET_SLOTS             (10U)
+#define HEATER_BUDGET_SLOT_MS           (10U)
+
+/* Slots per frame each intensity asks for */
+#define HEATER_BUDGET_LOW_SLOTS         (4U)
+#define HEATER_BUDGET_MEDIUM_SLOTS      (7U)
+#define HEATER_BUDGET_HIGH_SLOTS        (HEATER_BUDGET_SLOTS)
+
+/* Heater slots per frame the harness allows over all seats: 1.2 heaters on
+ * average, two heaters are only on together for 2 slots of a frame */
+#define HEATER_BUDGET_LIMIT_SLOTS       (12U)
+
+#if ((HEATER_BUDGET_SLOTS > 31U) || (HEATER_BUDGET_SEATS >= HEATER_BUDGET_SLOTS))
+#error "A heater frame is a 32-bit slot mask with a different first slot for every seat"
+#endif
+
+#if ((HEATER_BUDGET_LOW_SLOTS > HEATER_BUDGET_MEDIUM_SLOTS) || (HEATER_BUDGET_MEDIUM_SLOTS > HEATER_BUDGET_HIGH_SLOTS) || \
+     (HEATER_BUDGET_HIGH_SLOTS > HEATER_BUDGET_SLOTS))
+#error "The heater demands must rise with the intensity and fit in a frame"
+#endif
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef enum
+{
+    HEATER_BUDGET_FAIR_SHARE,       /* Equal shares, a seat asking for less leaves the rest to the others */
+    HEATER_BUDGET_DRIVER_PRIORITY   /* In seat order, the driver first */
+}HeaterBudgetPolicy;
+
+/* Drives the heater of a seat at its slot edges and at every new frame.
+ * Called from the WTimer2 interrupt, or from a critical section of the
+ * request, so the two calls never interleave. */
+typedef void (*HeaterBudgetOutput)(uint8 ucSeat, HeatIntensity eIntensity, boolean bOn);
+
+typedef struct
+{
+    HeatIntensity eIntensity;
+    uint8 ucDemand;                 /* Slots per frame */
+    uint8 ucGranted;
+    uint8 ucFirstSlot;              /* Where the heater switches on in the frame */
+}HeaterBudgetSeat;
+
+typedef struct
+{
+    uint32 ulArbitrations;
+    uint32 ulLimited;               /* Arbitrations that granted less than the seats asked for */
+    uint32 ulMaxCycles;             /* Longest arbitration and placement, in CPU cycles */
+    uint32 ulFrames;                /* PWM frames played by the slot timer */
+}HeaterBudgetStats;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Call before the scheduler starts, all heaters off */
+extern void HeaterBudget_Init(HeaterBudgetOutput pfOutput);
+
+/* New intensity of a seat: the budget is arbitrated again for all seats and
+ * the slots are placed in the next frame. The slot timer only runs while a
+ * heater is neither fully on nor off. */
+extern void HeaterBudget_Request(uint8 ucSeat, HeatIntensity eIntensity);
+
+/* Arbitrates the current requests again with the new policy */
+extern void HeaterBudget_SetPolicy(HeaterBudgetPolicy ePolicy);
+
+extern HeaterBudgetPolicy HeaterBudget_GetPolicy(void);
+
+extern void HeaterBudget_GetSeat(uint8 ucSeat, HeaterBudgetSeat *pxSeat);
+
+extern const HeaterBudgetStats *HeaterBudget_GetStats(void);
+
+#endif /* HEATER_BUDGET_H_ */
@@ -0,0 +1,219 @@
+ /******************************************************************************
+ *
+ * Module: Intensity
+ *
+ * File Name: intensity.c
+ *
+ * Description: Source file for the heater intensity decision. The error
+ *              bands of intensity_cfg.h are expanded into a lookup table by
+ *              the preprocessor, so a decision is one range check,
+ *              one rounding and one table read instead of a chain of float
+ *              comparisons. The bands are whole C, so rounding the error
+ *              down before the lookup selects the same intensity as
+ *              comparing the exact error with them. In fixed point the
+ *              decision sees the reading in 0.1 C like the display. The
+ *              console rebuilds the table to tune the bands at runtime.
+ *
+ *              The seat state machine keeps an intensity until the reading
+ *              moved past the hysteresis and the dwell time elapsed, so a
+ *              reading on a band edge no longer flips the heater, the LEDs
+ *              and the display every release.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#include "intensity.h"
+#include "task.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define INTENSITY_LUT_ERROR_INDEX       (0)
+
+#define INTENSITY_HYSTERESIS            TEMPERATURE_FROM_TENTHS(INTENSITY_HYSTERESIS_TENTHS)
+
+/* Whole C error of a table entry */
+#define INTENSITY_ERROR_OF_INDEX(INDEX) ((INDEX) - 1 + INTENSITY_ERROR_MIN_C)
+
+/* Intensity of a whole C error, for the build time and the runtime bands */
+#define INTENSITY_OF_ERROR(ERR, LOW, MEDIUM, HIGH)  (((ERR) >= (HIGH)) ? HIGHINTENSITY :     \
+                                                     ((ERR) >= (MEDIUM)) ? MEDIUMINTENSITY : \
+                                                     ((ERR) >= (LOW)) ? LOWINTENSITY : INTENSITYOFF)
+
+#define INTENSITY_LUT_ENTRY(INDEX)      (uint8) (((INDEX) == INTENSITY_LUT_ERROR_INDEX) ? ERROR :  \
+                                         INTENSITY_OF_ERROR(INTENSITY_ERROR_OF_INDEX(INDEX),      \
+                                                            INTENSITY_LOW_FROM_C,                 \
+                                                            INTENSITY_MEDIUM_FROM_C,              \
+                                                            INTENSITY_HIGH_FROM_C))
+
+#define INTENSITY_LUT_2(INDEX)          INTENSITY_LUT_ENTRY(INDEX), INTENSITY_LUT_ENTRY((INDEX) + 1)
+#define INTENSITY_LUT_4(INDEX)          INTENSITY_LUT_2(INDEX), INTENSITY_LUT_2((INDEX) + 2)
+#define INTENSITY_LUT_8(INDEX)          INTENSITY_LUT_4(INDEX), INTENSITY_LUT_4((INDEX) + 4)
+#define INTENSITY_LUT_16(INDEX)         INTENSITY_LUT_8(INDEX), INTENSITY_LUT_8((INDEX) + 8)
+#define INTENSITY_LUT_32(INDEX)         INTENSITY_LUT_16(INDEX), INTENSITY_LUT_16((INDEX) + 16)
+#define INTENSITY_LUT_64(INDEX)         INTENSITY_LUT_32(INDEX), INTENSITY_LUT_32((INDEX) + 32)
+#define INTENSITY_LUT_128(INDEX)        INTENSITY_LUT_64(INDEX), INTENSITY_LUT_64((INDEX) + 64)
+
+#if (INTENSITY_LUT_SIZE != 128)
+#error "Generate the intensity lookup table with INTENSITY_LUT_<size>"
+#endif
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+/* In RAM to tune the bands, the entries past INTENSITY_ERROR_MAX_C are never read */
+static uint8 ucIntensityLut[INTENSITY_LUT_SIZE] = { INTENSITY_LUT_128(0) };
+
+static IntensityBands xBands = { INTENSITY_LOW_FROM_C, INTENSITY_MEDIUM_FROM_C, INTENSITY_HIGH_FROM_C };
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void prvCountWindow(IntensitySeat *pxSeat, TickType_t xNow)
+{
+    if ((xNow - pxSeat->xWindowStart) >= pdMS_TO_TICKS(INTENSITY_RATE_WINDOW_MS))
+    {
+        pxSeat->usTransitionsPerMinute = pxSeat->usWindowTransitions;
+        pxSeat->usRawTransitionsPerMinute = pxSeat->usWindowRawTransitions;
+        pxSeat->usWindowTransitions = 0;
+        pxSeat->usWindowRawTransitions = 0;
+        pxSeat->xWindowStart = xNow;
+    }
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+HeatIntensity Intensity_Select(UserHeatInput eDesired, Temperature xCurrent)
+{
+#if (TEMPERATURE_FIXED_POINT == 0U)
+    float32 fError;
+    sint32 slError;
+#endif
+    uint8 ucIndex = INTENSITY_LUT_ERROR_INDEX;
+
+    if ((xCurrent >= TEMPERATURE_FROM_C(INTENSITY_SENSOR_MIN_C)) &&
+        (xCurrent <= TEMPERATURE_FROM_C(INTENSITY_SENSOR_MAX_C)))
+    {
+#if (TEMPERATURE_FIXED_POINT == 1U)
+        /* Offset to a positive error in 0.1 C, so the division rounds down */
+        ucIndex = (uint8) (((TEMPERATURE_FROM_C((sint32) eDesired) - xCurrent -
+                             TEMPERATURE_FROM_C(INTENSITY_ERROR_MIN_C)) / 10) + 1);
+#else
+        /* Round down: the conversion rounds towards zero */
+        fError = (float32) eDesired - xCurrent;
+        slError = (sint32) fError;
+        if ((float32) slError > fError)
+        {
+            slError--;
+        }
+        ucIndex = (uint8) (slError - INTENSITY_ERROR_MIN_C + 1);
+#endif
+    }
+    return (HeatIntensity) ucIntensityLut[ucIndex];
+}
+
+boolean Intensity_SetBands(const IntensityBands *pxBands)
+{
+    uint8 ucIndex;
+
+    if ((pxBands->ucLowFrom == 0) || (pxBands->ucLowFrom >= pxBands->ucMediumFrom) ||
+        (pxBands->ucMediumFrom >= pxBands->ucHighFrom) || (pxBands->ucHighFrom > INTENSITY_ERROR_MAX_C) ||
+        ((10 * (pxBands->ucMediumFrom - pxBands->ucLowFrom)) <= INTENSITY_HYSTERESIS_TENTHS) ||
+        ((10 * (pxBands->ucHighFrom - pxBands->ucMediumFrom)) <= INTENSITY_HYSTERESIS_TENTHS))
+    {
+        return FALSE;
+    }
+
+    /* Entry by entry without a critical section: each one is a byte, so a
+     * decision during the update uses the old or the new bands for its error */
+    for (ucIndex = INTENSITY_LUT_ERROR_INDEX + 1; ucIndex < INTENSITY_LUT_SIZE; ucIndex++)
+    {
+        ucIntensityLut[ucIndex] = (uint8) INTENSITY_OF_ERROR(INTENSITY_ERROR_OF_INDEX((sint32) ucIndex),
+                                                             pxBands->ucLowFrom, pxBands->ucMediumFrom,
+                                                             pxBands->ucHighFrom);
+    }
+
+    taskENTER_CRITICAL();
+    xBands = *pxBands;
+    taskEXIT_CRITICAL();
+
+    return TRUE;
+}
+
+void Intensity_GetBands(IntensityBands *pxBands)
+{
+    taskENTER_CRITICAL();
+    *pxBands = xBands;
+    taskEXIT_CRITICAL();
+}
+
+void Intensity_InitSeat(IntensitySeat *pxSeat)
+{
+    pxSeat->eState = INTENSITYOFF;
+    pxSeat->eDesired = OFF;
+    pxSeat->eRaw = INTENSITYOFF;
+    pxSeat->xEntered = xTaskGetTickCount();
+    pxSeat->ulTransitions = 0;
+    pxSeat->ulRawTransitions = 0;
+    pxSeat->ulHeldBack = 0;
+    pxSeat->xWindowStart = pxSeat->xEntered;
+    pxSeat->usWindowTransitions = 0;
+    pxSeat->usWindowRawTransitions = 0;
+    pxSeat->usTransitionsPerMinute = 0;
+    pxSeat->usRawTransitionsPerMinute = 0;
+}
+
+HeatIntensity Intensity_Update(IntensitySeat *pxSeat, UserHeatInput eDesired, Temperature xCurrent)
+{
+    TickType_t xNow = xTaskGetTickCount();
+    HeatIntensity eRaw = Intensity_Select(eDesired, xCurrent);
+    HeatIntensity eNext = eRaw;
+    Temperature xShifted;
+
+    prvCountWindow(pxSeat, xNow);
+    if (eRaw != pxSeat->eRaw)
+    {
+        pxSeat->eRaw = eRaw;
+        pxSeat->ulRawTransitions++;
+        pxSeat->usWindowRawTransitions++;
+    }
+
+    /* Going down: the band of a reading lower by the hysteresis, kept in
+     * the sensor range so it does not read as ERROR */
+    if ((eRaw < pxSeat->eState) && (pxSeat->eState != ERROR))
+    {
+        xShifted = xCurrent - INTENSITY_HYSTERESIS;
+        if (xShifted < TEMPERATURE_FROM_C(INTENSITY_SENSOR_MIN_C))
+        {
+            xShifted = TEMPERATURE_FROM_C(INTENSITY_SENSOR_MIN_C);
+        }
+        eNext = Intensity_Select(eDesired, xShifted);
+    }
+
+    if ((eNext != pxSeat->eState) && (eNext != ERROR) && (eDesired == pxSeat->eDesired) &&
+        ((xNow - pxSeat->xEntered) < pdMS_TO_TICKS(INTENSITY_MIN_DWELL_MS)))
+    {
+        eNext = pxSeat->eState;
+    }
+    if (eNext != eRaw)
+    {
+        pxSeat->ulHeldBack++;
+    }
+
+    if (eNext != pxSeat->eState)
+    {
+        pxSeat->eState = eNext;
+        pxSeat->xEntered = xNow;
+        pxSeat->ulTransitions++;
+        pxSeat->usWindowTransitions++;
+    }
+    pxSeat->eDesired = eDesired;
+
+    return pxSeat->eState;
+}
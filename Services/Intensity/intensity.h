@@ -0,0 +1,102 @@
+ /******************************************************************************
+ *
+ * Module: Intensity
+ *
+ * File Name: intensity.h
+ *
+ * Description: Header file for the heater intensity decision
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef INTENSITY_H_
+#define INTENSITY_H_
+
+#include "FreeRTOS.h"
+#include "std_types.h"
+#include "temperature.h"
+#include "intensity_cfg.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Whole C errors a trusted reading can give */
+#define INTENSITY_ERROR_MIN_C           (0 - INTENSITY_SENSOR_MAX_C)
+#define INTENSITY_ERROR_MAX_C           (INTENSITY_DESIRED_MAX_C - INTENSITY_SENSOR_MIN_C)
+
+/* Lookup table entries: ERROR first, then one per whole C of error from
+ * INTENSITY_ERROR_MIN_C. Generated by doubling, so a power of two. */
+#define INTENSITY_LUT_SIZE              (128)
+
+#if ((INTENSITY_LOW_FROM_C <= 0) || (INTENSITY_LOW_FROM_C >= INTENSITY_MEDIUM_FROM_C) || \
+     (INTENSITY_MEDIUM_FROM_C >= INTENSITY_HIGH_FROM_C))
+#error "The intensity bands in intensity_cfg.h must be positive and rising"
+#endif
+
+#if ((INTENSITY_SENSOR_MIN_C > INTENSITY_SENSOR_MAX_C) || \
+     ((INTENSITY_ERROR_MAX_C - INTENSITY_ERROR_MIN_C + 2) > INTENSITY_LUT_SIZE))
+#error "The sensor range in intensity_cfg.h does not fit the intensity lookup table"
+#endif
+
+#if ((INTENSITY_HYSTERESIS_TENTHS < 0) || \
+     (INTENSITY_HYSTERESIS_TENTHS >= (10 * (INTENSITY_MEDIUM_FROM_C - INTENSITY_LOW_FROM_C))) || \
+     (INTENSITY_HYSTERESIS_TENTHS >= (10 * (INTENSITY_HIGH_FROM_C - INTENSITY_MEDIUM_FROM_C))))
+#error "The intensity hysteresis in intensity_cfg.h must be narrower than the bands"
+#endif
+
+/* Transitions are also counted over one minute windows */
+#define INTENSITY_RATE_WINDOW_MS        (60000UL)
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+/* Smallest error (desired - current, in whole C) of each intensity */
+typedef struct
+{
+    uint8 ucLowFrom;
+    uint8 ucMediumFrom;
+    uint8 ucHighFrom;
+}IntensityBands;
+
+/* Intensity state machine of one seat */
+typedef struct
+{
+    HeatIntensity eState;
+    UserHeatInput eDesired;         /* Level of the last decision */
+    HeatIntensity eRaw;             /* Band of the last reading without hysteresis and dwell */
+    TickType_t xEntered;            /* Tick eState was entered */
+    uint32 ulTransitions;           /* Changes of eState */
+    uint32 ulRawTransitions;        /* Changes the bands alone would have made */
+    uint32 ulHeldBack;              /* Decisions kept by the hysteresis or the dwell time */
+    TickType_t xWindowStart;
+    uint16 usWindowTransitions;
+    uint16 usWindowRawTransitions;
+    uint16 usTransitionsPerMinute;  /* Of the last complete window */
+    uint16 usRawTransitionsPerMinute;
+}IntensitySeat;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Intensity for a seat: ERROR outside of the trusted sensor range,
+ * otherwise the band of the error rounded down to whole C */
+extern HeatIntensity Intensity_Select(UserHeatInput eDesired, Temperature xCurrent);
+
+/* Rebuilds the lookup table for new bands, the ones of intensity_cfg.h
+ * apply until then. Returns FALSE and keeps the bands unless they are
+ * positive, rising, wider than the hysteresis and reachable by the error. */
+extern boolean Intensity_SetBands(const IntensityBands *pxBands);
+
+extern void Intensity_GetBands(IntensityBands *pxBands);
+
+extern void Intensity_InitSeat(IntensitySeat *pxSeat);
+
+/* Intensity for a seat with the hysteresis and the minimum dwell time of
+ * intensity_cfg.h, call once per controller release */
+extern HeatIntensity Intensity_Update(IntensitySeat *pxSeat, UserHeatInput eDesired, Temperature xCurrent);
+
+#endif /* INTENSITY_H_ */
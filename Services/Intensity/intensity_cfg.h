@@ -0,0 +1,40 @@
+ /******************************************************************************
+ *
+ * Module: Intensity
+ *
+ * File Name: intensity_cfg.h
+ *
+ * Description: Band specification of the heater intensity decision. The
+ *              lookup table of intensity.c is generated from it when the
+ *              firmware is built, tune the controller here.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef INTENSITY_CFG_H_
+#define INTENSITY_CFG_H_
+
+/* Sensor readings the controller trusts, in C (both included). A reading
+ * outside of them selects ERROR. */
+#define INTENSITY_SENSOR_MIN_C          (5)
+#define INTENSITY_SENSOR_MAX_C          (40)
+
+/* Smallest error (desired - current, in whole C) that selects each
+ * intensity, rising. A smaller error selects INTENSITYOFF. */
+#define INTENSITY_LOW_FROM_C            (2)
+#define INTENSITY_MEDIUM_FROM_C         (5)
+#define INTENSITY_HIGH_FROM_C           (10)
+
+/* Highest desired temperature (the HIGH level of UserHeatInput), in C */
+#define INTENSITY_DESIRED_MAX_C         (35)
+
+/* A lower intensity is only selected once the error is this far (0.1 C)
+ * below the band edge it crossed, rising edges are not moved */
+#define INTENSITY_HYSTERESIS_TENTHS     (5)
+
+/* Smallest time an intensity is kept before the next change. ERROR and the
+ * first decision after a level change are applied at once. */
+#define INTENSITY_MIN_DWELL_MS          (2000UL)
+
+#endif /* INTENSITY_CFG_H_ */
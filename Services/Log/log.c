@@ -0,0 +1,184 @@
+ /******************************************************************************
+ *
+ * Module: Log
+ *
+ * File Name: log.c
+ *
+ * Description: Source file for the deferred tokenized logger. Call sites only
+ *              copy a message identifier and its arguments into a RAM buffer,
+ *              the logger task packs the records (arguments as base-128
+ *              varints) into telemetry frames later, at low priority.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#include "log.h"
+#include "telemetry.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define LOG_INDEX_MASK              (LOG_BUFFER_WORDS - 1U)
+
+/* Identifier, argument count and up to five bytes per argument */
+#define LOG_RECORD_MAX_BYTES        (2U + (5U * LOG_MAX_ARGS))
+
+#if (LOG_RECORD_MAX_BYTES > TELEMETRY_BODY_MAX)
+#error "The largest log record must fit in one telemetry frame"
+#endif
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+/* Records: one word (identifier << 8 | argument count) then the arguments */
+static uint32 ulBuffer[LOG_BUFFER_WORDS];
+static volatile uint32 ulHead = 0;         /* Free running, written by Log_Write() */
+static volatile uint32 ulTail = 0;         /* Free running, written by the logger */
+
+static volatile uint32 ulDropped = 0;
+static uint32 ulDroppedReported = 0;
+
+static TaskHandle_t xLoggerTask = NULL;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static uint8 prvPutVarint(uint32 ulValue, uint8 *pucOut)
+{
+    uint8 ucLength = 0;
+
+    while (ulValue >= 0x80U)
+    {
+        pucOut[ucLength++] = (uint8)(ulValue | 0x80U);
+        ulValue >>= 7;
+    }
+    pucOut[ucLength++] = (uint8)ulValue;
+
+    return ucLength;
+}
+
+/* Encode the record at the tail without consuming it */
+static uint8 prvEncodeRecord(uint8 *pucOut, uint32 *pulWords)
+{
+    uint32 ulHeader = ulBuffer[ulTail & LOG_INDEX_MASK];
+    uint8 ucArgs = (uint8)(ulHeader & 0xFF);
+    uint8 ucLength = 0;
+    uint8 ucArg;
+
+    pucOut[ucLength++] = (uint8)(ulHeader >> 8);
+    pucOut[ucLength++] = ucArgs;
+    for (ucArg = 0; ucArg < ucArgs; ucArg++)
+    {
+        ucLength += prvPutVarint(ulBuffer[(ulTail + 1U + ucArg) & LOG_INDEX_MASK], &pucOut[ucLength]);
+    }
+    *pulWords = 1U + ucArgs;
+
+    return ucLength;
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void Log_Write(LogId eId, uint8 ucArgs, const uint32 *pulArgs)
+{
+    boolean bWasEmpty;
+    uint8 ucArg;
+
+    if (ucArgs > LOG_MAX_ARGS)
+    {
+        ucArgs = LOG_MAX_ARGS;
+    }
+
+    taskENTER_CRITICAL();
+    if ((LOG_BUFFER_WORDS - (ulHead - ulTail)) < (1U + ucArgs))
+    {
+        ulDropped++;
+        taskEXIT_CRITICAL();
+        return;
+    }
+    bWasEmpty = (ulHead == ulTail) ? TRUE : FALSE;
+    ulBuffer[ulHead & LOG_INDEX_MASK] = ((uint32)eId << 8) | ucArgs;
+    for (ucArg = 0; ucArg < ucArgs; ucArg++)
+    {
+        ulBuffer[(ulHead + 1U + ucArg) & LOG_INDEX_MASK] = pulArgs[ucArg];
+    }
+    ulHead += 1U + ucArgs;
+    taskEXIT_CRITICAL();
+
+    if ((bWasEmpty == TRUE) && (xLoggerTask != NULL))
+    {
+        xTaskNotifyGive(xLoggerTask);
+    }
+}
+
+void Log_WaitPending(void)
+{
+    xLoggerTask = xTaskGetCurrentTaskHandle();
+
+    /* Records written before the handle was known did not notify */
+    if (Log_IsPending() == FALSE)
+    {
+        (void) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
+
+boolean Log_IsPending(void)
+{
+    return ((ulHead != ulTail) || (ulDropped != ulDroppedReported)) ? TRUE : FALSE;
+}
+
+void Log_SendFrame(void)
+{
+    uint8 ucBody[TELEMETRY_BODY_MAX];
+    uint8 ucRecord[LOG_RECORD_MAX_BYTES];
+    uint8 ucLength = 0;
+    uint8 ucRecordLength, ucIndex;
+    uint32 ulDroppedNow, ulWords;
+
+    ulDroppedNow = ulDropped;
+    if (ulDroppedNow != ulDroppedReported)
+    {
+        ucBody[ucLength++] = (uint8)LOG_DROPPED;
+        ucBody[ucLength++] = 1;
+        ucLength += prvPutVarint(ulDroppedNow - ulDroppedReported, &ucBody[ucLength]);
+        ulDroppedReported = ulDroppedNow;
+    }
+
+    /* Only the logger moves the tail, the records cannot change under it */
+    while (ulHead != ulTail)
+    {
+        ucRecordLength = prvEncodeRecord(ucRecord, &ulWords);
+        if ((ucLength + ucRecordLength) > TELEMETRY_BODY_MAX)
+        {
+            break;
+        }
+        for (ucIndex = 0; ucIndex < ucRecordLength; ucIndex++)
+        {
+            ucBody[ucLength++] = ucRecord[ucIndex];
+        }
+        ulTail += ulWords;
+    }
+
+    if (ucLength > 0)
+    {
+        (void) Telemetry_SendFrame(TELEMETRY_TYPE_LOG, ucBody, ucLength);
+    }
+}
+
+void Log_Discard(void)
+{
+    ulDroppedReported = ulDropped;
+    ulTail = ulHead;
+}
+
+uint32 Log_GetDropped(void)
+{
+    return ulDropped;
+}
@@ -0,0 +1,73 @@
+ /******************************************************************************
+ *
+ * Module: Log
+ *
+ * File Name: log.h
+ *
+ * Description: Header file for the deferred tokenized logger
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef LOG_H_
+#define LOG_H_
+
+#include "std_types.h"
+#include "log_messages.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Size of the record buffer in 32-bit words, a record takes one word plus
+ * one per argument. Must be a power of two. */
+#define LOG_BUFFER_WORDS            (256U)
+
+#define LOG_MAX_ARGS                (9U)
+
+/* Log a message with up to LOG_MAX_ARGS arguments (at least one), e.g.
+ * LOG(LOG_CPU_LOAD, ucLoad, ulMHz, ulSwitches). Only the identifier and the
+ * arguments are stored, from task context only. */
+#define LOG(eId, ...) \
+    do \
+    { \
+        const uint32 ulLogArgs_[] = { __VA_ARGS__ }; \
+        Log_Write((eId), (uint8)(sizeof(ulLogArgs_) / sizeof(uint32)), ulLogArgs_); \
+    } while (0)
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+#define LOG_ID_ENTRY(eId, pcFormat)  eId,
+
+typedef enum
+{
+    LOG_MESSAGES(LOG_ID_ENTRY)
+    LOG_MESSAGES_COUNT
+}LogId;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Store a record, it is dropped (and counted) if the buffer is full */
+extern void Log_Write(LogId eId, uint8 ucArgs, const uint32 *pulArgs);
+
+/* Block the calling task (the logger) until records are pending */
+extern void Log_WaitPending(void);
+
+extern boolean Log_IsPending(void);
+
+/* Queue as many pending records as fit in one telemetry frame to the UART
+ * gatekeeper, blocks while its FIFO is full */
+extern void Log_SendFrame(void);
+
+/* Drop the pending records (a terminal that cannot take the binary frames),
+ * they are not counted as dropped */
+extern void Log_Discard(void);
+
+extern uint32 Log_GetDropped(void);
+
+#endif /* LOG_H_ */
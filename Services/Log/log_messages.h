@@ -0,0 +1,38 @@
+ /******************************************************************************
+ *
+ * Module: Log
+ *
+ * File Name: log_messages.h
+ *
+ * Description: Dictionary of the tokenized log messages. The firmware only
+ *              keeps the identifiers, the format strings are read from this
+ *              file by Tools/telemetry to rebuild the text on the host.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef LOG_MESSAGES_H_
+#define LOG_MESSAGES_H_
+
+/* X(identifier, "format"), the identifier is the position in this list so
+ * only append new messages or bump TELEMETRY_VERSION. One message per line.
+ *
+ * Every argument is a 32-bit value, the conversions are:
+ *   %u unsigned  %d signed  %x hexadecimal  %t tenths shown as "x.y"
+ *   %e{A|B|...} the value selects one of the names
+ *   %% a percent sign */
+#define LOG_MESSAGES(X) \
+    X(LOG_DROPPED, "Log: %u records dropped") \
+    X(LOG_CPU_LOAD, "CPU Load is %u%% at %u MHz, clock switches %u") \
+    X(LOG_TASK_TIMING, "%e{ReadTempForDriver|ReadTempForPassenger|ControlTempForDriver|ControlTempForPassenger|RunTimeMeasurements}: phase %u releases %u misses %u late %t..%t resp %t") \
+    X(LOG_TASK_LATENESS, "%e{ReadTempForDriver|ReadTempForPassenger|ControlTempForDriver|ControlTempForPassenger|RunTimeMeasurements}: hist %u %u %u %u %u %u %u %u") \
+    X(LOG_SLEEP_STATS, "Sleep: %u sleeps %u ticks suppressed %u timer/%u early wakeups %u aborted latency max %u avg %u ns") \
+    X(LOG_DEEP_SLEEP_STATS, "Deep sleep: %u entries wake-to-output last %t max %t") \
+    X(LOG_SAMPLING_STATS, "%e{Driver|Passenger} %e{fast|slow}: %u s CPU %u%% ADC %t/s UART %u%%") \
+    X(LOG_DISPLAY_STATS, "%e{Driver|Passenger} display: %u keyframes %u updates %u unchanged %u deferred") \
+    X(LOG_INTENSITY_STATS, "%e{Driver|Passenger} intensity: %u changes (%u last min) bands alone %u (%u last min) %u held") \
+    X(LOG_PROFILE_STATS, "%e{Driver|Passenger} profile: %u boosts %u ended early, comfort after %t s") \
+    X(LOG_DTC_STATS, "DTC: %u confirmed now, %u confirmed %u aged in %u reports, max %u cycles")
+
+#endif /* LOG_MESSAGES_H_ */
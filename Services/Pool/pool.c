@@ -0,0 +1,77 @@
+ /******************************************************************************
+ *
+ * Module: Pool
+ *
+ * File Name: pool.c
+ *
+ * Description: Source file for the fixed-block memory pools. Every pool is a
+ *              static array of same-sized blocks with a free list threaded
+ *              through the free blocks, so taking or giving back a block is
+ *              a pointer swap with interrupts masked for a few instructions.
+ *              A filled block is handed to its consumer by pointer instead of
+ *              being copied into a queue.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#include "pool.h"
+#include "task.h"
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void Pool_Init(Pool *pxPool)
+{
+    uint32 ulWords = pxPool->usBlockSize / sizeof(uint32);
+    uint16 usBlock;
+
+    pxPool->pvFree = NULL_PTR;
+    for (usBlock = pxPool->usBlocks; usBlock > 0; usBlock--)
+    {
+        *(void **) &pxPool->pulStorage[(usBlock - 1U) * ulWords] = pxPool->pvFree;
+        pxPool->pvFree = &pxPool->pulStorage[(usBlock - 1U) * ulWords];
+    }
+    pxPool->usUsed = 0;
+}
+
+void *Pool_Alloc(Pool *pxPool)
+{
+    UBaseType_t uxSavedMask;
+    void *pvBlock;
+
+    /* The masking variant of the ISR API also nests in a task */
+    uxSavedMask = portSET_INTERRUPT_MASK_FROM_ISR();
+    pvBlock = pxPool->pvFree;
+    if (pvBlock != NULL_PTR)
+    {
+        pxPool->pvFree = *(void **) pvBlock;
+        pxPool->usUsed++;
+        if (pxPool->usUsed > pxPool->usHighWater)
+        {
+            pxPool->usHighWater = pxPool->usUsed;
+        }
+    }
+    else
+    {
+        pxPool->ulFailures++;
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxSavedMask);
+
+    return pvBlock;
+}
+
+void Pool_Free(Pool *pxPool, void *pvBlock)
+{
+    UBaseType_t uxSavedMask;
+
+    configASSERT(((uint32 *) pvBlock >= pxPool->pulStorage) &&
+                 ((uint32 *) pvBlock < &pxPool->pulStorage[(pxPool->usBlockSize / sizeof(uint32)) * pxPool->usBlocks]));
+
+    uxSavedMask = portSET_INTERRUPT_MASK_FROM_ISR();
+    *(void **) pvBlock = pxPool->pvFree;
+    pxPool->pvFree = pvBlock;
+    pxPool->usUsed--;
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxSavedMask);
+}
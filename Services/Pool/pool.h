@@ -0,0 +1,63 @@
+ /******************************************************************************
+ *
+ * Module: Pool
+ *
+ * File Name: pool.h
+ *
+ * Description: Header file for the fixed-block memory pools
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef POOL_H_
+#define POOL_H_
+
+#include "FreeRTOS.h"
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Blocks are whole words, so any block holds the free list link and is word aligned */
+#define POOL_BLOCK_WORDS(BLOCK_SIZE)    (((BLOCK_SIZE) + sizeof(uint32) - 1U) / sizeof(uint32))
+
+/* Define a pool at file scope, its storage is reserved at build time:
+ * POOL_DEFINE(xMessagePool, sizeof(Message), 8); then Pool_Init(&xMessagePool) */
+#define POOL_DEFINE(NAME, BLOCK_SIZE, BLOCKS)                                           \
+    static uint32 NAME##Storage[(BLOCKS) * POOL_BLOCK_WORDS(BLOCK_SIZE)];              \
+    Pool NAME = { #NAME, NAME##Storage, NULL_PTR,                                      \
+                  (uint16) (POOL_BLOCK_WORDS(BLOCK_SIZE) * sizeof(uint32)), (BLOCKS), 0, 0, 0 }
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct
+{
+    const char *pcName;
+    uint32 *pulStorage;
+    void *pvFree;                   /* Free blocks linked through their first word */
+    uint16 usBlockSize;             /* Bytes */
+    uint16 usBlocks;
+    uint16 usUsed;
+    uint16 usHighWater;             /* Most blocks ever used at once */
+    uint32 ulFailures;              /* Allocations that found the pool empty */
+}Pool;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Call before the scheduler starts */
+extern void Pool_Init(Pool *pxPool);
+
+/* Take a block, NULL_PTR when the pool is empty. O(1), from tasks and from
+ * interrupts at or below configMAX_SYSCALL_INTERRUPT_PRIORITY. A block can be
+ * freed by another task or interrupt than the one that took it. */
+extern void *Pool_Alloc(Pool *pxPool);
+
+extern void Pool_Free(Pool *pxPool, void *pvBlock);
+
+#endif /* POOL_H_ */
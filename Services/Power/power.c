@@ -0,0 +1,306 @@
+ /******************************************************************************
+ *
+ * Module: Power
+ *
+ * File Name: power.c
+ *
+ * Description: Source file for the tickless idle and power state manager service.
+ *              When the Idle task finds nothing to run for a few ticks, SysTick
+ *              is stopped and WTimer1 is armed to wake the core just before the
+ *              next task must unblock. On wake-up the time actually slept is read
+ *              back from WTimer1 with system clock resolution, the kernel tick
+ *              count is stepped by the whole ticks that passed and SysTick is
+ *              restarted so the next tick keeps its original phase.
+ *              When all seats are OFF the periodic tasks park on an event group,
+ *              nothing is left waiting on time and the Idle task puts the core in
+ *              deep sleep with only the seat buttons clocked. The kernel time is
+ *              frozen in deep sleep, parked tasks restart their releases from the
+ *              wake-up tick.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#include "power.h"
+#include "GPTM.h"
+#include "uart0.h"
+#include "tm4c123gh6pm_registers.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define SYSTICK_ENABLE_MASK             (0x00000001)
+#define SYSTICK_INT_ENABLE_MASK         (0x00000002)
+#define SYSTICK_CLK_SOURCE_MASK         (0x00000004)
+#define SYSTICK_START_MASK              (SYSTICK_ENABLE_MASK | SYSTICK_INT_ENABLE_MASK | SYSTICK_CLK_SOURCE_MASK)
+
+#define NVIC_PENDSTSET_MASK             (1UL << 26)
+#define NVIC_PENDSTCLR_MASK             (1UL << 25)
+
+#define SCB_SLEEPDEEP_MASK              (0x00000004)
+#define SYSCTL_RCC_ACG_MASK             (1UL << 27)
+
+#define POWER_ACTIVE_BIT                (1UL << 0UL)
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static PowerStats xStats = {0};
+
+static volatile PowerState xState = POWER_STATE_ACTIVE;
+static EventGroupHandle_t xPowerEvents;
+static TickType_t xWakeTick = 0;
+
+/* WTimer0 time of the button that woke the system, until the first control output */
+static volatile uint32 ulWakeTimestamp = 0;
+static volatile boolean bWakeMeasuring = FALSE;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+/* Called with interrupts masked when no task waits on time. SysTick is only
+ * paused: the tick period in progress is stretched by the time slept. */
+static void prvDeepSleep(void)
+{
+    SYSTICK_CTRL_REG &= ~SYSTICK_ENABLE_MASK;
+
+    NVIC_SYSTEM_SYSCTRL |= SCB_SLEEPDEEP_MASK;
+    __asm("    dsb");
+    __asm("    wfi");
+    __asm("    isb");
+    NVIC_SYSTEM_SYSCTRL &= ~SCB_SLEEPDEEP_MASK;
+
+    SYSTICK_CTRL_REG |= SYSTICK_ENABLE_MASK;
+    xStats.ulDeepSleeps++;
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void Power_Init(void)
+{
+    GPTM_WTimer1Init();
+
+    /* Let the sleep and deep sleep clock gating registers take effect */
+    SYSCTL_SCGCGPIO_REG = POWER_SLEEP_GPIO_CLOCKS;
+    SYSCTL_SCGCUART_REG = POWER_SLEEP_UART_CLOCKS;
+    SYSCTL_SCGCWTIMER_REG = POWER_SLEEP_WTIMER_CLOCKS;
+    SYSCTL_SCGCADC_REG = 0;
+    SYSCTL_SCGCEEPROM_REG = POWER_SLEEP_EEPROM_CLOCKS;
+    SYSCTL_DCGCGPIO_REG = POWER_DEEP_SLEEP_GPIO_CLOCKS;
+    SYSCTL_DCGCUART_REG = 0;
+    SYSCTL_DCGCWTIMER_REG = 0;
+    SYSCTL_DCGCADC_REG = 0;
+    SYSCTL_DCGCEEPROM_REG = 0;
+    SYSCTL_DSLPCLKCFG_REG = POWER_DEEP_SLEEP_CLOCK_PIOSC;
+    SYSCTL_RCC_REG |= SYSCTL_RCC_ACG_MASK;
+
+    xPowerEvents = xEventGroupCreate();
+    xEventGroupSetBits(xPowerEvents, POWER_ACTIVE_BIT);
+}
+
+void Power_UpdateSeatLevels(UserHeatInput eDriver, UserHeatInput ePassenger)
+{
+    if ((eDriver == OFF) && (ePassenger == OFF))
+    {
+        if (xState == POWER_STATE_ACTIVE)
+        {
+            /* The tasks finish the job in progress, so the heaters see OFF before parking */
+            xState = POWER_STATE_DEEP_SLEEP;
+            xEventGroupClearBits(xPowerEvents, POWER_ACTIVE_BIT);
+        }
+    }
+    else if (xState == POWER_STATE_DEEP_SLEEP)
+    {
+        xWakeTick = xTaskGetTickCount();
+        xState = POWER_STATE_ACTIVE;
+        xEventGroupSetBits(xPowerEvents, POWER_ACTIVE_BIT);
+    }
+}
+
+boolean Power_WaitActive(TickType_t *pxWakeTick)
+{
+    if (xEventGroupGetBits(xPowerEvents) & POWER_ACTIVE_BIT)
+    {
+        return FALSE;
+    }
+
+    xEventGroupWaitBits(xPowerEvents, POWER_ACTIVE_BIT, pdFALSE, pdTRUE, portMAX_DELAY);
+    *pxWakeTick = xWakeTick;
+    return TRUE;
+}
+
+void Power_SeatButtonFromISR(void)
+{
+    if ((xState == POWER_STATE_DEEP_SLEEP) && (bWakeMeasuring == FALSE))
+    {
+        ulWakeTimestamp = GPTM_WTimer0Read();
+        bWakeMeasuring = TRUE;
+    }
+}
+
+void Power_ControlOutput(void)
+{
+    uint32 ulLatency;
+
+    if (bWakeMeasuring && (xState == POWER_STATE_ACTIVE))
+    {
+        ulLatency = GPTM_WTimer0Read() - ulWakeTimestamp;
+        bWakeMeasuring = FALSE;
+        xStats.ulWakeToOutput = ulLatency;
+        if (ulLatency > xStats.ulMaxWakeToOutput)
+        {
+            xStats.ulMaxWakeToOutput = ulLatency;
+        }
+    }
+}
+
+PowerState Power_GetState(void)
+{
+    return xState;
+}
+
+const PowerStats *Power_GetStats(void)
+{
+    return &xStats;
+}
+
+/* Replaces the weak SysTick based implementation of the port (configUSE_TICKLESS_IDLE 2).
+ * Called by the Idle task with the scheduler suspended. */
+void vPortSuppressTicksAndSleep(TickType_t xExpectedIdleTime)
+{
+    uint32 ulRemaining, ulSleepCounts, ulCounter, ulElapsed, ulLatency, ulSinceTick, ulCompleteTicks, ulReload;
+    boolean bTickPending = FALSE;
+    boolean bTimedOut;
+    /* With no delayed task the next unblock time is portMAX_DELAY */
+    boolean bDeepSleep = (xState == POWER_STATE_DEEP_SLEEP) &&
+                         ((xTaskGetTickCount() + xExpectedIdleTime) == portMAX_DELAY);
+
+    if (bDeepSleep && UART0_IsBusy())
+    {
+        /* Let the last byte leave before the UART clock is gated */
+        bDeepSleep = FALSE;
+        xExpectedIdleTime = POWER_UART_DRAIN_TICKS;
+    }
+    if (xExpectedIdleTime > POWER_MAX_SUPPRESSED_TICKS)
+    {
+        xExpectedIdleTime = POWER_MAX_SUPPRESSED_TICKS;
+    }
+
+    /* Interrupts are masked with PRIMASK so they still wake the core from WFI
+     * but are not serviced until the kernel time is corrected */
+    __asm("    cpsid i");
+    __asm("    dsb");
+    __asm("    isb");
+
+    if (eTaskConfirmSleepModeStatus() == eAbortSleep)
+    {
+        xStats.ulAborted++;
+        __asm("    cpsie i");
+        return;
+    }
+
+    if (bDeepSleep)
+    {
+        prvDeepSleep();
+        __asm("    cpsie i");
+        return;
+    }
+
+    /* Stop SysTick and take the counts left until the tick it was heading to */
+    SYSTICK_CTRL_REG &= ~SYSTICK_ENABLE_MASK;
+    ulRemaining = SYSTICK_CURRENT_REG;
+    if (ulRemaining == 0)
+    {
+        ulRemaining = POWER_COUNTS_PER_TICK;
+    }
+    /* A tick that expired after interrupts were masked has not been counted yet,
+     * it is accounted for by stepping one more tick after the sleep */
+    if (NVIC_SYSTEM_INTCTRL & NVIC_PENDSTSET_MASK)
+    {
+        NVIC_SYSTEM_INTCTRL = NVIC_PENDSTCLR_MASK;
+        bTickPending = TRUE;
+    }
+
+    ulSleepCounts = ulRemaining + (POWER_COUNTS_PER_TICK * (xExpectedIdleTime - 1UL));
+    if (bTickPending)
+    {
+        ulSleepCounts = (ulSleepCounts > POWER_COUNTS_PER_TICK) ? (ulSleepCounts - POWER_COUNTS_PER_TICK) : 1;
+    }
+    GPTM_WTimer1Start(ulSleepCounts);
+
+    /* configPRE_SLEEP_PROCESSING() may clear the counts when it already slept */
+    configPRE_SLEEP_PROCESSING(ulSleepCounts);
+    if (ulSleepCounts > 0)
+    {
+        __asm("    dsb");
+        __asm("    wfi");
+        __asm("    isb");
+    }
+    configPOST_SLEEP_PROCESSING(ulSleepCounts);
+
+    /* WTimer1 reloads and keeps counting after a time-out, so the counter
+     * tells both how long the core slept and how late it woke up. The status is
+     * read on both sides of the counter so a time-out in between is not missed. */
+    bTimedOut = GPTM_WTimer1TimedOut();
+    ulCounter = GPTM_WTimer1Read();
+    if ((bTimedOut == FALSE) && GPTM_WTimer1TimedOut())
+    {
+        bTimedOut = TRUE;
+        ulCounter = GPTM_WTimer1Read();
+    }
+    GPTM_WTimer1Stop();
+
+    if (bTimedOut)
+    {
+        ulLatency = ulSleepCounts - ulCounter;
+        ulElapsed = ulSleepCounts + ulLatency;
+        /* In nanoseconds, the clock may differ from one sleep to the next */
+        ulLatency = (ulLatency * 1000UL) / POWER_COUNTS_PER_US;
+        xStats.ulTimerWakeups++;
+        xStats.ulTotalWakeLatency += ulLatency;
+        if (ulLatency > xStats.ulMaxWakeLatency)
+        {
+            xStats.ulMaxWakeLatency = ulLatency;
+        }
+    }
+    else
+    {
+        ulElapsed = ulSleepCounts - ulCounter;
+        xStats.ulEarlyWakeups++;
+    }
+    ulElapsed += POWER_STOPPED_TIMER_COMPENSATION;
+    xStats.ulSleepTime += ulElapsed / POWER_COUNTS_PER_US;
+
+    /* Whole ticks since the last tick the kernel counted, the rest is carried
+     * into the first SysTick period so the tick phase is preserved */
+    ulSinceTick = (POWER_COUNTS_PER_TICK - ulRemaining) + ulElapsed;
+    ulCompleteTicks = (ulSinceTick / POWER_COUNTS_PER_TICK) + (bTickPending ? 1 : 0);
+    ulReload = POWER_COUNTS_PER_TICK - (ulSinceTick % POWER_COUNTS_PER_TICK);
+    /* A tick due sooner than SysTick can be restarted is counted now instead */
+    if (ulReload <= POWER_STOPPED_TIMER_COMPENSATION)
+    {
+        ulReload += POWER_COUNTS_PER_TICK;
+        ulCompleteTicks++;
+    }
+    if (ulCompleteTicks > xExpectedIdleTime)
+    {
+        ulCompleteTicks = xExpectedIdleTime;
+    }
+
+    SYSTICK_RELOAD_REG = ulReload - 1UL;
+    SYSTICK_CURRENT_REG = 0;
+    SYSTICK_CTRL_REG |= SYSTICK_START_MASK;
+    SYSTICK_RELOAD_REG = POWER_COUNTS_PER_TICK - 1UL;
+
+    vTaskStepTick(ulCompleteTicks);
+    xStats.ulSleeps++;
+    xStats.ulSuppressedTicks += ulCompleteTicks;
+
+    /* Service the interrupt that ended the sleep */
+    __asm("    cpsie i");
+}
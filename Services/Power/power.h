@@ -0,0 +1,108 @@
+ /******************************************************************************
+ *
+ * Module: Power
+ *
+ * File Name: power.h
+ *
+ * Description: Header file for the tickless idle and power state manager service
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef POWER_H_
+#define POWER_H_
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "event_groups.h"
+#include "std_types.h"
+#include "clock.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* SysTick and WTimer1 are both clocked by the system clock, owned by the clock manager */
+#define POWER_COUNTS_PER_TICK           (Clock_GetFrequency() / configTICK_RATE_HZ)
+#define POWER_COUNTS_PER_US             (Clock_GetFrequency() / 1000000UL)
+
+/* Longest sleep in ticks, keeps the WTimer1 reload far from overflowing */
+#define POWER_MAX_SUPPRESSED_TICKS      (1000U)
+
+/* System clock counts lost while neither SysTick nor WTimer1 is counting:
+ * from stopping SysTick until WTimer1 starts plus from reading WTimer1 until
+ * SysTick restarts. Added to every sleep so the kernel time does not drift. */
+#define POWER_STOPPED_TIMER_COMPENSATION  (40U)
+
+/* Ticks slept at a time while the UART finishes the last byte before deep sleep */
+#define POWER_UART_DRAIN_TICKS          (2U)
+
+/* Peripherals kept clocked while the core sleeps in the Idle task (SCGC):
+ * GPIO A (UART0 pins), B, E (ADC pins) and F, UART0, WTimer0, WTimer1,
+ * WTimer2 (heater slots) and the EEPROM, which programs a word while the
+ * store task sleeps.
+ * The ADC is only used while a task busy-waits on it so it is gated. */
+#define POWER_SLEEP_GPIO_CLOCKS         (0x33U)
+#define POWER_SLEEP_UART_CLOCKS         (0x01U)
+#define POWER_SLEEP_WTIMER_CLOCKS       (0x07U)
+#define POWER_SLEEP_EEPROM_CLOCKS       (0x01U)
+
+/* Peripherals kept clocked in deep sleep (DCGC): only the seat buttons on
+ * GPIO B and F, they are the wake-up source */
+#define POWER_DEEP_SLEEP_GPIO_CLOCKS    (0x22U)
+
+/* Deep sleep clock source: precision internal oscillator, PLL and main oscillator unused */
+#define POWER_DEEP_SLEEP_CLOCK_PIOSC    (0x10U)
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef enum
+{
+    POWER_STATE_ACTIVE,         /* Sensing and control pipeline running */
+    POWER_STATE_DEEP_SLEEP      /* All seats OFF: pipeline parked, core in deep sleep until a seat button */
+}PowerState;
+
+typedef struct
+{
+    uint32 ulSleeps;                /* Times the tick interrupt was suppressed */
+    uint32 ulAborted;               /* Sleeps cancelled because a task became ready */
+    uint32 ulSuppressedTicks;       /* Ticks the kernel was stepped by instead of interrupted */
+    uint32 ulTimerWakeups;          /* Sleeps ended by WTimer1 at the expected idle time */
+    uint32 ulEarlyWakeups;          /* Sleeps ended early by another interrupt */
+    uint32 ulMaxWakeLatency;        /* Nanoseconds from WTimer1 time-out until the core ran */
+    uint32 ulTotalWakeLatency;      /* Sum over all timer wakeups, for the average */
+    uint32 ulSleepTime;             /* Microseconds slept in the tickless idle, wraps around */
+    uint32 ulDeepSleeps;            /* Times the core entered deep sleep */
+    uint32 ulWakeToOutput;          /* Last seat button wake-up to first control output in 0.1 ms */
+    uint32 ulMaxWakeToOutput;
+}PowerStats;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Call before the scheduler starts */
+extern void Power_Init(void);
+
+/* Call whenever the desired seat levels change, parks the pipeline when all are OFF */
+extern void Power_UpdateSeatLevels(UserHeatInput eDriver, UserHeatInput ePassenger);
+
+/* Called by the tasks of the sensing and control pipeline between two jobs.
+ * Blocks while the system is in deep sleep and returns TRUE with the tick of
+ * the wake-up in pxWakeTick if it did. */
+extern boolean Power_WaitActive(TickType_t *pxWakeTick);
+
+/* Must be called from the seat button interrupts */
+extern void Power_SeatButtonFromISR(void);
+
+/* Call after the heater outputs are driven, measures the wake-up latency */
+extern void Power_ControlOutput(void);
+
+extern PowerState Power_GetState(void);
+
+extern const PowerStats *Power_GetStats(void);
+
+#endif /* POWER_H_ */
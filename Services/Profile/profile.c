@@ -0,0 +1,121 @@
+ /******************************************************************************
+ *
+ * Module: Profile
+ *
+ * File Name: profile.c
+ *
+ * Description: Source file for the boost and preheat profile engine. The
+ *              bands lower the intensity well before the desired level, so
+ *              a seat creeps up to it on low power. A profile holds a fixed
+ *              intensity for the first seconds after a level change, e.g.
+ *              full power, then hands the seat to the bands. It is stepped
+ *              by the controller release of the seat, no task or timer of
+ *              its own.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#include "profile.h"
+#include "task.h"
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static const ProfileStep xLowSteps[PROFILE_MAX_STEPS] = PROFILE_STEPS_LOW;
+static const ProfileStep xMediumSteps[PROFILE_MAX_STEPS] = PROFILE_STEPS_MEDIUM;
+static const ProfileStep xHighSteps[PROFILE_MAX_STEPS] = PROFILE_STEPS_HIGH;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static const ProfileStep *prvSteps(UserHeatInput eDesired)
+{
+    switch (eDesired)
+    {
+    case LOW:
+        return xLowSteps;
+    case MEDIUM:
+        return xMediumSteps;
+    case HIGH:
+        return xHighSteps;
+    default:
+        return NULL_PTR;
+    }
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void Profile_InitSeat(ProfileSeat *pxSeat)
+{
+    pxSeat->eDesired = OFF;
+    pxSeat->ucStep = PROFILE_MAX_STEPS;
+    pxSeat->xStepStart = xTaskGetTickCount();
+    pxSeat->xLevelSet = pxSeat->xStepStart;
+    pxSeat->bTiming = FALSE;
+    pxSeat->ulBoosts = 0;
+    pxSeat->ulEarlyExits = 0;
+    pxSeat->ulTimeToComfort = 0;
+}
+
+HeatIntensity Profile_Evaluate(ProfileSeat *pxSeat, UserHeatInput eDesired, Temperature xCurrent,
+                               HeatIntensity eBands)
+{
+    TickType_t xNow = xTaskGetTickCount();
+    const ProfileStep *pxSteps = prvSteps(eDesired);
+    Temperature xError = TEMPERATURE_FROM_C(eDesired) - xCurrent;
+    TickType_t xDuration;
+
+    /* Every level change starts the profile of the new level */
+    if (eDesired != pxSeat->eDesired)
+    {
+        pxSeat->eDesired = eDesired;
+        pxSeat->ucStep = 0;
+        pxSeat->xStepStart = xNow;
+        pxSeat->xLevelSet = xNow;
+        pxSeat->bTiming = (eDesired != OFF) ? TRUE : FALSE;
+        if ((pxSteps != NULL_PTR) && (pxSteps[0].ucIntensity != PROFILE_BANDS))
+        {
+            pxSeat->ulBoosts++;
+        }
+    }
+
+    if (eBands == ERROR)
+    {
+        pxSeat->ucStep = PROFILE_MAX_STEPS;
+        return ERROR;
+    }
+
+    if ((pxSeat->bTiming == TRUE) && (xError < TEMPERATURE_FROM_C(PROFILE_COMFORT_C)))
+    {
+        pxSeat->ulTimeToComfort = (xNow - pxSeat->xLevelSet) * portTICK_PERIOD_MS;
+        pxSeat->bTiming = FALSE;
+    }
+
+    while ((pxSteps != NULL_PTR) && (pxSeat->ucStep < PROFILE_MAX_STEPS) &&
+           (pxSteps[pxSeat->ucStep].ucIntensity != PROFILE_BANDS))
+    {
+        if (xError < TEMPERATURE_FROM_C(PROFILE_EXIT_C))
+        {
+            pxSeat->ulEarlyExits++;
+            break;
+        }
+
+        xDuration = pdMS_TO_TICKS((uint32) pxSteps[pxSeat->ucStep].usSeconds * 1000UL);
+        if ((xNow - pxSeat->xStepStart) < xDuration)
+        {
+            return (HeatIntensity) pxSteps[pxSeat->ucStep].ucIntensity;
+        }
+
+        /* Steps follow each other on time even if a release came late */
+        pxSeat->xStepStart += xDuration;
+        pxSeat->ucStep++;
+    }
+
+    pxSeat->ucStep = PROFILE_MAX_STEPS;
+    return eBands;
+}
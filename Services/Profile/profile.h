@@ -0,0 +1,74 @@
+ /******************************************************************************
+ *
+ * Module: Profile
+ *
+ * File Name: profile.h
+ *
+ * Description: Header file for the boost and preheat profile engine
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+#include "FreeRTOS.h"
+#include "std_types.h"
+#include "temperature.h"
+#include "intensity_cfg.h"
+#include "profile_cfg.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define PROFILE_MAX_STEPS               (4U)
+
+/* Step intensity that hands the seat to the intensity bands */
+#define PROFILE_BANDS                   (0xFFU)
+
+/* The comfort temperature is reached where the bands switch the heater off */
+#define PROFILE_COMFORT_C               (INTENSITY_LOW_FROM_C)
+
+#if (PROFILE_EXIT_C < PROFILE_COMFORT_C)
+#error "The profile steps in profile_cfg.h must end by the comfort temperature"
+#endif
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint16 usSeconds;
+    uint8 ucIntensity;              /* HeatIntensity, or PROFILE_BANDS */
+}ProfileStep;
+
+/* Profile of one seat */
+typedef struct
+{
+    UserHeatInput eDesired;         /* Level the profile runs for */
+    uint8 ucStep;                   /* PROFILE_MAX_STEPS once the bands control the seat */
+    TickType_t xStepStart;
+    TickType_t xLevelSet;           /* Tick of the last level change */
+    boolean bTiming;                /* Comfort not reached yet since the level change */
+    uint32 ulBoosts;                /* Profiles started with at least one step */
+    uint32 ulEarlyExits;            /* Profiles ended by PROFILE_EXIT_C */
+    uint32 ulTimeToComfort;         /* Last level change to comfort, in ms */
+}ProfileSeat;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+extern void Profile_InitSeat(ProfileSeat *pxSeat);
+
+/* Intensity for a seat in the controller release: the step of its level
+ * profile, or eBands (the intensity decision) after the last step. A sensor
+ * fault (eBands is ERROR) ends the profile. At most PROFILE_MAX_STEPS steps
+ * are looked at. */
+extern HeatIntensity Profile_Evaluate(ProfileSeat *pxSeat, UserHeatInput eDesired, Temperature xCurrent,
+                                      HeatIntensity eBands);
+
+#endif /* PROFILE_H_ */
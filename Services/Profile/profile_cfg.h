@@ -0,0 +1,31 @@
+ /******************************************************************************
+ *
+ * Module: Profile
+ *
+ * File Name: profile_cfg.h
+ *
+ * Description: Heat profiles of the seat levels. A profile is a list of
+ *              timed steps run from a level change, each holding a fixed
+ *              intensity, then the intensity bands of intensity_cfg.h take
+ *              over. Tune the boost here and check the time to comfort
+ *              with Tools/thermal/thermal.py.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef PROFILE_CFG_H_
+#define PROFILE_CFG_H_
+
+/* Steps of every level as { seconds, intensity }, at most PROFILE_MAX_STEPS.
+ * The bands follow the last step. */
+#define PROFILE_STEPS_LOW               { { 180U, HIGHINTENSITY }, { 0U, PROFILE_BANDS } }
+#define PROFILE_STEPS_MEDIUM            { { 240U, HIGHINTENSITY }, { 0U, PROFILE_BANDS } }
+#define PROFILE_STEPS_HIGH              { { 240U, HIGHINTENSITY }, { 180U, MEDIUMINTENSITY }, { 0U, PROFILE_BANDS } }
+
+/* The steps end early once the error (desired - current) is below this, in
+ * whole C, and the bands take over. Not below the comfort error of profile.h,
+ * raise it for a heater that keeps heating the seat after it is switched off. */
+#define PROFILE_EXIT_C                  (2)
+
+#endif /* PROFILE_CFG_H_ */
@@ -0,0 +1,111 @@
+ /******************************************************************************
+ *
+ * Module: ReleasePlanner
+ *
+ * File Name: release_planner.c
+ *
+ * Description: Source file for the release phase planner of co-periodic tasks.
+ *              Runs once before the scheduler starts, so it favors simplicity
+ *              over speed: O(tasks * period * horizon).
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#include "release_planner.h"
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+/* Planned demand of every tick of the horizon in 0.1 ms */
+static uint32 ulDemand[RELEASE_PLANNER_HORIZON_TICKS];
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+/* Number of releases of a task inside the horizon */
+static TickType_t prvReleasesInHorizon(TickType_t xPeriod)
+{
+    return (xPeriod <= RELEASE_PLANNER_HORIZON_TICKS) ? (RELEASE_PLANNER_HORIZON_TICKS / xPeriod) : 1;
+}
+
+/* Spread the load of every release over the ticks that follow it and either
+ * add it to the plan or return the peak demand it would cause */
+static uint32 prvPlaceLoad(const ReleasePlannerTask *pxTask, TickType_t xPhase, boolean bCommit)
+{
+    TickType_t xRelease, xTick;
+    uint32 ulRemaining, ulChunk, ulPeak = 0;
+
+    for (xRelease = 0; xRelease < prvReleasesInHorizon(pxTask->xPeriod); xRelease++)
+    {
+        xTick = (xPhase + (xRelease * pxTask->xPeriod)) % RELEASE_PLANNER_HORIZON_TICKS;
+        ulRemaining = pxTask->ulLoad;
+        do
+        {
+            ulChunk = (ulRemaining > RELEASE_PLANNER_UNITS_PER_TICK) ? RELEASE_PLANNER_UNITS_PER_TICK : ulRemaining;
+            if (bCommit)
+            {
+                ulDemand[xTick] += ulChunk;
+            }
+            else if ((ulDemand[xTick] + ulChunk) > ulPeak)
+            {
+                ulPeak = ulDemand[xTick] + ulChunk;
+            }
+            ulRemaining -= ulChunk;
+            xTick = (xTick + 1) % RELEASE_PLANNER_HORIZON_TICKS;
+        }
+        while (ulRemaining > 0);
+    }
+
+    return ulPeak;
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void ReleasePlanner_ComputePhases(const ReleasePlannerTask *pxTasks, uint8 ucCount,
+                                  TickType_t *pxPhases)
+{
+    uint8 ucTask;
+    TickType_t xOffset, xCandidate, xBase, xRange, xBestPhase;
+    uint32 ulPeak, ulBestPeak;
+
+    for (xOffset = 0; xOffset < RELEASE_PLANNER_HORIZON_TICKS; xOffset++)
+    {
+        ulDemand[xOffset] = 0;
+    }
+
+    for (ucTask = 0; ucTask < ucCount; ucTask++)
+    {
+        pxPhases[ucTask] = 0;
+        if (pxTasks[ucTask].xPeriod == 0)
+        {
+            continue;
+        }
+
+        xBase = (pxTasks[ucTask].ucAfter < ucTask) ? pxPhases[pxTasks[ucTask].ucAfter] : 0;
+        xRange = (pxTasks[ucTask].xPeriod < RELEASE_PLANNER_HORIZON_TICKS) ?
+                  pxTasks[ucTask].xPeriod : RELEASE_PLANNER_HORIZON_TICKS;
+        xBestPhase = xBase % xRange;
+        ulBestPeak = 0xFFFFFFFFUL;
+
+        /* Candidates are visited in order of distance after the predecessor,
+         * so a strict improvement is needed to move further away from it */
+        for (xOffset = 0; xOffset < xRange; xOffset++)
+        {
+            xCandidate = (xBase + xOffset) % xRange;
+            ulPeak = prvPlaceLoad(&pxTasks[ucTask], xCandidate, FALSE);
+            if (ulPeak < ulBestPeak)
+            {
+                ulBestPeak = ulPeak;
+                xBestPhase = xCandidate;
+            }
+        }
+
+        pxPhases[ucTask] = xBestPhase;
+        (void) prvPlaceLoad(&pxTasks[ucTask], xBestPhase, TRUE);
+    }
+}
@@ -0,0 +1,54 @@
+ /******************************************************************************
+ *
+ * Module: ReleasePlanner
+ *
+ * File Name: release_planner.h
+ *
+ * Description: Header file for the release phase planner of co-periodic tasks
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef RELEASE_PLANNER_H_
+#define RELEASE_PLANNER_H_
+
+#include "FreeRTOS.h"
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Window (in ticks) over which the demand of all releases is accumulated.
+ * Periods dividing it are planned exactly, longer periods are planned for
+ * their first release only. */
+#define RELEASE_PLANNER_HORIZON_TICKS   (100U)
+
+/* Load units (0.1 ms) the CPU can execute during one tick */
+#define RELEASE_PLANNER_UNITS_PER_TICK  ((10000U) / configTICK_RATE_HZ)
+
+#define RELEASE_PLANNER_NO_TASK         (0xFFU)
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct
+{
+    TickType_t xPeriod;     /* 0 for tasks that are not periodic, they are skipped */
+    uint32 ulLoad;          /* Execution time triggered by one release in 0.1 ms */
+    uint8 ucAfter;          /* Task whose release this one should follow, or RELEASE_PLANNER_NO_TASK */
+}ReleasePlannerTask;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Tasks are placed one by one in array order (highest priority first), each
+ * at the phase that keeps the peak demand per tick lowest. Ties go to the
+ * phase closest after the release of ucAfter, which must be an earlier entry. */
+extern void ReleasePlanner_ComputePhases(const ReleasePlannerTask *pxTasks, uint8 ucCount,
+                                         TickType_t *pxPhases);
+
+#endif /* RELEASE_PLANNER_H_ */
@@ -0,0 +1,147 @@
+ /******************************************************************************
+ *
+ * Module: Sampling
+ *
+ * File Name: sampling.c
+ *
+ * Description: Source file for the load-adaptive seat temperature sampling policy.
+ *              The reading task keeps its release period and phase, in slow mode
+ *              it only samples on every SAMPLING_SLOW_DIVIDER-th release, so a
+ *              set-point change is picked up on the very next release.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#include "sampling.h"
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static Temperature prvAbs(Temperature xValue)
+{
+    return (xValue < 0) ? -xValue : xValue;
+}
+
+/* Conditions that need every release sampled */
+static boolean prvNeedsFastRate(Temperature xTemp, UserHeatInput eDesired)
+{
+    if ((xTemp < (SAMPLING_FAULT_LOW + SAMPLING_FAULT_MARGIN)) ||
+        (xTemp > (SAMPLING_FAULT_HIGH - SAMPLING_FAULT_MARGIN)))
+    {
+        return TRUE;
+    }
+    if ((eDesired != OFF) && (prvAbs(TEMPERATURE_FROM_C(eDesired) - xTemp) >= SAMPLING_TARGET_BAND))
+    {
+        return TRUE;
+    }
+    return FALSE;
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void Sampling_Init(SamplingPolicy *pxPolicy)
+{
+    uint8 ucMode;
+
+    pxPolicy->eMode = SAMPLING_FAST;
+    pxPolicy->bSetPointChanged = FALSE;
+    pxPolicy->ucSkip = 0;
+    pxPolicy->ucStableSamples = 0;
+    pxPolicy->xLastTemp = 0;
+    for (ucMode = 0; ucMode < SAMPLING_MODES; ucMode++)
+    {
+        pxPolicy->xStats[ucMode].ulReleases = 0;
+        pxPolicy->xStats[ucMode].ulSamples = 0;
+        pxPolicy->xStats[ucMode].ulSampleTime = 0;
+        pxPolicy->xStats[ucMode].ulDisplayTime = 0;
+        pxPolicy->xStats[ucMode].ulUartBytes = 0;
+    }
+}
+
+boolean Sampling_IsDue(SamplingPolicy *pxPolicy)
+{
+    if (pxPolicy->bSetPointChanged)
+    {
+        pxPolicy->bSetPointChanged = FALSE;
+        pxPolicy->eMode = SAMPLING_FAST;
+        pxPolicy->ucStableSamples = 0;
+        pxPolicy->ucSkip = 0;
+    }
+
+    pxPolicy->xStats[pxPolicy->eMode].ulReleases++;
+    if (pxPolicy->ucSkip > 0)
+    {
+        pxPolicy->ucSkip--;
+        return FALSE;
+    }
+    return TRUE;
+}
+
+void Sampling_Update(SamplingPolicy *pxPolicy, Temperature xTemp, UserHeatInput eDesired,
+                     uint32 ulSampleTime)
+{
+    pxPolicy->xStats[pxPolicy->eMode].ulSamples++;
+    pxPolicy->xStats[pxPolicy->eMode].ulSampleTime += ulSampleTime;
+
+    if (prvAbs(xTemp - pxPolicy->xLastTemp) < SAMPLING_STABLE_DELTA)
+    {
+        if (pxPolicy->ucStableSamples < SAMPLING_STABLE_SAMPLES)
+        {
+            pxPolicy->ucStableSamples++;
+        }
+    }
+    else
+    {
+        pxPolicy->ucStableSamples = 0;
+    }
+    pxPolicy->xLastTemp = xTemp;
+
+    if (prvNeedsFastRate(xTemp, eDesired) || (pxPolicy->ucStableSamples < SAMPLING_STABLE_SAMPLES))
+    {
+        pxPolicy->eMode = SAMPLING_FAST;
+        pxPolicy->ucSkip = 0;
+    }
+    else
+    {
+        pxPolicy->eMode = SAMPLING_SLOW;
+        pxPolicy->ucSkip = SAMPLING_SLOW_DIVIDER - 1;
+    }
+}
+
+void Sampling_SetPointChanged(SamplingPolicy *pxPolicy)
+{
+    pxPolicy->bSetPointChanged = TRUE;
+}
+
+void Sampling_AccountDisplay(SamplingPolicy *pxPolicy, uint32 ulDisplayTime, uint32 ulUartBytes)
+{
+    pxPolicy->xStats[pxPolicy->eMode].ulDisplayTime += ulDisplayTime;
+    pxPolicy->xStats[pxPolicy->eMode].ulUartBytes += ulUartBytes;
+}
+
+void Sampling_GetUtilization(const SamplingPolicy *pxPolicy, SamplingMode eMode,
+                             uint32 ulReleasePeriodMs, uint32 ulBaudRate,
+                             SamplingUtilization *pxUtilization)
+{
+    const SamplingModeStats *pxStats = &pxPolicy->xStats[eMode];
+    uint32 ulTimeMs = pxStats->ulReleases * ulReleasePeriodMs;
+
+    pxUtilization->ulTimeMs = ulTimeMs;
+    if (ulTimeMs == 0)
+    {
+        pxUtilization->ucCpuLoad = 0;
+        pxUtilization->ulAdcRate = 0;
+        pxUtilization->ucUartLoad = 0;
+        return;
+    }
+
+    /* CPU times are in 0.1 ms, 10 bits per byte on the line (start, 8 data, stop) */
+    pxUtilization->ucCpuLoad = (uint8)(((unsigned long long)(pxStats->ulSampleTime + pxStats->ulDisplayTime) * 10U) / ulTimeMs);
+    pxUtilization->ulAdcRate = (uint32)(((unsigned long long)pxStats->ulSamples * 10000U) / ulTimeMs);
+    pxUtilization->ucUartLoad = (uint8)(((unsigned long long)pxStats->ulUartBytes * 10U * 100U * 1000U) /
+                                        ((unsigned long long)ulBaudRate * ulTimeMs));
+}
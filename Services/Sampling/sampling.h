@@ -0,0 +1,102 @@
+ /******************************************************************************
+ *
+ * Module: Sampling
+ *
+ * File Name: sampling.h
+ *
+ * Description: Header file for the load-adaptive seat temperature sampling policy
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef SAMPLING_H_
+#define SAMPLING_H_
+
+#include "std_types.h"
+#include "temperature.h"
+#include "intensity_cfg.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* In slow mode only one release out of SAMPLING_SLOW_DIVIDER samples the sensor */
+#define SAMPLING_SLOW_DIVIDER           (5U)
+
+/* A sample is stable when it moved less than this from the previous one (C),
+ * SAMPLING_STABLE_SAMPLES stable samples in a row are needed to slow down */
+#define SAMPLING_STABLE_DELTA           TEMPERATURE_FROM_TENTHS(5)
+#define SAMPLING_STABLE_SAMPLES         (5U)
+
+/* The seat is at its target while the controller keeps the heater off */
+#define SAMPLING_TARGET_BAND            TEMPERATURE_FROM_C(INTENSITY_LOW_FROM_C)
+
+/* Sensor fault thresholds of the controller and the margin kept in fast mode around them */
+#define SAMPLING_FAULT_LOW              TEMPERATURE_FROM_C(INTENSITY_SENSOR_MIN_C)
+#define SAMPLING_FAULT_HIGH             TEMPERATURE_FROM_C(INTENSITY_SENSOR_MAX_C)
+#define SAMPLING_FAULT_MARGIN           TEMPERATURE_FROM_C(2)
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef enum
+{
+    SAMPLING_FAST,
+    SAMPLING_SLOW,
+    SAMPLING_MODES
+}SamplingMode;
+
+typedef struct
+{
+    uint32 ulReleases;              /* Releases of the reading task spent in this mode */
+    uint32 ulSamples;               /* ADC conversions */
+    uint32 ulSampleTime;            /* Reading task CPU time in 0.1 ms */
+    uint32 ulDisplayTime;           /* Display task CPU time in 0.1 ms */
+    uint32 ulUartBytes;             /* Bytes streamed by the display task */
+}SamplingModeStats;
+
+typedef struct
+{
+    volatile SamplingMode eMode;
+    volatile boolean bSetPointChanged;
+    uint8 ucSkip;                   /* Releases left until the next sample */
+    uint8 ucStableSamples;
+    Temperature xLastTemp;
+    SamplingModeStats xStats[SAMPLING_MODES];
+}SamplingPolicy;
+
+/* Utilization of one mode over the time spent in it */
+typedef struct
+{
+    uint32 ulTimeMs;
+    uint8 ucCpuLoad;                /* Percent of CPU used by the reading and display jobs */
+    uint32 ulAdcRate;               /* Conversions per second in tenths */
+    uint8 ucUartLoad;               /* Percent of the UART bandwidth */
+}SamplingUtilization;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+extern void Sampling_Init(SamplingPolicy *pxPolicy);
+
+/* Call on every release of the reading task, returns TRUE if it must sample */
+extern boolean Sampling_IsDue(SamplingPolicy *pxPolicy);
+
+/* Call after a sample with the reading, the desired level and the job time (0.1 ms) */
+extern void Sampling_Update(SamplingPolicy *pxPolicy, Temperature xTemp, UserHeatInput eDesired,
+                            uint32 ulSampleTime);
+
+/* Call when the user changes the level of the seat, the next release samples */
+extern void Sampling_SetPointChanged(SamplingPolicy *pxPolicy);
+
+/* Charge the display of one sample to the current mode */
+extern void Sampling_AccountDisplay(SamplingPolicy *pxPolicy, uint32 ulDisplayTime, uint32 ulUartBytes);
+
+extern void Sampling_GetUtilization(const SamplingPolicy *pxPolicy, SamplingMode eMode,
+                                    uint32 ulReleasePeriodMs, uint32 ulBaudRate,
+                                    SamplingUtilization *pxUtilization);
+
+#endif /* SAMPLING_H_ */
@@ -0,0 +1,79 @@
+ /******************************************************************************
+ *
+ * Module: StackProfile
+ *
+ * File Name: stack_profile.c
+ *
+ * Description: Source file for the task stack high-water profiling. The
+ *              peak of every task is sampled from the painted stack, and the
+ *              recommended depth adds a margin to it. The stacks console
+ *              command prints them in the format of stack_sizes.h, which the
+ *              task table uses when STACK_PROFILE_APPLY is 1.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#include "stack_profile.h"
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static StackProfileTask xTasks[STACK_PROFILE_MAX_TASKS];
+static uint8 ucTasksCount = 0;
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void StackProfile_Register(TaskHandle_t xTask, uint16 usDepth)
+{
+    if ((xTask == NULL) || (ucTasksCount >= STACK_PROFILE_MAX_TASKS))
+    {
+        return;
+    }
+    xTasks[ucTasksCount].xTask = xTask;
+    xTasks[ucTasksCount].usDepth = usDepth;
+    xTasks[ucTasksCount].usPeak = 0;
+    xTasks[ucTasksCount].xPeakTick = 0;
+    xTasks[ucTasksCount].ulSamples = 0;
+    ucTasksCount++;
+}
+
+void StackProfile_Sample(void)
+{
+    StackProfileTask *pxTask;
+    uint16 usUsed;
+    uint8 ucIndex;
+
+    for (ucIndex = 0; ucIndex < ucTasksCount; ucIndex++)
+    {
+        pxTask = &xTasks[ucIndex];
+        usUsed = pxTask->usDepth - (uint16) uxTaskGetStackHighWaterMark(pxTask->xTask);
+        if (usUsed > pxTask->usPeak)
+        {
+            pxTask->usPeak = usUsed;
+            pxTask->xPeakTick = xTaskGetTickCount();
+        }
+        pxTask->ulSamples++;
+    }
+}
+
+uint8 StackProfile_GetCount(void)
+{
+    return ucTasksCount;
+}
+
+const StackProfileTask *StackProfile_Get(uint8 ucIndex)
+{
+    return (ucIndex < ucTasksCount) ? &xTasks[ucIndex] : NULL_PTR;
+}
+
+uint16 StackProfile_GetRecommended(const StackProfileTask *pxTask)
+{
+    uint32 ulWords = pxTask->usPeak + ((pxTask->usPeak * STACK_PROFILE_MARGIN_PERCENT) + 99U) / 100U;
+
+    ulWords = ((ulWords + STACK_PROFILE_ROUND_WORDS - 1U) / STACK_PROFILE_ROUND_WORDS) * STACK_PROFILE_ROUND_WORDS;
+    return (ulWords < configMINIMAL_STACK_SIZE) ? (uint16) configMINIMAL_STACK_SIZE : (uint16) ulWords;
+}
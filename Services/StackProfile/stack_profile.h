@@ -0,0 +1,78 @@
+ /******************************************************************************
+ *
+ * Module: StackProfile
+ *
+ * File Name: stack_profile.h
+ *
+ * Description: Header file for the task stack high-water profiling
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef STACK_PROFILE_H_
+#define STACK_PROFILE_H_
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Maximum number of tasks that can be registered for profiling */
+#define STACK_PROFILE_MAX_TASKS             (16U)
+
+/* Recommended depth: the peak plus this margin, rounded up to whole
+ * STACK_PROFILE_ROUND_WORDS and never below configMINIMAL_STACK_SIZE */
+#define STACK_PROFILE_MARGIN_PERCENT        (25U)
+#define STACK_PROFILE_ROUND_WORDS           (8U)
+
+/* 1: create the tasks with the recommended depths of stack_sizes.h,
+ * 0: with the default depths of the task table (use it to profile).
+ * Stays 0 until stack_sizes.h is filled from a profile on the target. */
+#define STACK_PROFILE_APPLY                 (0U)
+
+/* Stack depth of a task table entry: STACK_DEPTH_<NAME> in apply mode */
+#if (STACK_PROFILE_APPLY == 1U)
+#include "stack_sizes.h"
+#define STACK_PROFILE_DEPTH(NAME, DEFAULT)  (STACK_DEPTH_##NAME)
+#else
+#define STACK_PROFILE_DEPTH(NAME, DEFAULT)  (DEFAULT)
+#endif
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct
+{
+    TaskHandle_t xTask;
+    uint16 usDepth;                 /* Words the task was created with */
+    uint16 usPeak;                  /* Most words ever used */
+    TickType_t xPeakTick;           /* Sample that last raised the peak */
+    uint32 ulSamples;
+}StackProfileTask;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Call after the task is created. The kernel fills a new stack with a known
+ * pattern (INCLUDE_uxTaskGetStackHighWaterMark), the words still holding it
+ * were never used. */
+extern void StackProfile_Register(TaskHandle_t xTask, uint16 usDepth);
+
+/* Update the peak of every task from its high-water mark, call periodically.
+ * A scan takes about one cycle per unused stack byte. */
+extern void StackProfile_Sample(void);
+
+extern uint8 StackProfile_GetCount(void);
+
+extern const StackProfileTask *StackProfile_Get(uint8 ucIndex);
+
+/* Depth in words to use for the task in apply mode */
+extern uint16 StackProfile_GetRecommended(const StackProfileTask *pxTask);
+
+#endif /* STACK_PROFILE_H_ */
@@ -0,0 +1,47 @@
+ /******************************************************************************
+ *
+ * Module: StackProfile
+ *
+ * File Name: stack_sizes.h
+ *
+ * Description: Task stack depths in words used when STACK_PROFILE_APPLY is 1.
+ *              Replace the definitions with the output of "stacks defines"
+ *              after the tasks ran through all their paths on the target
+ *              (every seat level, the console commands, a deep sleep and the
+ *              clock switches), and again whenever a task changes.
+ *              No profile has been taken yet: the depths below are the
+ *              256-word defaults of the task table, so apply mode would
+ *              change nothing and is refused until the file is measured.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef STACK_SIZES_H_
+#define STACK_SIZES_H_
+
+/* Set to 1 by the last line of "stacks defines" */
+#define STACK_SIZES_MEASURED 0
+
+#if (STACK_SIZES_MEASURED == 0)
+#error "stack_sizes.h holds no measured depths yet, paste the output of \"stacks defines\" or keep STACK_PROFILE_APPLY at 0"
+#endif
+
+#define STACK_DEPTH_SetTempForDriver 256
+#define STACK_DEPTH_SetTempForPassenger 256
+#define STACK_DEPTH_ReadTempForDriver 256
+#define STACK_DEPTH_ReadTempForPassenger 256
+#define STACK_DEPTH_ControlTempForDriver 256
+#define STACK_DEPTH_ControlTempForPassenger 256
+#define STACK_DEPTH_ControlLedsForDriver 256
+#define STACK_DEPTH_ControlLedsForPassenger 256
+#define STACK_DEPTH_DisplayForDriver 256
+#define STACK_DEPTH_DisplayForPassenger 256
+#define STACK_DEPTH_RunTimeMeasurements 256
+#define STACK_DEPTH_Logger 256
+#define STACK_DEPTH_Console 256
+#define STACK_DEPTH_UartGatekeeper 256
+#define STACK_DEPTH_Store 256
+#define STACK_DEPTH_Dashboard 256
+
+#endif /* STACK_SIZES_H_ */
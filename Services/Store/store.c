@@ -0,0 +1,427 @@
+ /******************************************************************************
+ *
+ * Module: Store
+ *
+ * File Name: store.c
+ *
+ * Description: Source file for the persistent settings and fault log. Every
+ *              record is eight EEPROM words with a versioned header, a
+ *              sequence number and a CRC, and is written to the slot after
+ *              the newest one, so the writes rotate through all the slots of
+ *              their area and a write cut by a power loss leaves the previous
+ *              record intact. The control tasks only change a RAM copy, the
+ *              low priority store task writes the changes in batches.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#include "store.h"
+#include "task.h"
+#include "semphr.h"
+#include "crc16.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define STORE_TYPE_SETTINGS             (1U)
+#define STORE_TYPE_FAULT                (2U)
+#define STORE_HEADER(TYPE)              ((STORE_MAGIC << 16) | (STORE_VERSION << 8) | (TYPE))
+
+#define STORE_WORD_HEADER               (0U)
+#define STORE_WORD_SEQUENCE             (1U)
+#define STORE_WORD_PAYLOAD              (2U)
+#define STORE_WORD_CRC                  (STORE_RECORD_WORDS - 1U)
+
+/* First EEPROM word of a slot */
+#define STORE_SLOT_WORD(TYPE, SLOT)     ((uint16) ((((TYPE) == STORE_TYPE_SETTINGS) ? 0U :                   \
+                                                    (STORE_SETTINGS_BLOCKS * EEPROM_WORDS_PER_BLOCK)) +      \
+                                                   ((SLOT) * STORE_RECORD_WORDS)))
+
+/* Ticks between two polls while a word is programmed */
+#define STORE_POLL_TICKS                (1U)
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static TaskHandle_t xStoreTask = NULL;
+static SemaphoreHandle_t xStoreMutex = NULL;   /* EEPROM access of the store task and the readers */
+
+/* RAM copy of the settings and the faults not written yet, changed in critical sections */
+static StoreSettings xSettings = { 0, 0, 0 };
+static boolean bSettingsDirty = FALSE;
+static StoreFault xPendingFaults[STORE_PENDING_FAULTS];
+static uint8 ucPendingFaults = 0;
+
+/* Next slot and sequence of each area, only used by the store task after
+ * Store_Init(). ucFaultNext and xStats.usFaults are also read by
+ * Store_GetFault(), both change under xStoreMutex. */
+static uint32 ulSettingsSequence = 0;
+static uint32 ulFaultSequence = 0;
+static uint8 ucSettingsNext = 0;
+static uint8 ucFaultNext = 0;
+
+static StoreStats xStats;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void prvReadRecord(uint16 usWord, uint32 *pulRecord)
+{
+    uint8 ucIndex;
+
+    for (ucIndex = 0; ucIndex < STORE_RECORD_WORDS; ucIndex++)
+    {
+        pulRecord[ucIndex] = EEPROM_ReadWord(usWord + ucIndex);
+    }
+}
+
+/* An erased slot reads all ones, so it fails the header check. A record of
+ * another layout version is not valid either. */
+static boolean prvIsValid(const uint32 *pulRecord, uint8 ucType)
+{
+    return ((pulRecord[STORE_WORD_HEADER] == STORE_HEADER(ucType)) &&
+            (pulRecord[STORE_WORD_CRC] == CRC16_Compute((const uint8 *) pulRecord,
+                                                        STORE_WORD_CRC * sizeof(uint32)))) ? TRUE : FALSE;
+}
+
+/* Newest valid record of an area is copied to pulNewest, returns its slot or
+ * ucSlots when the area holds none */
+static uint8 prvFindNewest(uint8 ucType, uint8 ucSlots, uint32 *pulNewest, uint16 *pusValid)
+{
+    uint32 ulRecord[STORE_RECORD_WORDS];
+    uint8 ucSlot, ucNewest = ucSlots, ucIndex;
+
+    *pusValid = 0;
+    for (ucSlot = 0; ucSlot < ucSlots; ucSlot++)
+    {
+        prvReadRecord(STORE_SLOT_WORD(ucType, ucSlot), ulRecord);
+        if (prvIsValid(ulRecord, ucType) == FALSE)
+        {
+            continue;
+        }
+        (*pusValid)++;
+        if ((ucNewest == ucSlots) || (ulRecord[STORE_WORD_SEQUENCE] > pulNewest[STORE_WORD_SEQUENCE]))
+        {
+            ucNewest = ucSlot;
+            for (ucIndex = 0; ucIndex < STORE_RECORD_WORDS; ucIndex++)
+            {
+                pulNewest[ucIndex] = ulRecord[ucIndex];
+            }
+        }
+    }
+    return ucNewest;
+}
+
+/* Programs the record word by word, the CRC last. The task sleeps while a
+ * word is programmed, so the lower priority work and the idle sleep go on. */
+static void prvWriteRecord(uint8 ucType, uint8 ucSlot, uint32 ulSequence, uint32 *pulRecord)
+{
+    uint16 usWord = STORE_SLOT_WORD(ucType, ucSlot);
+    boolean bFailed = FALSE;
+    uint8 ucIndex;
+
+    pulRecord[STORE_WORD_HEADER] = STORE_HEADER(ucType);
+    pulRecord[STORE_WORD_SEQUENCE] = ulSequence;
+    pulRecord[STORE_WORD_CRC] = CRC16_Compute((const uint8 *) pulRecord, STORE_WORD_CRC * sizeof(uint32));
+
+    xSemaphoreTake(xStoreMutex, portMAX_DELAY);
+    for (ucIndex = 0; ucIndex < STORE_RECORD_WORDS; ucIndex++)
+    {
+        EEPROM_StartWrite(usWord + ucIndex, pulRecord[ucIndex]);
+        while (EEPROM_IsBusy() == TRUE)
+        {
+            vTaskDelay(STORE_POLL_TICKS);
+        }
+        if (EEPROM_WriteFailed() == TRUE)
+        {
+            bFailed = TRUE;
+        }
+    }
+    xSemaphoreGive(xStoreMutex);
+
+    if (bFailed == TRUE)
+    {
+        xStats.ulWriteErrors++;
+    }
+}
+
+static void prvPackSettings(const StoreSettings *pxSettings, uint32 *pulRecord)
+{
+    uint8 ucIndex;
+
+    for (ucIndex = STORE_WORD_PAYLOAD; ucIndex < STORE_WORD_CRC; ucIndex++)
+    {
+        pulRecord[ucIndex] = 0;
+    }
+    pulRecord[STORE_WORD_PAYLOAD] = (uint32) pxSettings->ucDriverLevel |
+                                    ((uint32) pxSettings->ucPassengerLevel << 8) |
+                                    ((uint32) pxSettings->ucBudgetPolicy << 16);
+}
+
+static void prvPackFault(const StoreFault *pxFault, uint32 *pulRecord)
+{
+    uint8 ucIndex;
+
+    for (ucIndex = STORE_WORD_PAYLOAD; ucIndex < STORE_WORD_CRC; ucIndex++)
+    {
+        pulRecord[ucIndex] = 0;
+    }
+    pulRecord[STORE_WORD_PAYLOAD] = (uint32) pxFault->ucSeat | ((uint32) pxFault->ucCode << 8) |
+                                    ((uint32) pxFault->usCount << 16);
+    pulRecord[STORE_WORD_PAYLOAD + 1U] = (uint32) (uint16) pxFault->sReading | ((uint32) pxFault->ucLevel << 16);
+    pulRecord[STORE_WORD_PAYLOAD + 2U] = pxFault->ulTime;
+}
+
+static void prvUnpackFault(const uint32 *pulRecord, StoreFault *pxFault)
+{
+    pxFault->ulSequence = pulRecord[STORE_WORD_SEQUENCE];
+    pxFault->ucSeat = (uint8) pulRecord[STORE_WORD_PAYLOAD];
+    pxFault->ucCode = (uint8) (pulRecord[STORE_WORD_PAYLOAD] >> 8);
+    pxFault->usCount = (uint16) (pulRecord[STORE_WORD_PAYLOAD] >> 16);
+    pxFault->sReading = (sint16) (uint16) pulRecord[STORE_WORD_PAYLOAD + 1U];
+    pxFault->ucLevel = (uint8) (pulRecord[STORE_WORD_PAYLOAD + 1U] >> 16);
+    pxFault->ulTime = pulRecord[STORE_WORD_PAYLOAD + 2U];
+}
+
+static void prvNotify(void)
+{
+    if (xStoreTask != NULL)
+    {
+        xTaskNotifyGive(xStoreTask);
+    }
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+boolean Store_Init(void)
+{
+    uint32 ulRecord[STORE_RECORD_WORDS];
+    uint16 usValid;
+    uint8 ucSlot;
+
+    /* Every area starts empty, each one found below takes over */
+    ulSettingsSequence = 0;
+    ulFaultSequence = 0;
+    ucSettingsNext = 0;
+    ucFaultNext = 0;
+    xStats.usFaults = 0;
+
+    xStoreMutex = xSemaphoreCreateMutex();
+    xStats.bAvailable = EEPROM_Init();
+    if (xStats.bAvailable == FALSE)
+    {
+        return FALSE;
+    }
+
+    ucSlot = prvFindNewest(STORE_TYPE_FAULT, STORE_FAULT_SLOTS, ulRecord, &xStats.usFaults);
+    if (ucSlot < STORE_FAULT_SLOTS)
+    {
+        ulFaultSequence = ulRecord[STORE_WORD_SEQUENCE];
+        ucFaultNext = (ucSlot + 1U) % STORE_FAULT_SLOTS;
+    }
+
+    ucSlot = prvFindNewest(STORE_TYPE_SETTINGS, STORE_SETTINGS_SLOTS, ulRecord, &usValid);
+    if (ucSlot == STORE_SETTINGS_SLOTS)
+    {
+        return FALSE;
+    }
+    ulSettingsSequence = ulRecord[STORE_WORD_SEQUENCE];
+    ucSettingsNext = (ucSlot + 1U) % STORE_SETTINGS_SLOTS;
+    xSettings.ucDriverLevel = (uint8) ulRecord[STORE_WORD_PAYLOAD];
+    xSettings.ucPassengerLevel = (uint8) (ulRecord[STORE_WORD_PAYLOAD] >> 8);
+    xSettings.ucBudgetPolicy = (uint8) (ulRecord[STORE_WORD_PAYLOAD] >> 16);
+    return TRUE;
+}
+
+void Store_GetSettings(StoreSettings *pxSettings)
+{
+    taskENTER_CRITICAL();
+    *pxSettings = xSettings;
+    taskEXIT_CRITICAL();
+}
+
+void Store_SetSettings(const StoreSettings *pxSettings)
+{
+    boolean bChanged;
+
+    if (xStats.bAvailable == FALSE)
+    {
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    bChanged = ((pxSettings->ucDriverLevel != xSettings.ucDriverLevel) ||
+                (pxSettings->ucPassengerLevel != xSettings.ucPassengerLevel) ||
+                (pxSettings->ucBudgetPolicy != xSettings.ucBudgetPolicy)) ? TRUE : FALSE;
+    if (bChanged == TRUE)
+    {
+        if (bSettingsDirty == TRUE)
+        {
+            xStats.ulSettingsCoalesced++;
+        }
+        xSettings = *pxSettings;
+        bSettingsDirty = TRUE;
+    }
+    taskEXIT_CRITICAL();
+
+    if (bChanged == TRUE)
+    {
+        prvNotify();
+    }
+}
+
+void Store_LogFault(uint8 ucSeat, uint8 ucCode, sint16 sReading, uint8 ucLevel)
+{
+    StoreFault *pxFault = NULL;
+    uint8 ucIndex;
+
+    if (xStats.bAvailable == FALSE)
+    {
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    for (ucIndex = 0; ucIndex < ucPendingFaults; ucIndex++)
+    {
+        if ((xPendingFaults[ucIndex].ucSeat == ucSeat) && (xPendingFaults[ucIndex].ucCode == ucCode))
+        {
+            pxFault = &xPendingFaults[ucIndex];
+        }
+    }
+
+    if (pxFault != NULL)
+    {
+        /* Still waiting: count the repeat and keep its last reading */
+        if (pxFault->usCount < 0xFFFFU)
+        {
+            pxFault->usCount++;
+        }
+        pxFault->sReading = sReading;
+        pxFault->ucLevel = ucLevel;
+        xStats.ulFaultsCoalesced++;
+    }
+    else if (ucPendingFaults < STORE_PENDING_FAULTS)
+    {
+        pxFault = &xPendingFaults[ucPendingFaults++];
+        pxFault->ulTime = xTaskGetTickCount() / configTICK_RATE_HZ;
+        pxFault->sReading = sReading;
+        pxFault->usCount = 1;
+        pxFault->ucSeat = ucSeat;
+        pxFault->ucCode = ucCode;
+        pxFault->ucLevel = ucLevel;
+    }
+    else
+    {
+        xStats.ulFaultsDropped++;
+    }
+    taskEXIT_CRITICAL();
+
+    prvNotify();
+}
+
+void Store_Process(void)
+{
+    uint32 ulRecord[STORE_RECORD_WORDS];
+    StoreSettings xWriteSettings;
+    StoreFault xWriteFaults[STORE_PENDING_FAULTS];
+    boolean bWriteSettings;
+    uint8 ucFaults, ucIndex;
+    TickType_t xStart, xFlush;
+
+    xStoreTask = xTaskGetCurrentTaskHandle();
+    if ((bSettingsDirty == FALSE) && (ucPendingFaults == 0))
+    {
+        (void) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+
+    /* Let a burst of changes (a few button presses) end, it is written once */
+    vTaskDelay(pdMS_TO_TICKS(STORE_COALESCE_MS));
+
+    /* A change made from here on wakes the task again */
+    (void) ulTaskNotifyTake(pdTRUE, 0);
+    taskENTER_CRITICAL();
+    bWriteSettings = bSettingsDirty;
+    xWriteSettings = xSettings;
+    bSettingsDirty = FALSE;
+    ucFaults = ucPendingFaults;
+    for (ucIndex = 0; ucIndex < ucFaults; ucIndex++)
+    {
+        xWriteFaults[ucIndex] = xPendingFaults[ucIndex];
+    }
+    ucPendingFaults = 0;
+    taskEXIT_CRITICAL();
+
+    xStart = xTaskGetTickCount();
+    if (bWriteSettings == TRUE)
+    {
+        prvPackSettings(&xWriteSettings, ulRecord);
+        prvWriteRecord(STORE_TYPE_SETTINGS, ucSettingsNext, ++ulSettingsSequence, ulRecord);
+        ucSettingsNext = (ucSettingsNext + 1U) % STORE_SETTINGS_SLOTS;
+        xStats.ulSettingsWrites++;
+    }
+    for (ucIndex = 0; ucIndex < ucFaults; ucIndex++)
+    {
+        prvPackFault(&xWriteFaults[ucIndex], ulRecord);
+        prvWriteRecord(STORE_TYPE_FAULT, ucFaultNext, ++ulFaultSequence, ulRecord);
+        xSemaphoreTake(xStoreMutex, portMAX_DELAY);
+        ucFaultNext = (ucFaultNext + 1U) % STORE_FAULT_SLOTS;
+        if (xStats.usFaults < STORE_FAULT_SLOTS)
+        {
+            xStats.usFaults++;
+        }
+        xSemaphoreGive(xStoreMutex);
+        xStats.ulFaultWrites++;
+    }
+
+    xFlush = (xTaskGetTickCount() - xStart) * (1000U / configTICK_RATE_HZ);
+    if (xFlush > xStats.ulMaxFlushMs)
+    {
+        xStats.ulMaxFlushMs = xFlush;
+    }
+}
+
+boolean Store_GetFault(uint16 usIndex, StoreFault *pxFault)
+{
+    uint32 ulRecord[STORE_RECORD_WORDS];
+    boolean bValid;
+
+    if (xStats.bAvailable == FALSE)
+    {
+        return FALSE;
+    }
+
+    /* The count and the newest slot are read together, a record written
+     * meanwhile would otherwise shift the index past the oldest one */
+    xSemaphoreTake(xStoreMutex, portMAX_DELAY);
+    bValid = (usIndex < xStats.usFaults) ? TRUE : FALSE;
+    if (bValid == TRUE)
+    {
+        prvReadRecord(STORE_SLOT_WORD(STORE_TYPE_FAULT,
+                                      (ucFaultNext + STORE_FAULT_SLOTS - 1U - usIndex) % STORE_FAULT_SLOTS),
+                      ulRecord);
+    }
+    xSemaphoreGive(xStoreMutex);
+
+    if (bValid == FALSE)
+    {
+        return FALSE;
+    }
+
+    bValid = prvIsValid(ulRecord, STORE_TYPE_FAULT);
+    if (bValid == TRUE)
+    {
+        prvUnpackFault(ulRecord, pxFault);
+    }
+    return bValid;
+}
+
+const StoreStats *Store_GetStats(void)
+{
+    return &xStats;
+}
@@ -0,0 +1,112 @@
+ /******************************************************************************
+ *
+ * Module: Store
+ *
+ * File Name: store.h
+ *
+ * Description: Header file for the persistent settings and fault log kept in
+ *              the on-chip EEPROM
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef STORE_H_
+#define STORE_H_
+
+#include "FreeRTOS.h"
+#include "std_types.h"
+#include "eeprom.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Record: header, sequence, STORE_PAYLOAD_WORDS of payload and the CRC */
+#define STORE_RECORD_WORDS              (8U)
+#define STORE_PAYLOAD_WORDS             (STORE_RECORD_WORDS - 3U)
+
+/* Header word: magic, layout version of the payload and record type */
+#define STORE_MAGIC                     (0x5EA7U)
+#define STORE_VERSION                   (2U)
+
+/* The settings rotate through the first blocks, the fault log is a ring in
+ * the rest of the EEPROM. The newest record has the highest sequence. */
+#define STORE_SETTINGS_BLOCKS           (8U)
+#define STORE_SETTINGS_SLOTS            ((STORE_SETTINGS_BLOCKS * EEPROM_WORDS_PER_BLOCK) / STORE_RECORD_WORDS)
+#define STORE_FAULT_SLOTS               (((EEPROM_BLOCKS - STORE_SETTINGS_BLOCKS) * EEPROM_WORDS_PER_BLOCK) / STORE_RECORD_WORDS)
+
+/* Changes within this time of the first one are written together */
+#define STORE_COALESCE_MS               (2000U)
+
+/* Faults waiting for the store task, a repeat of a waiting fault only counts */
+#define STORE_PENDING_FAULTS            (4U)
+
+#if ((EEPROM_WORDS_PER_BLOCK % STORE_RECORD_WORDS) != 0U)
+#error "A record must not straddle two EEPROM blocks"
+#endif
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint8 ucDriverLevel;            /* 0 (off) to 3 (high), the button state */
+    uint8 ucPassengerLevel;
+    uint8 ucBudgetPolicy;           /* HeaterBudgetPolicy */
+}StoreSettings;
+
+typedef struct
+{
+    uint32 ulSequence;
+    uint32 ulTime;                  /* Seconds since boot of the first occurrence */
+    sint16 sReading;                /* Last reading in 0.1 C */
+    uint16 usCount;                 /* Occurrences coalesced in this record */
+    uint8 ucSeat;
+    uint8 ucCode;                   /* Confirmed DTC, see dtc.h */
+    uint8 ucLevel;                  /* Seat level, 0 (off) to 3 (high) */
+}StoreFault;
+
+typedef struct
+{
+    boolean bAvailable;             /* FALSE if the EEPROM failed, nothing is kept */
+    uint16 usFaults;                /* Valid records in the fault log */
+    uint32 ulSettingsWrites;
+    uint32 ulFaultWrites;
+    uint32 ulSettingsCoalesced;     /* Changes replaced before they were written */
+    uint32 ulFaultsCoalesced;
+    uint32 ulFaultsDropped;         /* STORE_PENDING_FAULTS were waiting already */
+    uint32 ulWriteErrors;
+    uint32 ulMaxFlushMs;            /* Longest write of a batch */
+}StoreStats;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Call before the scheduler starts: powers up the EEPROM and finds the newest
+ * settings and fault records. Returns FALSE and keeps the defaults (all seats
+ * off) when the EEPROM or the stored settings cannot be used. */
+extern boolean Store_Init(void);
+
+extern void Store_GetSettings(StoreSettings *pxSettings);
+
+/* Only updates the RAM copy and wakes the store task, never waits for the
+ * EEPROM. Called from the control tasks. */
+extern void Store_SetSettings(const StoreSettings *pxSettings);
+
+/* Same as Store_SetSettings() for a fault record */
+extern void Store_LogFault(uint8 ucSeat, uint8 ucCode, sint16 sReading, uint8 ucLevel);
+
+/* Body of the store task: waits for a change, lets more changes gather for
+ * STORE_COALESCE_MS and writes them. The task polls the EEPROM with one tick
+ * delays while a word is programmed. */
+extern void Store_Process(void);
+
+/* Fault record by age, 0 is the newest. FALSE past the oldest one. */
+extern boolean Store_GetFault(uint16 usIndex, StoreFault *pxFault);
+
+extern const StoreStats *Store_GetStats(void);
+
+#endif /* STORE_H_ */
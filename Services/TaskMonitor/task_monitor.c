@@ -0,0 +1,141 @@
+ /******************************************************************************
+ *
+ * Module: TaskMonitor
+ *
+ * File Name: task_monitor.c
+ *
+ * Description: Source file for the periodic task release and deadline monitor.
+ *              Tasks are released at absolute ticks (xTaskDelayUntil) and every
+ *              release is timestamped against the tick it was due at, so the
+ *              lateness is measured with WTimer0 resolution instead of ticks.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#include "task_monitor.h"
+#include "GPTM.h"
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static TaskMonitor *pxMonitors[TASK_MONITOR_MAX_TASKS];
+static uint8 ucMonitorsCount = 0;
+
+/* Tick count and WTimer0 time of the last tick interrupt */
+static volatile TickType_t xLastTickCount = 0;
+static volatile uint32 ulLastTickTimestamp = 0;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+/* WTimer0 time at which the kernel tick xTick happened */
+static uint32 prvTickTimestamp(TickType_t xTick)
+{
+    uint32 ulTimestamp;
+
+    taskENTER_CRITICAL();
+    ulTimestamp = ulLastTickTimestamp - ((uint32)(xLastTickCount - xTick) * TASK_MONITOR_UNITS_PER_TICK);
+    taskEXIT_CRITICAL();
+
+    return ulTimestamp;
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void TaskMonitor_Init(TaskMonitor *pxMonitor, const char *pcName,
+                      TickType_t xPeriod, TickType_t xDeadline, TickType_t xPhase)
+{
+    uint8 ucBin;
+
+    pxMonitor->pcName = pcName;
+    pxMonitor->xPeriod = xPeriod;
+    pxMonitor->xPhase = xPhase;
+    pxMonitor->ulDeadline = (uint32)xDeadline * TASK_MONITOR_UNITS_PER_TICK;
+    /* The first call to TaskMonitor_WaitForRelease() releases the task at xPhase */
+    pxMonitor->xLastRelease = xTaskGetTickCount() + xPhase - xPeriod;
+    pxMonitor->ulReleaseTimestamp = 0;
+    pxMonitor->ulReleases = 0;
+    pxMonitor->ulDeadlineMisses = 0;
+    pxMonitor->ulMinLateness = 0xFFFFFFFFUL;
+    pxMonitor->ulMaxLateness = 0;
+    pxMonitor->ulMaxResponse = 0;
+    for (ucBin = 0; ucBin < TASK_MONITOR_HISTOGRAM_BINS; ucBin++)
+    {
+        pxMonitor->ulHistogram[ucBin] = 0;
+    }
+
+    taskENTER_CRITICAL();
+    if (ucMonitorsCount < TASK_MONITOR_MAX_TASKS)
+    {
+        pxMonitors[ucMonitorsCount++] = pxMonitor;
+    }
+    taskEXIT_CRITICAL();
+}
+
+void TaskMonitor_Restart(TaskMonitor *pxMonitor, TickType_t xBase)
+{
+    pxMonitor->xLastRelease = xBase + pxMonitor->xPhase - pxMonitor->xPeriod;
+}
+
+void TaskMonitor_WaitForRelease(TaskMonitor *pxMonitor)
+{
+    uint32 ulLateness;
+    uint32 ulBin;
+
+    xTaskDelayUntil(&pxMonitor->xLastRelease, pxMonitor->xPeriod);
+
+    pxMonitor->ulReleaseTimestamp = prvTickTimestamp(pxMonitor->xLastRelease);
+    ulLateness = GPTM_WTimer0Read() - pxMonitor->ulReleaseTimestamp;
+
+    pxMonitor->ulReleases++;
+    if (ulLateness < pxMonitor->ulMinLateness)
+    {
+        pxMonitor->ulMinLateness = ulLateness;
+    }
+    if (ulLateness > pxMonitor->ulMaxLateness)
+    {
+        pxMonitor->ulMaxLateness = ulLateness;
+    }
+
+    ulBin = ulLateness / TASK_MONITOR_HISTOGRAM_BIN_WIDTH;
+    if (ulBin >= TASK_MONITOR_HISTOGRAM_BINS)
+    {
+        ulBin = TASK_MONITOR_HISTOGRAM_BINS - 1;
+    }
+    pxMonitor->ulHistogram[ulBin]++;
+}
+
+void TaskMonitor_JobDone(TaskMonitor *pxMonitor)
+{
+    uint32 ulResponse = GPTM_WTimer0Read() - pxMonitor->ulReleaseTimestamp;
+
+    if (ulResponse > pxMonitor->ulMaxResponse)
+    {
+        pxMonitor->ulMaxResponse = ulResponse;
+    }
+    if (ulResponse > pxMonitor->ulDeadline)
+    {
+        pxMonitor->ulDeadlineMisses++;
+    }
+}
+
+void TaskMonitor_TickHook(void)
+{
+    ulLastTickTimestamp = GPTM_WTimer0Read();
+    xLastTickCount = xTaskGetTickCountFromISR();
+}
+
+uint8 TaskMonitor_GetCount(void)
+{
+    return ucMonitorsCount;
+}
+
+const TaskMonitor *TaskMonitor_Get(uint8 ucIndex)
+{
+    return (ucIndex < ucMonitorsCount) ? pxMonitors[ucIndex] : NULL_PTR;
+}
@@ -0,0 +1,81 @@
+ /******************************************************************************
+ *
+ * Module: TaskMonitor
+ *
+ * File Name: task_monitor.h
+ *
+ * Description: Header file for the periodic task release and deadline monitor
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef TASK_MONITOR_H_
+#define TASK_MONITOR_H_
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Maximum number of periodic tasks that can be registered for reporting */
+#define TASK_MONITOR_MAX_TASKS              (8U)
+
+/* All monitor times are in WTimer0 units (0.1 ms) */
+#define TASK_MONITOR_UNITS_PER_MS           (10U)
+#define TASK_MONITOR_UNITS_PER_TICK         ((TASK_MONITOR_UNITS_PER_MS * 1000U) / configTICK_RATE_HZ)
+
+/* Lateness histogram: bin n counts releases late by [n, n+1) * BIN_WIDTH,
+ * the last bin also counts everything later than that */
+#define TASK_MONITOR_HISTOGRAM_BINS         (8U)
+#define TASK_MONITOR_HISTOGRAM_BIN_WIDTH    (TASK_MONITOR_UNITS_PER_MS)
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct
+{
+    const char *pcName;
+    TickType_t xPeriod;             /* Release period in ticks */
+    TickType_t xPhase;              /* Offset of the first release in ticks */
+    uint32 ulDeadline;              /* Relative deadline in 0.1 ms */
+    TickType_t xLastRelease;        /* Tick of the current release */
+    uint32 ulReleaseTimestamp;      /* WTimer0 time of the current (nominal) release */
+    uint32 ulReleases;
+    uint32 ulDeadlineMisses;
+    uint32 ulMinLateness;
+    uint32 ulMaxLateness;
+    uint32 ulMaxResponse;
+    uint32 ulHistogram[TASK_MONITOR_HISTOGRAM_BINS];
+}TaskMonitor;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Call before the scheduler starts, the first release happens at tick xPhase */
+extern void TaskMonitor_Init(TaskMonitor *pxMonitor, const char *pcName,
+                             TickType_t xPeriod, TickType_t xDeadline, TickType_t xPhase);
+
+/* Restart the releases of a task that was parked, keeping its phase relative
+ * to xBase so tasks restarted from the same base keep their spacing */
+extern void TaskMonitor_Restart(TaskMonitor *pxMonitor, TickType_t xBase);
+
+/* Block until the next release and record how late the task was released */
+extern void TaskMonitor_WaitForRelease(TaskMonitor *pxMonitor);
+
+/* Call when the job of the current release is finished */
+extern void TaskMonitor_JobDone(TaskMonitor *pxMonitor);
+
+/* Must be called from vApplicationTickHook() */
+extern void TaskMonitor_TickHook(void);
+
+extern uint8 TaskMonitor_GetCount(void);
+
+extern const TaskMonitor *TaskMonitor_Get(uint8 ucIndex);
+
+#endif /* TASK_MONITOR_H_ */
@@ -0,0 +1,194 @@
+ /******************************************************************************
+ *
+ * Module: Telemetry
+ *
+ * File Name: telemetry.c
+ *
+ * Description: Source file for the binary seat state telemetry frames.
+ *              Frames are COBS encoded so 0x00 never appears inside a frame
+ *              and the host can resynchronize on the next delimiter after a
+ *              lost or corrupted byte. The producers only build the payload,
+ *              the UART gatekeeper numbers, checks and encodes it when it is
+ *              sent, so the sequence follows the order on the line.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#include "telemetry.h"
+#include "crc16.h"
+#include "uart_gatekeeper.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#if (TELEMETRY_FRAME_MAX > UART_GATEKEEPER_MESSAGE_SIZE)
+#error "A telemetry frame must fit in one UART gatekeeper message"
+#endif
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static uint8 ucSequence = 0;       /* Only used by the UART gatekeeper */
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+/* COBS encode ucLength bytes (less than 254) and append the delimiter,
+ * returns the length of the frame */
+static uint8 prvCobsEncode(const uint8 *pucData, uint8 ucLength, uint8 *pucFrame)
+{
+    uint8 ucCodeIndex = 0;
+    uint8 ucOut = 1;
+    uint8 ucIndex;
+
+    for (ucIndex = 0; ucIndex < ucLength; ucIndex++)
+    {
+        if (pucData[ucIndex] == TELEMETRY_FRAME_DELIMITER)
+        {
+            pucFrame[ucCodeIndex] = ucOut - ucCodeIndex;
+            ucCodeIndex = ucOut++;
+        }
+        else
+        {
+            pucFrame[ucOut++] = pucData[ucIndex];
+        }
+    }
+    pucFrame[ucCodeIndex] = ucOut - ucCodeIndex;
+    pucFrame[ucOut++] = TELEMETRY_FRAME_DELIMITER;
+
+    return ucOut;
+}
+
+/* Run by the UART gatekeeper: stamps the sequence and the CRC on the payload
+ * in pucData and replaces it with the COBS frame */
+static uint8 prvEncodeFrame(uint8 *pucData, uint8 ucLength)
+{
+    uint8 ucPayload[TELEMETRY_HEADER_SIZE + TELEMETRY_BODY_MAX + TELEMETRY_CRC_SIZE];
+    uint8 ucIndex;
+    uint16 usCrc;
+
+    for (ucIndex = 0; ucIndex < ucLength; ucIndex++)
+    {
+        ucPayload[ucIndex] = pucData[ucIndex];
+    }
+    ucPayload[2] = ucSequence++;
+
+    usCrc = CRC16_Compute(ucPayload, ucLength);
+    ucPayload[ucLength++] = (uint8)(usCrc & 0xFF);
+    ucPayload[ucLength++] = (uint8)(usCrc >> 8);
+
+    return prvCobsEncode(ucPayload, ucLength, pucData);
+}
+
+/* Write the payload without sequence and CRC into pxMessage, the gatekeeper
+ * completes it. Returns the length the frame will have on the line. */
+static uint8 prvBuildPayload(UartMessage *pxMessage, uint8 ucType, const uint8 *pucBody, uint8 ucLength)
+{
+    uint8 ucIndex;
+
+    pxMessage->ucData[0] = TELEMETRY_VERSION;
+    pxMessage->ucData[1] = ucType;
+    pxMessage->ucData[2] = 0;
+    for (ucIndex = 0; ucIndex < ucLength; ucIndex++)
+    {
+        pxMessage->ucData[TELEMETRY_HEADER_SIZE + ucIndex] = pucBody[ucIndex];
+    }
+    pxMessage->ucLength = TELEMETRY_HEADER_SIZE + ucLength;
+    pxMessage->pfEncode = prvEncodeFrame;
+
+    /* COBS adds one byte below 254 payload bytes, then the delimiter */
+    return pxMessage->ucLength + TELEMETRY_CRC_SIZE + 2U;
+}
+
+/* Body layout in TELEMETRY_SEAT_STATE_BODY */
+static void prvSeatStateBody(const TelemetrySeatState *pxState, uint8 *pucBody)
+{
+    pucBody[0] = pxState->ucSeat;
+    pucBody[1] = (uint8)((uint16)pxState->sTemperature & 0xFF);
+    pucBody[2] = (uint8)((uint16)pxState->sTemperature >> 8);
+    pucBody[3] = pxState->ucDesired;
+    pucBody[4] = pxState->ucIntensity;
+    pucBody[5] = pxState->ucFlags;
+}
+
+/* Body layout of a seat delta, returns its length */
+static uint8 prvSeatDeltaBody(const TelemetrySeatState *pxState, uint8 ucFields, uint8 *pucBody)
+{
+    uint8 ucLength = 0;
+
+    pucBody[ucLength++] = pxState->ucSeat;
+    pucBody[ucLength++] = ucFields;
+    if (ucFields & TELEMETRY_FIELD_TEMPERATURE)
+    {
+        pucBody[ucLength++] = (uint8)((uint16)pxState->sTemperature & 0xFF);
+        pucBody[ucLength++] = (uint8)((uint16)pxState->sTemperature >> 8);
+    }
+    if (ucFields & TELEMETRY_FIELD_DESIRED)
+    {
+        pucBody[ucLength++] = pxState->ucDesired;
+    }
+    if (ucFields & TELEMETRY_FIELD_INTENSITY)
+    {
+        pucBody[ucLength++] = pxState->ucIntensity;
+    }
+    if (ucFields & TELEMETRY_FIELD_FLAGS)
+    {
+        pucBody[ucLength++] = pxState->ucFlags;
+    }
+
+    return ucLength;
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+uint8 Telemetry_SendFrame(uint8 ucType, const uint8 *pucBody, uint8 ucLength)
+{
+    UartMessage *pxMessage = UartGatekeeper_Alloc(TRUE);
+    uint8 ucFrameLength;
+
+    ucFrameLength = prvBuildPayload(pxMessage, ucType, pucBody, ucLength);
+    UartGatekeeper_Send(pxMessage);
+
+    return ucFrameLength;
+}
+
+uint8 Telemetry_SendSeatState(const TelemetrySeatState *pxState)
+{
+    UartMessage *pxMessage = UartGatekeeper_Alloc(FALSE);
+    uint8 ucBody[TELEMETRY_SEAT_STATE_BODY];
+    uint8 ucFrameLength;
+
+    if (pxMessage == NULL)
+    {
+        return 0;
+    }
+    prvSeatStateBody(pxState, ucBody);
+    ucFrameLength = prvBuildPayload(pxMessage, TELEMETRY_TYPE_SEAT_STATE, ucBody, TELEMETRY_SEAT_STATE_BODY);
+    UartGatekeeper_Post(pxState->ucSeat, pxMessage);
+
+    return ucFrameLength;
+}
+
+uint8 Telemetry_SendSeatDelta(const TelemetrySeatState *pxState, uint8 ucFields)
+{
+    UartMessage *pxMessage = UartGatekeeper_Alloc(FALSE);
+    uint8 ucBody[TELEMETRY_SEAT_STATE_BODY + 1U];
+    uint8 ucFrameLength;
+    uint8 ucLength;
+
+    if (pxMessage == NULL)
+    {
+        return 0;
+    }
+    ucLength = prvSeatDeltaBody(pxState, ucFields, ucBody);
+    ucFrameLength = prvBuildPayload(pxMessage, TELEMETRY_TYPE_SEAT_DELTA, ucBody, ucLength);
+    UartGatekeeper_Post(pxState->ucSeat, pxMessage);
+
+    return ucFrameLength;
+}
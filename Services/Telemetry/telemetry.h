@@ -0,0 +1,89 @@
+ /******************************************************************************
+ *
+ * Module: Telemetry
+ *
+ * File Name: telemetry.h
+ *
+ * Description: Header file for the binary seat state telemetry frames
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Bump when the payload layout changes, the decoder rejects unknown versions */
+#define TELEMETRY_VERSION               (1U)
+
+#define TELEMETRY_TYPE_SEAT_STATE       (0x01U)
+#define TELEMETRY_TYPE_LOG              (0x02U)
+#define TELEMETRY_TYPE_SEAT_DELTA       (0x03U)
+
+/* Payload of every frame: [0] version  [1] type  [2] sequence  then the body,
+ * followed by the CRC-16/CCITT-FALSE of the payload (little endian).
+ * The whole is COBS encoded and terminated by a 0x00 delimiter. The UART
+ * gatekeeper stamps the sequence as it sends the frame, so a gap on the host
+ * is a frame lost on the line, not a coalesced seat state. */
+#define TELEMETRY_HEADER_SIZE           (3U)
+#define TELEMETRY_CRC_SIZE              (2U)
+#define TELEMETRY_BODY_MAX              (48U)
+
+/* Seat state body (little endian):
+ *   [0] seat  [1..2] temperature in 0.1 C (sint16)  [3] desired level (C)
+ *   [4] heat intensity  [5] flags */
+#define TELEMETRY_SEAT_STATE_BODY       (6U)
+#define TELEMETRY_SEAT_STATE_FRAME      (TELEMETRY_HEADER_SIZE + TELEMETRY_SEAT_STATE_BODY + TELEMETRY_CRC_SIZE + 2U)
+
+/* Seat delta body: [0] seat  [1] fields  then the value of every field set,
+ * in the order of the seat state body */
+#define TELEMETRY_FIELD_TEMPERATURE     (0x01U)
+#define TELEMETRY_FIELD_DESIRED         (0x02U)
+#define TELEMETRY_FIELD_INTENSITY       (0x04U)
+#define TELEMETRY_FIELD_FLAGS           (0x08U)
+#define TELEMETRY_FIELDS_ALL            (0x0FU)
+
+/* COBS adds one byte per 254 data bytes, plus the delimiter */
+#define TELEMETRY_FRAME_MAX             (TELEMETRY_HEADER_SIZE + TELEMETRY_BODY_MAX + TELEMETRY_CRC_SIZE + 2U)
+
+#define TELEMETRY_FRAME_DELIMITER       (0x00U)
+
+/* Flags */
+#define TELEMETRY_FLAG_SLOW_SAMPLING    (0x01U)
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint8 ucSeat;
+    sint16 sTemperature;            /* 0.1 C */
+    uint8 ucDesired;                /* UserHeatInput value */
+    uint8 ucIntensity;              /* HeatIntensity value */
+    uint8 ucFlags;
+}TelemetrySeatState;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Queue a frame of ucLength (up to TELEMETRY_BODY_MAX) body bytes behind the
+ * pending UART0 output, blocks while the gatekeeper FIFO is full. The Send
+ * functions return the length the frame will have on the line. */
+extern uint8 Telemetry_SendFrame(uint8 ucType, const uint8 *pucBody, uint8 ucLength);
+
+/* Hand a seat state to the UART0 gatekeeper, it replaces the
+ * state of the same seat that is not sent yet. Never blocks. */
+extern uint8 Telemetry_SendSeatState(const TelemetrySeatState *pxState);
+
+/* Same for the ucFields (TELEMETRY_FIELD_*) of a seat state only */
+extern uint8 Telemetry_SendSeatDelta(const TelemetrySeatState *pxState, uint8 ucFields);
+
+#endif /* TELEMETRY_H_ */
@@ -0,0 +1,235 @@
+ /******************************************************************************
+ *
+ * Module: UartGatekeeper
+ *
+ * File Name: uart_gatekeeper.c
+ *
+ * Description: Source file for the UART0 gatekeeper. Only the gatekeeper task
+ *              writes to UART0: the producers build complete messages in
+ *              blocks of a fixed-block pool and hand them over by pointer,
+ *              so nobody waits for the 9600 baud line while holding a lock
+ *              and no message is copied. The bytes are sent by the UART0
+ *              interrupt, the gatekeeper sleeps while the line drains its
+ *              buffer instead of polling it. The seat states only matter in
+ *              their latest value, so each seat has a one message slot that
+ *              is replaced and sent ahead of the FIFO output.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#include "uart_gatekeeper.h"
+#include "task.h"
+#include "queue.h"
+#include "uart0.h"
+#include "GPTM.h"
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+POOL_DEFINE(xUartMessagePool, sizeof(UartMessage), UART_GATEKEEPER_MESSAGES);
+
+/* Latest message of each seat, swapped in a critical section */
+static UartMessage *pxSlots[UART_GATEKEEPER_SLOTS];
+static QueueHandle_t xFifo = NULL_PTR;      /* Of UartMessage pointers */
+static TaskHandle_t xGatekeeperTask = NULL_PTR;
+
+static UartGatekeeperStats xStats = { 0, 0, 0, 0 };
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void prvWakeGatekeeper(void)
+{
+    if (xGatekeeperTask != NULL_PTR)
+    {
+        xTaskNotifyGive(xGatekeeperTask);
+    }
+}
+
+/* Called by the UART0 handler when the TX buffer has emptied */
+static void prvTxDrainedCallback(void)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    if (xGatekeeperTask != NULL_PTR)
+    {
+        vTaskNotifyGiveFromISR(xGatekeeperTask, &xHigherPriorityTaskWoken);
+    }
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+/* The notification also wakes the gatekeeper for new output, a wake up with
+ * bytes still buffered only means another wait */
+static void prvWaitTxDrained(void)
+{
+    while (UART0_GetTxPending() != 0)
+    {
+        (void) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
+
+/* Highest priority pending message: the slots in order, then the FIFO */
+static UartMessage *prvNextMessage(void)
+{
+    UartMessage *pxMessage = NULL_PTR;
+    uint8 ucSlot;
+
+    for (ucSlot = 0; (ucSlot < UART_GATEKEEPER_SLOTS) && (pxMessage == NULL_PTR); ucSlot++)
+    {
+        taskENTER_CRITICAL();
+        pxMessage = pxSlots[ucSlot];
+        pxSlots[ucSlot] = NULL_PTR;
+        taskEXIT_CRITICAL();
+    }
+    if (pxMessage == NULL_PTR)
+    {
+        (void) xQueueReceive(xFifo, &pxMessage, 0);
+    }
+    return pxMessage;
+}
+
+static void prvTransmit(UartMessage *pxMessage)
+{
+    uint32 ulWait = GPTM_WTimer0Read() - pxMessage->ulTimestamp;
+    uint32 ulWritten = 0;
+
+    if (ulWait > xStats.ulMaxWait)
+    {
+        xStats.ulMaxWait = ulWait;
+    }
+    if (pxMessage->pfEncode != NULL_PTR)
+    {
+        pxMessage->ucLength = pxMessage->pfEncode(pxMessage->ucData, pxMessage->ucLength);
+    }
+    while (ulWritten < pxMessage->ucLength)
+    {
+        ulWritten += UART0_WriteTxBytes(&pxMessage->ucData[ulWritten], pxMessage->ucLength - ulWritten);
+        if (ulWritten < pxMessage->ucLength)
+        {
+            prvWaitTxDrained();
+        }
+    }
+    xStats.ulMessages++;
+    xStats.ulBytes += pxMessage->ucLength;
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void UartGatekeeper_Init(void)
+{
+    Pool_Init(&xUartMessagePool);
+    xFifo = xQueueCreate(UART_GATEKEEPER_QUEUE_LENGTH, sizeof(UartMessage *));
+    UART0_TxInterruptInit(prvTxDrainedCallback);
+}
+
+void UartGatekeeper_ProcessOutput(void)
+{
+    UartMessage *pxMessage;
+
+    xGatekeeperTask = xTaskGetCurrentTaskHandle();
+
+    while ((pxMessage = prvNextMessage()) != NULL_PTR)
+    {
+        if (pxMessage->pfAction != NULL_PTR)
+        {
+            prvWaitTxDrained();
+            pxMessage->pfAction(pxMessage->ulArgument);
+        }
+        else
+        {
+            prvTransmit(pxMessage);
+        }
+        Pool_Free(&xUartMessagePool, pxMessage);
+    }
+
+    (void) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+}
+
+UartMessage *UartGatekeeper_Alloc(boolean bWait)
+{
+    UartMessage *pxMessage;
+
+    while (((pxMessage = (UartMessage *) Pool_Alloc(&xUartMessagePool)) == NULL_PTR) && (bWait == TRUE))
+    {
+        vTaskDelay(UART_GATEKEEPER_ALLOC_RETRY_TICKS);
+    }
+    if (pxMessage != NULL_PTR)
+    {
+        pxMessage->pfAction = NULL_PTR;
+        pxMessage->pfEncode = NULL_PTR;
+        pxMessage->ucLength = 0;
+    }
+    return pxMessage;
+}
+
+void UartGatekeeper_Append(UartMessage *pxMessage, const char *pcText)
+{
+    while ((*pcText != '\0') && (pxMessage->ucLength < UART_GATEKEEPER_MESSAGE_SIZE))
+    {
+        pxMessage->ucData[pxMessage->ucLength++] = (uint8) *pcText++;
+    }
+}
+
+void UartGatekeeper_Post(uint8 ucSlot, UartMessage *pxMessage)
+{
+    UartMessage *pxReplaced;
+
+    pxMessage->pfAction = NULL_PTR;
+    pxMessage->ulTimestamp = GPTM_WTimer0Read();
+
+    taskENTER_CRITICAL();
+    pxReplaced = pxSlots[ucSlot];
+    pxSlots[ucSlot] = pxMessage;
+    if (pxReplaced != NULL_PTR)
+    {
+        xStats.ulCoalesced++;
+    }
+    taskEXIT_CRITICAL();
+
+    if (pxReplaced != NULL_PTR)
+    {
+        Pool_Free(&xUartMessagePool, pxReplaced);
+    }
+    prvWakeGatekeeper();
+}
+
+boolean UartGatekeeper_IsPending(uint8 ucSlot)
+{
+    return (pxSlots[ucSlot] != NULL_PTR) ? TRUE : FALSE;
+}
+
+void UartGatekeeper_Send(UartMessage *pxMessage)
+{
+    pxMessage->pfAction = NULL_PTR;
+    pxMessage->ulTimestamp = GPTM_WTimer0Read();
+
+    (void) xQueueSend(xFifo, &pxMessage, portMAX_DELAY);
+    prvWakeGatekeeper();
+}
+
+void UartGatekeeper_Call(UartGatekeeperAction pfAction, uint32 ulArgument)
+{
+    UartMessage *pxCall = UartGatekeeper_Alloc(TRUE);
+
+    pxCall->pfAction = pfAction;
+    pxCall->ulArgument = ulArgument;
+    pxCall->ulTimestamp = GPTM_WTimer0Read();
+
+    (void) xQueueSend(xFifo, &pxCall, portMAX_DELAY);
+    prvWakeGatekeeper();
+}
+
+const UartGatekeeperStats *UartGatekeeper_GetStats(void)
+{
+    return &xStats;
+}
+
+const Pool *UartGatekeeper_GetPool(void)
+{
+    return &xUartMessagePool;
+}
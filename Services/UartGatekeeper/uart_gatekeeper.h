@@ -0,0 +1,111 @@
+ /******************************************************************************
+ *
+ * Module: UartGatekeeper
+ *
+ * File Name: uart_gatekeeper.h
+ *
+ * Description: Header file for the UART0 gatekeeper task
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef UART_GATEKEEPER_H_
+#define UART_GATEKEEPER_H_
+
+#include "FreeRTOS.h"
+#include "std_types.h"
+#include "pool.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Largest message, the text seat block of the display is the longest one */
+#define UART_GATEKEEPER_MESSAGE_SIZE    (120U)
+
+/* Latest value slots (one per seat): a new message replaces the pending one */
+#define UART_GATEKEEPER_SLOTS           (2U)
+
+/* FIFO messages (log frames, console replies) waiting for the UART */
+#define UART_GATEKEEPER_QUEUE_LENGTH    (4U)
+
+/* Message blocks in the pool: the FIFO and the slots full, one being sent
+ * and one being built by each display task and one low priority producer */
+#define UART_GATEKEEPER_MESSAGES        (UART_GATEKEEPER_QUEUE_LENGTH + (2U * UART_GATEKEEPER_SLOTS) + 2U)
+
+/* Ticks a low priority producer waits at a time for a free message block */
+#define UART_GATEKEEPER_ALLOC_RETRY_TICKS   (1U)
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+/* Run by the gatekeeper between two messages, while nothing is being sent */
+typedef void (*UartGatekeeperAction)(uint32 ulArgument);
+
+/* Run by the gatekeeper on the data of a message right before it is sent,
+ * returns the new length. The gatekeeper is the only task that runs it, so
+ * it can number the messages in the order they reach the line. */
+typedef uint8 (*UartGatekeeperEncoder)(uint8 *pucData, uint8 ucLength);
+
+typedef struct
+{
+    UartGatekeeperAction pfAction;  /* NULL_PTR for a message to send */
+    UartGatekeeperEncoder pfEncode; /* NULL_PTR to send the data as it is */
+    uint32 ulArgument;
+    uint32 ulTimestamp;             /* WTimer0 time it was handed over */
+    uint8 ucLength;
+    uint8 ucData[UART_GATEKEEPER_MESSAGE_SIZE];
+}UartMessage;
+
+typedef struct
+{
+    uint32 ulMessages;
+    uint32 ulBytes;
+    uint32 ulCoalesced;             /* Slot messages replaced before they were sent */
+    uint32 ulMaxWait;               /* Hand over to first byte sent, in 0.1 ms */
+}UartGatekeeperStats;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Call before the scheduler starts */
+extern void UartGatekeeper_Init(void);
+
+/* Body of the gatekeeper task: sends the slot messages first, then the FIFO
+ * ones, and blocks until more output is handed over */
+extern void UartGatekeeper_ProcessOutput(void);
+
+/* Take an empty message from the pool. With bWait FALSE it returns NULL_PTR
+ * when the pool is empty, with TRUE it waits for a block (low priority
+ * producers only). The message belongs to the caller until it is posted or
+ * sent, it is never copied after that. */
+extern UartMessage *UartGatekeeper_Alloc(boolean bWait);
+
+/* Append a string, what does not fit is cut */
+extern void UartGatekeeper_Append(UartMessage *pxMessage, const char *pcText);
+
+/* Replace the pending message of ucSlot (it goes back to the pool), never blocks */
+extern void UartGatekeeper_Post(uint8 ucSlot, UartMessage *pxMessage);
+
+/* TRUE while a message posted to ucSlot waits for the UART, the next post
+ * would replace it */
+extern boolean UartGatekeeper_IsPending(uint8 ucSlot);
+
+/* Queue a message behind the pending ones, blocks while the FIFO is full,
+ * so only for the low priority producers */
+extern void UartGatekeeper_Send(UartMessage *pxMessage);
+
+/* Queue pfAction to run in the gatekeeper when the messages before it are
+ * sent, for what must not happen in the middle of a byte (clock switch).
+ * Waits for a message block like UartGatekeeper_Alloc(TRUE). */
+extern void UartGatekeeper_Call(UartGatekeeperAction pfAction, uint32 ulArgument);
+
+extern const UartGatekeeperStats *UartGatekeeper_GetStats(void);
+
+/* Blocks used, high-water mark and failed allocations of the message pool */
+extern const Pool *UartGatekeeper_GetPool(void);
+
+#endif /* UART_GATEKEEPER_H_ */
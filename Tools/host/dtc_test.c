@@ -0,0 +1,266 @@
+ /******************************************************************************
+ *
+ * Module: Tools - Host Tests
+ *
+ * File Name: dtc_test.c
+ *
+ * Description: Tests of Services/Dtc: the debounce thresholds in samples to
+ *              fail and to heal, the status bits over the operation cycles,
+ *              the aging of a confirmed DTC, the snapshots and the single
+ *              fault log entry of a confirmation. The tick count and the
+ *              store are stubbed.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#include "host_test.h"
+#include "dtc.h"
+#include "task.h"
+#include "store.h"
+#include "intensity_cfg.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Samples from the count of 0, from a healed DTC, and to heal */
+#define SAMPLES_TO_FAIL             (DTC_FAIL_LIMIT / DTC_FAIL_STEP)
+#define SAMPLES_TO_FAIL_HEALED      ((DTC_FAIL_LIMIT + DTC_PASS_LIMIT) / DTC_FAIL_STEP)
+#define SAMPLES_TO_HEAL             ((DTC_FAIL_LIMIT + DTC_PASS_LIMIT) / DTC_PASS_STEP)
+
+#define STATUS_FAILED               (DTC_STATUS_TEST_FAILED | DTC_STATUS_FAILED_THIS_CYCLE | \
+                                     DTC_STATUS_PENDING | DTC_STATUS_CONFIRMED)
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static TickType_t xTicks = 0;
+
+/* What the snapshot callback reports */
+static sint16 sSnapshotTemperature = 0;
+
+/* Store_LogFault() calls */
+static uint32 ulLogged = 0;
+static uint8 ucLoggedSeat, ucLoggedCode, ucLoggedLevel;
+static sint16 sLoggedReading;
+
+/*******************************************************************************
+ *                               Kernel Stubs                                  *
+ *******************************************************************************/
+
+TickType_t xTaskGetTickCount(void)
+{
+    return xTicks;
+}
+
+void Store_LogFault(uint8 ucSeat, uint8 ucCode, sint16 sReading, uint8 ucLevel)
+{
+    ulLogged++;
+    ucLoggedSeat = ucSeat;
+    ucLoggedCode = ucCode;
+    sLoggedReading = sReading;
+    ucLoggedLevel = ucLevel;
+}
+
+static void prvSnapshot(DtcSnapshot *pxSnapshot)
+{
+    uint8 ucSeat;
+
+    for (ucSeat = 0; ucSeat < DTC_SEATS; ucSeat++)
+    {
+        pxSnapshot->sTemperature[ucSeat] = (sint16) (sSnapshotTemperature + ucSeat);
+        pxSnapshot->ucLevel[ucSeat] = (uint8) (ucSeat + 1U);
+    }
+}
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void prvReport(uint8 ucId, boolean bFailed, uint32 ulSamples)
+{
+    while (ulSamples-- > 0U)
+    {
+        Dtc_Report(ucId, bFailed);
+    }
+}
+
+static void prvTestThresholds(void)
+{
+    const uint8 ucId = DTC_ID(1, DTC_SENSOR_HIGH);
+    uint32 ulConfirmed = Dtc_GetStats()->ulConfirmed;
+    DtcRecord xRecord;
+
+    Dtc_Init(prvSnapshot);
+    ulLogged = 0;
+    xTicks = 7U * configTICK_RATE_HZ;
+    sSnapshotTemperature = 455;
+
+    /* One sample short of the limit sets nothing */
+    prvReport(ucId, TRUE, SAMPLES_TO_FAIL - 1U);
+    HOST_CHECK(Dtc_GetStatus(ucId) == 0U);
+    HOST_CHECK(ulLogged == 0U);
+
+    /* The next one qualifies and confirms the failure, logged once */
+    prvReport(ucId, TRUE, 1);
+    HOST_CHECK(Dtc_GetStatus(ucId) == STATUS_FAILED);
+    HOST_CHECK(Dtc_GetStats()->ulConfirmed == ulConfirmed + 1U);
+    HOST_CHECK(ulLogged == 1U);
+    HOST_CHECK((ucLoggedSeat == 1U) && (ucLoggedCode == ucId) && (sLoggedReading == 456) && (ucLoggedLevel == 2U));
+    Dtc_GetRecord(ucId, &xRecord);
+    HOST_CHECK((xRecord.ucOccurrences == 1U) && (xRecord.scCounter == DTC_FAIL_LIMIT));
+    HOST_CHECK((xRecord.xFirst.ulTime == 7U) && (xRecord.xLast.ulTime == 7U));
+    HOST_CHECK(xRecord.xFirst.sTemperature[0] == 455);
+
+    /* Staying failed is not a new failure */
+    prvReport(ucId, TRUE, 20);
+    Dtc_GetRecord(ucId, &xRecord);
+    HOST_CHECK((xRecord.ucOccurrences == 1U) && (ulLogged == 1U));
+
+    /* Healing takes the full swing of the counter */
+    prvReport(ucId, FALSE, SAMPLES_TO_HEAL - 1U);
+    HOST_CHECK(Dtc_GetStatus(ucId) & DTC_STATUS_TEST_FAILED);
+    prvReport(ucId, FALSE, 1);
+    HOST_CHECK(Dtc_GetStatus(ucId) == (STATUS_FAILED & ~DTC_STATUS_TEST_FAILED));
+    prvReport(ucId, FALSE, 50);
+    Dtc_GetRecord(ucId, &xRecord);
+    HOST_CHECK(xRecord.scCounter == -DTC_PASS_LIMIT);
+
+    /* From a healed DTC: a single wild sample sets nothing, the limit takes longer */
+    prvReport(ucId, TRUE, 1);
+    prvReport(ucId, FALSE, 1);
+    HOST_CHECK(!(Dtc_GetStatus(ucId) & DTC_STATUS_TEST_FAILED));
+    Dtc_GetRecord(ucId, &xRecord);
+    HOST_CHECK(xRecord.scCounter == -DTC_PASS_LIMIT + DTC_FAIL_STEP - DTC_PASS_STEP);
+    prvReport(ucId, FALSE, 1);
+
+    xTicks = 30U * configTICK_RATE_HZ;
+    sSnapshotTemperature = 470;
+    prvReport(ucId, TRUE, SAMPLES_TO_FAIL_HEALED - 1U);
+    HOST_CHECK(!(Dtc_GetStatus(ucId) & DTC_STATUS_TEST_FAILED));
+    prvReport(ucId, TRUE, 1);
+    HOST_CHECK(Dtc_GetStatus(ucId) & DTC_STATUS_TEST_FAILED);
+
+    /* Already confirmed: counted and snapshot again, not logged or confirmed again */
+    Dtc_GetRecord(ucId, &xRecord);
+    HOST_CHECK(xRecord.ucOccurrences == 2U);
+    HOST_CHECK((xRecord.xFirst.ulTime == 7U) && (xRecord.xLast.ulTime == 30U));
+    HOST_CHECK(xRecord.xLast.sTemperature[0] == 470);
+    HOST_CHECK((ulLogged == 1U) && (Dtc_GetStats()->ulConfirmed == ulConfirmed + 1U));
+
+    /* The other DTCs were never reported */
+    HOST_CHECK(Dtc_GetStatus(DTC_ID(0, DTC_SENSOR_HIGH)) == 0U);
+    HOST_CHECK(Dtc_GetStatus(DTC_ID(1, DTC_SENSOR_LOW)) == 0U);
+}
+
+static void prvTestAging(void)
+{
+    const uint8 ucId = DTC_ID(0, DTC_SENSOR_LOW);
+    const uint8 ucOther = DTC_ID(1, DTC_SENSOR_LOW);
+    uint32 ulAged = Dtc_GetStats()->ulAged;
+    DtcRecord xRecord;
+    uint8 ucCycle;
+
+    Dtc_Init(prvSnapshot);
+    prvReport(ucId, TRUE, SAMPLES_TO_FAIL);
+    prvReport(ucOther, TRUE, SAMPLES_TO_FAIL);
+    prvReport(ucId, FALSE, SAMPLES_TO_HEAL);
+
+    /* The cycle it failed in ends: still pending, aging starts after it */
+    Dtc_StartCycle(0);
+    HOST_CHECK(Dtc_GetStatus(ucId) == (DTC_STATUS_PENDING | DTC_STATUS_CONFIRMED));
+
+    /* Cycles without a failure: pending is gone, confirmed until aged */
+    for (ucCycle = 1; ucCycle < DTC_AGING_CYCLES; ucCycle++)
+    {
+        Dtc_StartCycle(0);
+        HOST_CHECK(Dtc_GetStatus(ucId) == DTC_STATUS_CONFIRMED);
+        Dtc_GetRecord(ucId, &xRecord);
+        HOST_CHECK(xRecord.ucAging == ucCycle);
+    }
+
+    /* A failure resets the aging */
+    prvReport(ucId, TRUE, SAMPLES_TO_FAIL_HEALED);
+    prvReport(ucId, FALSE, SAMPLES_TO_HEAL);
+    Dtc_GetRecord(ucId, &xRecord);
+    HOST_CHECK((xRecord.ucAging == 0U) && (xRecord.ucOccurrences == 2U));
+    Dtc_StartCycle(0);
+    for (ucCycle = 1; ucCycle < DTC_AGING_CYCLES; ucCycle++)
+    {
+        Dtc_StartCycle(0);
+    }
+    HOST_CHECK(Dtc_GetStatus(ucId) == DTC_STATUS_CONFIRMED);
+
+    /* The last cycle forgets it */
+    Dtc_StartCycle(0);
+    HOST_CHECK(Dtc_GetStatus(ucId) == 0U);
+    HOST_CHECK(Dtc_GetStats()->ulAged == ulAged + 1U);
+    Dtc_GetRecord(ucId, &xRecord);
+    HOST_CHECK((xRecord.ucOccurrences == 0U) && (xRecord.ucAging == 0U));
+
+    /* Only the cycles of its own seat age a DTC */
+    HOST_CHECK(Dtc_GetStatus(ucOther) == STATUS_FAILED);
+
+    /* A DTC that stays failed over the cycles never ages */
+    for (ucCycle = 0; ucCycle < (2U * DTC_AGING_CYCLES); ucCycle++)
+    {
+        Dtc_StartCycle(1);
+        HOST_CHECK(Dtc_GetStatus(ucOther) == (STATUS_FAILED & ~DTC_STATUS_FAILED_THIS_CYCLE));
+        prvReport(ucOther, TRUE, 1);
+        HOST_CHECK(Dtc_GetStatus(ucOther) == STATUS_FAILED);
+    }
+}
+
+static void prvTestSensor(void)
+{
+    uint8 ucIds[DTC_COUNT];
+    uint8 ucSample;
+
+    Dtc_Init(prvSnapshot);
+
+    /* The range limits themselves are trusted */
+    for (ucSample = 0; ucSample < SAMPLES_TO_FAIL; ucSample++)
+    {
+        Dtc_ReportSensor(0, TEMPERATURE_FROM_C(INTENSITY_SENSOR_MIN_C));
+        Dtc_ReportSensor(1, TEMPERATURE_FROM_C(INTENSITY_SENSOR_MAX_C));
+    }
+    HOST_CHECK(Dtc_Find(DTC_STATUS_ALL, ucIds) == 0U);
+
+    Dtc_Init(prvSnapshot);
+    for (ucSample = 0; ucSample < SAMPLES_TO_FAIL; ucSample++)
+    {
+        Dtc_ReportSensor(0, TEMPERATURE_FROM_C(INTENSITY_SENSOR_MAX_C + 1));
+        Dtc_ReportSensor(1, TEMPERATURE_FROM_C(INTENSITY_SENSOR_MIN_C - 1));
+    }
+    HOST_CHECK(Dtc_Find(DTC_STATUS_TEST_FAILED, ucIds) == 2U);
+    HOST_CHECK((ucIds[0] == DTC_ID(0, DTC_SENSOR_HIGH)) && (ucIds[1] == DTC_ID(1, DTC_SENSOR_LOW)));
+    HOST_CHECK(Dtc_GetStatus(DTC_ID(0, DTC_SENSOR_LOW)) == 0U);
+    HOST_CHECK(Dtc_GetStats()->ulMaxCycles > 0U);
+
+    HOST_CHECK(Dtc_GetName(DTC_ID(1, DTC_SENSOR_LOW))[0] == 'p');
+    HOST_CHECK(Dtc_GetName(DTC_COUNT)[0] == '?');
+
+    /* Clear drops the status, the counters go on: a sensor still out of
+     * range is confirmed again at its next sample */
+    Dtc_Clear();
+    HOST_CHECK(Dtc_Find(DTC_STATUS_ALL, ucIds) == 0U);
+    Dtc_ReportSensor(0, TEMPERATURE_FROM_C(INTENSITY_SENSOR_MAX_C + 1));
+    HOST_CHECK(Dtc_GetStatus(DTC_ID(0, DTC_SENSOR_HIGH)) == STATUS_FAILED);
+    Dtc_ReportSensor(1, TEMPERATURE_FROM_C(INTENSITY_SENSOR_MIN_C));
+    HOST_CHECK(Dtc_GetStatus(DTC_ID(1, DTC_SENSOR_LOW)) == 0U);
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+int main(void)
+{
+    prvTestThresholds();
+    prvTestAging();
+    prvTestSensor();
+
+    return HOST_TEST_RESULT("dtc_test");
+}
@@ -0,0 +1,204 @@
+ /******************************************************************************
+ *
+ * Module: Tools - Host Benchmarks
+ *
+ * File Name: format_bench.c
+ *
+ * Description: Cycles per conversion of Services/Format against the sint64
+ *              digit loop of the former UART0_SendInteger() and against
+ *              snprintf(), for small, medium and full range values. Every
+ *              output is first compared with snprintf(). The host divides
+ *              64-bit values in one instruction, the Cortex-M4 calls a
+ *              runtime library routine for each, so the host understates
+ *              the cost of the sint64 loop.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#include <string.h>
+
+#include "format.h"
+#include "host_bench.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define VALUES                      (4096U)
+#define ROUNDS                      (200U)
+#define CONVERSIONS                 (ROUNDS * VALUES)
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static sint32 slValues[VALUES];
+static uint8 ucBuffer[FORMAT_BUFFER_SIZE + 8];
+static uint32 ulMismatches = 0;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+/* UART0_SendInteger() of the original firmware, writing to a buffer */
+static uint8 prvSendInteger64(sint64 sNumber, uint8 *pucBuffer)
+{
+    uint8 uDigits[20];
+    sint8 uCounter = 0;
+    uint8 ucLength = 0;
+
+    if (sNumber < 0)
+    {
+        pucBuffer[ucLength++] = '-';
+        sNumber *= -1;
+    }
+
+    do
+    {
+        uDigits[uCounter++] = sNumber % 10 + '0';
+        sNumber /= 10;
+    }
+    while (sNumber != 0);
+
+    for (uCounter--; uCounter >= 0; uCounter--)
+    {
+        pucBuffer[ucLength++] = uDigits[uCounter];
+    }
+    pucBuffer[ucLength] = '\0';
+
+    return ucLength;
+}
+
+/* Tenths the way the original firmware would print them: two integer sends */
+static uint8 prvSendTenths64(sint64 sTenths, uint8 *pucBuffer)
+{
+    uint8 ucLength = 0;
+
+    if (sTenths < 0)
+    {
+        pucBuffer[ucLength++] = '-';
+        sTenths *= -1;
+    }
+    ucLength += prvSendInteger64(sTenths / 10, &pucBuffer[ucLength]);
+    pucBuffer[ucLength++] = '.';
+    ucLength += prvSendInteger64(sTenths % 10, &pucBuffer[ucLength]);
+
+    return ucLength;
+}
+
+static void prvCheck(const char *pcName, const uint8 *pucActual, const char *pcExpected)
+{
+    if (strcmp((const char *) pucActual, pcExpected) != 0)
+    {
+        if (ulMismatches < 10U)
+        {
+            printf("%s: \"%s\" instead of \"%s\"\n", pcName, (const char *) pucActual, pcExpected);
+        }
+        ulMismatches++;
+    }
+}
+
+static void prvCheckAll(void)
+{
+    char cExpected[32];
+    uint32 ulIndex;
+    sint32 slValue;
+
+    for (ulIndex = 0; ulIndex < VALUES; ulIndex++)
+    {
+        slValue = slValues[ulIndex];
+        snprintf(cExpected, sizeof(cExpected), "%ld", (long) slValue);
+        Format_Signed(slValue, ucBuffer);
+        prvCheck("Format_Signed", ucBuffer, cExpected);
+        prvSendInteger64(slValue, ucBuffer);
+        prvCheck("sint64 loop", ucBuffer, cExpected);
+
+        snprintf(cExpected, sizeof(cExpected), "%lu", (unsigned long) (uint32) slValue);
+        Format_Unsigned((uint32) slValue, ucBuffer);
+        prvCheck("Format_Unsigned", ucBuffer, cExpected);
+
+        snprintf(cExpected, sizeof(cExpected), "%s%ld.%ld", (slValue < 0) ? "-" : "",
+                 labs((long) (slValue / 10)), labs((long) (slValue % 10)));
+        Format_Fixed(slValue, 1, ucBuffer);
+        prvCheck("Format_Fixed", ucBuffer, cExpected);
+        prvSendTenths64(slValue, ucBuffer);
+        prvCheck("sint64 loop, tenths", ucBuffer, cExpected);
+
+        snprintf(cExpected, sizeof(cExpected), "%04lX", (unsigned long) (uint32) slValue);
+        Format_Hex((uint32) slValue, 4, ucBuffer);
+        prvCheck("Format_Hex", ucBuffer, cExpected);
+    }
+}
+
+/* Values: 0..999 (temperatures, levels), up to +-10^6 (counters) and the full range */
+static void prvFill(uint32 ulSet)
+{
+    uint32 ulIndex, ulSeed = 12345U;
+
+    for (ulIndex = 0; ulIndex < VALUES; ulIndex++)
+    {
+        ulSeed = (ulSeed * 1664525UL) + 1013904223UL;
+        if (ulSet == 0)
+        {
+            slValues[ulIndex] = (sint32) (ulSeed % 1000U);
+        }
+        else if (ulSet == 1)
+        {
+            slValues[ulIndex] = (sint32) (ulSeed % 2000001U) - 1000000;
+        }
+        else
+        {
+            slValues[ulIndex] = (sint32) ulSeed;
+        }
+    }
+    slValues[0] = (ulSet == 2) ? (sint32) 0x80000000UL : 0;
+}
+
+/* One timed loop over the values */
+#define FORMAT_BENCH(NAME, CONVERSION)                                          \
+    HOST_BENCH(NAME, CONVERSIONS,                                               \
+    {                                                                           \
+        uint32 ulRound, ulIndex, ulSum = 0;                                     \
+        for (ulRound = 0; ulRound < ROUNDS; ulRound++)                          \
+        {                                                                       \
+            for (ulIndex = 0; ulIndex < VALUES; ulIndex++)                      \
+            {                                                                   \
+                sint32 slValue = slValues[ulIndex];                             \
+                ulSum += (uint32) (CONVERSION);                                 \
+            }                                                                   \
+        }                                                                       \
+        ulHostBenchSink = ulSum + ucBuffer[0];                                  \
+    })
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+int main(void)
+{
+    static const char *const pcSets[] = { "0..999", "+-10^6", "full 32-bit range" };
+    uint32 ulSet;
+
+    for (ulSet = 0; ulSet < 3; ulSet++)
+    {
+        prvFill(ulSet);
+        prvCheckAll();
+
+        printf("%s\n", pcSets[ulSet]);
+        FORMAT_BENCH("sint64 loop (UART0_SendInteger)", prvSendInteger64(slValue, ucBuffer));
+        FORMAT_BENCH("snprintf %ld", snprintf((char *) ucBuffer, sizeof(ucBuffer), "%ld", (long) slValue));
+        FORMAT_BENCH("Format_Signed", Format_Signed(slValue, ucBuffer));
+        FORMAT_BENCH("sint64 loop, tenths", prvSendTenths64(slValue, ucBuffer));
+        FORMAT_BENCH("Format_Fixed, 1 decimal", Format_Fixed(slValue, 1, ucBuffer));
+        FORMAT_BENCH("snprintf %X", snprintf((char *) ucBuffer, sizeof(ucBuffer), "%lX", (unsigned long) (uint32) slValue));
+        FORMAT_BENCH("Format_Hex", Format_Hex((uint32) slValue, 0, ucBuffer));
+    }
+
+    if (ulMismatches != 0)
+    {
+        printf("%lu outputs differ from snprintf\n", (unsigned long) ulMismatches);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,299 @@
+ /******************************************************************************
+ *
+ * Module: Tools - Host Benchmarks
+ *
+ * File Name: heap_bench.c
+ *
+ * Description: Fragmentation and latency of the FreeRTOS heap on a
+ *              synthetic trace of the telemetry path, built once with
+ *              Services/Heap and once with heap_2.c (configHEAP_COALESCING).
+ *
+ *              The trace gives every record its own buffer, freed once the
+ *              UART sent it: the seat frames of both seats at each reading
+ *              release, bursts of log frames at each runtime report, text
+ *              and console replies of gatekeeper size, and the two tasks of
+ *              the context switch measurement. The task stacks, TCBs and
+ *              queues of main.c are allocated first and never freed. The
+ *              sizes and lifetimes come from a fixed seed, so both builds
+ *              run the same requests; the free of a failed request is
+ *              skipped.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "FreeRTOS.h"
+#include "host_bench.h"
+#include "context_switch.h"
+#include "telemetry.h"
+#include "uart_gatekeeper.h"
+#if (configHEAP_COALESCING == 1)
+#include "heap.h"
+#endif
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* One hour of 10 ms ticks */
+#define TRACE_TICKS                 (360000UL)
+
+/* Start-up allocations of main.c, never freed */
+#define START_UP_BYTES              (18U * 1024U)
+
+#define MAX_LIVE                    (256U)
+#define MAX_REQUESTS                (65536U)
+
+#define SEAT_PERIOD_TICKS           (20U)
+#define REPORT_PERIOD_TICKS         (1000U)
+#define REPORT_FRAMES               (12U)
+#define TEXT_PERIOD_TICKS           (50U)
+#define CSWITCH_PERIOD_TICKS        (6000U)
+
+/* Task control block of the ARM_CM4F port with the options of FreeRTOSConfig.h */
+#define TCB_BYTES                   (96U)
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct
+{
+    void *pvBlock;
+    uint32 ulFreeTick;
+}LiveBlock;
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static LiveBlock xLive[MAX_LIVE];
+static uint32 ulSeed = 2024U;
+
+static uint32 ulRequests = 0;
+static uint32 ulFailures = 0;
+static uint32 ulFailedBytes = 0;
+static size_t xMinimumFree = ~(size_t) 0;
+
+/* Cycles of every call, sorted for the percentiles at the end */
+static uint32 ulAllocCycles[MAX_REQUESTS];
+static uint32 ulFreeCycles[MAX_REQUESTS];
+static uint32 ulFrees = 0;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static uint32 prvRandom(uint32 ulRange)
+{
+    ulSeed = (ulSeed * 1664525UL) + 1013904223UL;
+    return (ulSeed >> 8) % ulRange;
+}
+
+static void *prvTimedMalloc(size_t xSize)
+{
+    uint64 ullStart = Host_Cycles();
+    void *pvBlock = pvPortMalloc(xSize);
+
+    configASSERT(ulRequests < MAX_REQUESTS);
+    ulAllocCycles[ulRequests] = (uint32) (Host_Cycles() - ullStart);
+    return pvBlock;
+}
+
+static void prvTimedFree(void *pvBlock)
+{
+    uint64 ullStart = Host_Cycles();
+
+    vPortFree(pvBlock);
+    configASSERT(ulFrees < MAX_REQUESTS);
+    ulFreeCycles[ulFrees++] = (uint32) (Host_Cycles() - ullStart);
+}
+
+static int prvCompareCycles(const void *pvA, const void *pvB)
+{
+    uint32 ulA = *(const uint32 *) pvA;
+    uint32 ulB = *(const uint32 *) pvB;
+
+    return (ulA > ulB) - (ulA < ulB);
+}
+
+/* Average, 99.9th percentile and maximum, the maximum also holds the
+ * interrupts and page faults of the host */
+static void prvPrintCycles(const char *pcName, uint32 *pulCycles, uint32 ulCount)
+{
+    uint64 ullSum = 0;
+    uint32 ulIndex;
+
+    qsort(pulCycles, ulCount, sizeof(uint32), prvCompareCycles);
+    for (ulIndex = 0; ulIndex < ulCount; ulIndex++)
+    {
+        ullSum += pulCycles[ulIndex];
+    }
+    printf("  %-14s %7.1f average, %7lu 99.9 %%, %7lu max (%s)\n", pcName, (double) ullSum / (double) ulCount,
+           (unsigned long) pulCycles[(ulCount * 999U) / 1000U], (unsigned long) pulCycles[ulCount - 1U],
+           HOST_CYCLES_UNIT);
+}
+
+/* Request xSize bytes freed after ulLifetime ticks */
+static void prvRequest(uint32 ulTick, size_t xSize, uint32 ulLifetime)
+{
+    uint32 ulIndex;
+    size_t xFree;
+
+    for (ulIndex = 0; (ulIndex < MAX_LIVE) && (xLive[ulIndex].pvBlock != NULL); ulIndex++)
+    {
+    }
+    configASSERT(ulIndex < MAX_LIVE);
+
+    xLive[ulIndex].pvBlock = prvTimedMalloc(xSize);
+    ulRequests++;
+    xLive[ulIndex].ulFreeTick = ulTick + ulLifetime;
+    if (xLive[ulIndex].pvBlock == NULL)
+    {
+        ulFailures++;
+        ulFailedBytes += (uint32) xSize;
+    }
+
+    xFree = xPortGetFreeHeapSize();
+    if (xFree < xMinimumFree)
+    {
+        xMinimumFree = xFree;
+    }
+}
+
+static void prvFreeDue(uint32 ulTick)
+{
+    uint32 ulIndex;
+
+    for (ulIndex = 0; ulIndex < MAX_LIVE; ulIndex++)
+    {
+        if ((xLive[ulIndex].pvBlock != NULL) && (xLive[ulIndex].ulFreeTick <= ulTick))
+        {
+            prvTimedFree(xLive[ulIndex].pvBlock);
+            xLive[ulIndex].pvBlock = NULL;
+        }
+    }
+}
+
+/* TRUE if the heap can return xSize bytes now. The request runs in a child
+ * process: heap_2 splits blocks it never merges again, so even a freed
+ * probe would change the heap. */
+static boolean prvCanAllocate(size_t xSize)
+{
+    int iStatus = 1;
+    pid_t xChild = fork();
+
+    if (xChild == 0)
+    {
+        _exit((pvPortMalloc(xSize) != NULL) ? 0 : 1);
+    }
+    if ((xChild < 0) || (waitpid(xChild, &iStatus, 0) != xChild))
+    {
+        return FALSE;
+    }
+    return (WIFEXITED(iStatus) && (WEXITSTATUS(iStatus) == 0)) ? TRUE : FALSE;
+}
+
+static size_t prvLargestFreeBlock(void)
+{
+    size_t xLow = 0, xHigh = configTOTAL_HEAP_SIZE, xMiddle;
+
+    while (xLow < xHigh)
+    {
+        xMiddle = (xLow + xHigh + 1U) / 2U;
+        if (prvCanAllocate(xMiddle) == TRUE)
+        {
+            xLow = xMiddle;
+        }
+        else
+        {
+            xHigh = xMiddle - 1U;
+        }
+    }
+    return xLow;
+}
+
+static void prvRunTrace(void)
+{
+    uint32 ulTick, ulIndex;
+
+    for (ulTick = 0; ulTick < TRACE_TICKS; ulTick++)
+    {
+        prvFreeDue(ulTick);
+
+        /* Seat frames of both seats: a keyframe or a delta, sent within 30 ms */
+        if ((ulTick % SEAT_PERIOD_TICKS) == 0)
+        {
+            for (ulIndex = 0; ulIndex < 2U; ulIndex++)
+            {
+                prvRequest(ulTick, (prvRandom(10) == 0) ? TELEMETRY_SEAT_STATE_FRAME : (7U + prvRandom(5)),
+                           1U + prvRandom(3));
+            }
+        }
+
+        /* Runtime report: log frames of any length, drained one after the other */
+        if ((ulTick % REPORT_PERIOD_TICKS) == 0)
+        {
+            for (ulIndex = 0; ulIndex < REPORT_FRAMES; ulIndex++)
+            {
+                prvRequest(ulTick, 8U + prvRandom(TELEMETRY_FRAME_MAX - 8U), 2U + ulIndex);
+            }
+        }
+
+        /* Text display and console replies */
+        if ((ulTick % TEXT_PERIOD_TICKS) == 0)
+        {
+            prvRequest(ulTick, 20U + prvRandom(UART_GATEKEEPER_MESSAGE_SIZE - 20U), 1U + prvRandom(4));
+        }
+
+        /* Context switch measurement: two tasks for one second */
+        if ((ulTick % CSWITCH_PERIOD_TICKS) == (CSWITCH_PERIOD_TICKS - 1U))
+        {
+            for (ulIndex = 0; ulIndex < 2U; ulIndex++)
+            {
+                prvRequest(ulTick, TCB_BYTES, 100U);
+                prvRequest(ulTick, CONTEXT_SWITCH_STACK_DEPTH * sizeof(StackType_t), 100U);
+            }
+        }
+    }
+    prvFreeDue(0xFFFFFFFFUL);
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+int main(void)
+{
+    size_t xLargestBefore, xLargestAfter;
+
+    configASSERT(pvPortMalloc(START_UP_BYTES) != NULL);
+    xLargestBefore = prvLargestFreeBlock();
+
+    prvRunTrace();
+    xLargestAfter = prvLargestFreeBlock();
+
+    printf("%s, %u bytes, %u bytes left after start-up\n",
+           (configHEAP_COALESCING == 1) ? "Services/Heap" : "heap_2.c",
+           (unsigned) configTOTAL_HEAP_SIZE, (unsigned) xLargestBefore);
+    printf("  requests %lu, failed %lu (%lu bytes)\n",
+           (unsigned long) ulRequests, (unsigned long) ulFailures, (unsigned long) ulFailedBytes);
+    printf("  minimum free %lu bytes, free at the end %lu bytes\n",
+           (unsigned long) xMinimumFree, (unsigned long) xPortGetFreeHeapSize());
+    printf("  largest free block %lu bytes before the trace, %lu after\n",
+           (unsigned long) xLargestBefore, (unsigned long) xLargestAfter);
+    prvPrintCycles("pvPortMalloc()", ulAllocCycles, ulRequests);
+    prvPrintCycles("vPortFree()", ulFreeCycles, ulFrees);
+#if (configHEAP_COALESCING == 1)
+    /* The figures trace prints, timed inside the heap with the scheduler suspended */
+    printf("  self-timed     %7lu max pvPortMalloc(), %7lu max vPortFree() (%s)\n",
+           (unsigned long) Heap_GetLatency()->ulMaxAllocCycles, (unsigned long) Heap_GetLatency()->ulMaxFreeCycles,
+           HOST_CYCLES_UNIT);
+#endif
+
+    return 0;
+}
@@ -0,0 +1,286 @@
+ /******************************************************************************
+ *
+ * Module: Tools - Host Tests
+ *
+ * File Name: heater_budget_test.c
+ *
+ * Description: Tests of Services/HeaterBudget: the grants of the fair share
+ *              and driver priority policies for every pair of intensities,
+ *              and the frames the slot timer plays with them. In every
+ *              frame each seat is on for its grant, the seats never exceed
+ *              the budget, no two heaters switch on in the same slot and two
+ *              heaters are only on together when the grants exceed a frame.
+ *              WTimer2 and the clock are replaced by stubs, the test calls
+ *              the slot interrupt itself.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#include "host_test.h"
+#include "heater_budget.h"
+#include "clock.h"
+#include "GPTM.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define INTENSITIES                 (4U)
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static const HeatIntensity xIntensities[INTENSITIES] = {
+    INTENSITYOFF, LOWINTENSITY, MEDIUMINTENSITY, HIGHINTENSITY
+};
+
+static const uint8 ucDemands[INTENSITIES] = {
+    0, HEATER_BUDGET_LOW_SLOTS, HEATER_BUDGET_MEDIUM_SLOTS, HEATER_BUDGET_HIGH_SLOTS
+};
+
+static void (*pfSlotTimeout)(void) = NULL_PTR;
+static boolean bTimerRunning = FALSE;
+
+/* Heater outputs as the driver of main.c would see them */
+static boolean bHeaterOn[HEATER_BUDGET_SEATS];
+static uint32 ulSwitchOns[HEATER_BUDGET_SEATS];
+
+/*******************************************************************************
+ *                              Hardware Stubs                                 *
+ *******************************************************************************/
+
+uint32 Clock_GetFrequency(void)
+{
+    return 16000000UL;
+}
+
+void GPTM_WTimer2Init(uint32 ulSysClock, void (*pfTimeout)(void))
+{
+    (void) ulSysClock;
+    pfSlotTimeout = pfTimeout;
+}
+
+void GPTM_WTimer2Start(uint32 ulTicks)
+{
+    (void) ulTicks;
+    bTimerRunning = TRUE;
+}
+
+void GPTM_WTimer2Stop(void)
+{
+    bTimerRunning = FALSE;
+}
+
+static void prvOutput(uint8 ucSeat, HeatIntensity eIntensity, boolean bOn)
+{
+    (void) eIntensity;
+
+    if ((bOn == TRUE) && (bHeaterOn[ucSeat] == FALSE))
+    {
+        ulSwitchOns[ucSeat]++;
+    }
+    bHeaterOn[ucSeat] = bOn;
+}
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static uint8 prvMin(uint8 ucA, uint8 ucB)
+{
+    return (ucA < ucB) ? ucA : ucB;
+}
+
+/* Grants the policy should give for the demands of both seats */
+static void prvExpectedGrants(HeaterBudgetPolicy ePolicy, uint8 ucDriver, uint8 ucPassenger, uint8 *pucGrants)
+{
+    uint8 ucShare;
+
+    if (ePolicy == HEATER_BUDGET_DRIVER_PRIORITY)
+    {
+        pucGrants[0] = prvMin(ucDriver, HEATER_BUDGET_LIMIT_SLOTS);
+        pucGrants[1] = prvMin(ucPassenger, HEATER_BUDGET_LIMIT_SLOTS - pucGrants[0]);
+        return;
+    }
+
+    /* Fair share: half each, what one seat does not need goes to the other */
+    ucShare = HEATER_BUDGET_LIMIT_SLOTS / 2U;
+    if ((ucDriver + ucPassenger) <= HEATER_BUDGET_LIMIT_SLOTS)
+    {
+        pucGrants[0] = ucDriver;
+        pucGrants[1] = ucPassenger;
+    }
+    else if (ucDriver < ucShare)
+    {
+        pucGrants[0] = ucDriver;
+        pucGrants[1] = HEATER_BUDGET_LIMIT_SLOTS - ucDriver;
+    }
+    else if (ucPassenger < ucShare)
+    {
+        pucGrants[1] = ucPassenger;
+        pucGrants[0] = HEATER_BUDGET_LIMIT_SLOTS - ucPassenger;
+    }
+    else
+    {
+        pucGrants[0] = ucShare;
+        pucGrants[1] = HEATER_BUDGET_LIMIT_SLOTS - ucShare;
+    }
+}
+
+/* Play one frame from the next frame start and check what the heaters did */
+static void prvCheckFrame(const uint8 *pucGrants)
+{
+    uint32 ulOnSlots[HEATER_BUDGET_SEATS] = { 0 };
+    uint32 ulBefore[HEATER_BUDGET_SEATS];
+    uint32 ulTogether = 0, ulSwitching, ulOn;
+    uint8 ucSlot, ucSeat;
+    uint8 ucOverlap;
+
+    for (ucSlot = 0; ucSlot < HEATER_BUDGET_SLOTS; ucSlot++)
+    {
+        ulSwitching = 0;
+        ulOn = 0;
+        for (ucSeat = 0; ucSeat < HEATER_BUDGET_SEATS; ucSeat++)
+        {
+            ulBefore[ucSeat] = ulSwitchOns[ucSeat];
+        }
+        pfSlotTimeout();
+        for (ucSeat = 0; ucSeat < HEATER_BUDGET_SEATS; ucSeat++)
+        {
+            ulSwitching += ulSwitchOns[ucSeat] - ulBefore[ucSeat];
+            if (bHeaterOn[ucSeat] == TRUE)
+            {
+                ulOnSlots[ucSeat]++;
+                ulOn++;
+            }
+        }
+        /* No two heaters switch on in the same slot */
+        HOST_CHECK(ulSwitching <= 1U);
+        if (ulOn > 1U)
+        {
+            ulTogether++;
+        }
+    }
+
+    for (ucSeat = 0; ucSeat < HEATER_BUDGET_SEATS; ucSeat++)
+    {
+        HOST_CHECK(ulOnSlots[ucSeat] == pucGrants[ucSeat]);
+    }
+    HOST_CHECK((ulOnSlots[0] + ulOnSlots[1]) <= HEATER_BUDGET_LIMIT_SLOTS);
+
+    /* Overlap only for the slots the grants have beyond one frame */
+    ucOverlap = ((pucGrants[0] + pucGrants[1]) > HEATER_BUDGET_SLOTS) ?
+                (uint8) (pucGrants[0] + pucGrants[1] - HEATER_BUDGET_SLOTS) : 0U;
+    HOST_CHECK(ulTogether == ucOverlap);
+}
+
+/* Request both intensities, let the pending frame start and check it */
+static void prvTestPair(HeaterBudgetPolicy ePolicy, uint8 ucDriver, uint8 ucPassenger)
+{
+    HeaterBudgetSeat xSeat;
+    uint8 ucGrants[HEATER_BUDGET_SEATS];
+    uint32 ulLimited;
+    uint32 ulFrames;
+    uint8 ucSeat, ucSlot;
+
+    HeaterBudget_SetPolicy(ePolicy);
+    HeaterBudget_Request(0, xIntensities[ucDriver]);
+    ulLimited = HeaterBudget_GetStats()->ulLimited;
+    HeaterBudget_Request(1, xIntensities[ucPassenger]);
+    prvExpectedGrants(ePolicy, ucDemands[ucDriver], ucDemands[ucPassenger], ucGrants);
+
+    for (ucSeat = 0; ucSeat < HEATER_BUDGET_SEATS; ucSeat++)
+    {
+        HeaterBudget_GetSeat(ucSeat, &xSeat);
+        HOST_CHECK(xSeat.ucDemand == ucDemands[(ucSeat == 0) ? ucDriver : ucPassenger]);
+        HOST_CHECK(xSeat.ucGranted == ucGrants[ucSeat]);
+    }
+    HOST_CHECK((HeaterBudget_GetStats()->ulLimited > ulLimited) ==
+               ((ucGrants[0] + ucGrants[1]) < (ucDemands[ucDriver] + ucDemands[ucPassenger])));
+
+    /* The timer runs only while a heater switches within the frame */
+    HOST_CHECK(bTimerRunning == (((ucGrants[0] % HEATER_BUDGET_SLOTS) != 0U) ||
+                                 ((ucGrants[1] % HEATER_BUDGET_SLOTS) != 0U)));
+
+    if (bTimerRunning == TRUE)
+    {
+        /* A running frame ends first, then the new one starts at slot 0.
+         * Its edges are checked in the frame after, from the wrap on. */
+        ulFrames = HeaterBudget_GetStats()->ulFrames;
+        while (HeaterBudget_GetStats()->ulFrames == ulFrames)
+        {
+            pfSlotTimeout();
+        }
+        for (ucSlot = 1; ucSlot < HEATER_BUDGET_SLOTS; ucSlot++)
+        {
+            pfSlotTimeout();
+        }
+        prvCheckFrame(ucGrants);
+    }
+    else
+    {
+        for (ucSeat = 0; ucSeat < HEATER_BUDGET_SEATS; ucSeat++)
+        {
+            HOST_CHECK(bHeaterOn[ucSeat] == ((ucGrants[ucSeat] != 0U) ? TRUE : FALSE));
+        }
+    }
+}
+
+static void prvTestPolicy(HeaterBudgetPolicy ePolicy)
+{
+    uint8 ucDriver, ucPassenger;
+
+    for (ucDriver = 0; ucDriver < INTENSITIES; ucDriver++)
+    {
+        for (ucPassenger = 0; ucPassenger < INTENSITIES; ucPassenger++)
+        {
+            prvTestPair(ePolicy, ucDriver, ucPassenger);
+        }
+    }
+}
+
+static void prvTestKnownGrants(void)
+{
+    HeaterBudgetSeat xDriver, xPassenger;
+
+    /* Both seats HIGH: 6 + 6 shared, 10 + 2 with the driver first */
+    HeaterBudget_SetPolicy(HEATER_BUDGET_FAIR_SHARE);
+    HeaterBudget_Request(0, HIGHINTENSITY);
+    HeaterBudget_Request(1, HIGHINTENSITY);
+    HeaterBudget_GetSeat(0, &xDriver);
+    HeaterBudget_GetSeat(1, &xPassenger);
+    HOST_CHECK((xDriver.ucGranted == 6U) && (xPassenger.ucGranted == 6U));
+
+    HeaterBudget_SetPolicy(HEATER_BUDGET_DRIVER_PRIORITY);
+    HeaterBudget_GetSeat(0, &xDriver);
+    HeaterBudget_GetSeat(1, &xPassenger);
+    HOST_CHECK((xDriver.ucGranted == 10U) && (xPassenger.ucGranted == 2U));
+    HOST_CHECK(HeaterBudget_GetPolicy() == HEATER_BUDGET_DRIVER_PRIORITY);
+
+    /* A LOW seat keeps its 4 slots, the HIGH one gets the rest */
+    HeaterBudget_SetPolicy(HEATER_BUDGET_FAIR_SHARE);
+    HeaterBudget_Request(0, LOWINTENSITY);
+    HeaterBudget_GetSeat(0, &xDriver);
+    HeaterBudget_GetSeat(1, &xPassenger);
+    HOST_CHECK((xDriver.ucGranted == 4U) && (xPassenger.ucGranted == 8U));
+    HOST_CHECK(xDriver.ucFirstSlot != xPassenger.ucFirstSlot);
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+int main(void)
+{
+    HeaterBudget_Init(prvOutput);
+    HOST_CHECK(pfSlotTimeout != NULL_PTR);
+    HOST_CHECK((bHeaterOn[0] == FALSE) && (bHeaterOn[1] == FALSE));
+
+    prvTestKnownGrants();
+    prvTestPolicy(HEATER_BUDGET_FAIR_SHARE);
+    prvTestPolicy(HEATER_BUDGET_DRIVER_PRIORITY);
+
+    return HOST_TEST_RESULT("heater_budget_test");
+}
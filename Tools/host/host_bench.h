@@ -0,0 +1,49 @@
+ /******************************************************************************
+ *
+ * Module: Tools - Host Benchmarks
+ *
+ * File Name: host_bench.h
+ *
+ * Description: Timing of the host benchmarks. A case runs its body over a
+ *              number of operations a few times and keeps the fastest run,
+ *              the others were disturbed by the host.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef HOST_BENCH_H_
+#define HOST_BENCH_H_
+
+#include <stdio.h>
+
+#include "host_cycles.h"
+
+#define HOST_BENCH_RUNS             (7U)
+
+/* Keeps a result alive without a side effect the compiler could move */
+static volatile uint32 ulHostBenchSink;
+
+/* Prints the fastest run of the body (the last arguments, it may hold
+ * commas) in cycles per operation, the body performs OPERATIONS operations */
+#define HOST_BENCH(NAME, OPERATIONS, ...)                                       \
+    do                                                                          \
+    {                                                                           \
+        uint64 ullBest = ~0ULL, ullStart, ullElapsed;                           \
+        uint32 ulRun;                                                           \
+                                                                                \
+        for (ulRun = 0; ulRun < HOST_BENCH_RUNS; ulRun++)                       \
+        {                                                                       \
+            ullStart = Host_Cycles();                                           \
+            __VA_ARGS__;                                                        \
+            ullElapsed = Host_Cycles() - ullStart;                              \
+            if (ullElapsed < ullBest)                                           \
+            {                                                                   \
+                ullBest = ullElapsed;                                           \
+            }                                                                   \
+        }                                                                       \
+        printf("  %-40s %8.1f %s/op\n", (NAME),                                 \
+               (double) ullBest / (double) (OPERATIONS), HOST_CYCLES_UNIT);     \
+    } while (0)
+
+#endif /* HOST_BENCH_H_ */
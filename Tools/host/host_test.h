@@ -0,0 +1,38 @@
+ /******************************************************************************
+ *
+ * Module: Tools - Host Tests
+ *
+ * File Name: host_test.h
+ *
+ * Description: Checks of the host tests. A failed check prints its place and
+ *              the test goes on, HOST_TEST_RESULT() sets the exit code.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef HOST_TEST_H_
+#define HOST_TEST_H_
+
+#include <stdio.h>
+
+static unsigned long ulHostChecks = 0;
+static unsigned long ulHostFailures = 0;
+
+#define HOST_CHECK(CONDITION)                                                   \
+    do                                                                          \
+    {                                                                           \
+        ulHostChecks++;                                                         \
+        if (!(CONDITION))                                                       \
+        {                                                                       \
+            ulHostFailures++;                                                   \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #CONDITION); \
+        }                                                                       \
+    } while (0)
+
+/* Exit code of main() */
+#define HOST_TEST_RESULT(NAME)                                                  \
+    (printf("%s: %lu checks, %lu failed\n", (NAME), ulHostChecks, ulHostFailures), \
+     (ulHostFailures == 0) ? 0 : 1)
+
+#endif /* HOST_TEST_H_ */
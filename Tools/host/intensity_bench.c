@@ -0,0 +1,101 @@
+ /******************************************************************************
+ *
+ * Module: Tools - Host Benchmarks
+ *
+ * File Name: intensity_bench.c
+ *
+ * Description: Cost of one intensity decision: the former float if-chain
+ *              inlined in the controller against Intensity_Select(), over
+ *              every ADC reading at every level. The readings are shuffled,
+ *              sorted ones would let the host predict the branches of the
+ *              chain. Built once per TEMPERATURE_FIXED_POINT value.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#include "host_bench.h"
+#include "intensity.h"
+#include "intensity_reference.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define ADC_MAX_COUNT               (4095U)
+#define READINGS                    (ADC_MAX_COUNT + 1U)
+#define LEVELS                      (4U)
+#define ROUNDS                      (50U)
+#define DECISIONS                   (ROUNDS * LEVELS * READINGS)
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static const UserHeatInput xLevels[LEVELS] = { OFF, LOW, MEDIUM, HIGH };
+
+static Temperature xReadings[READINGS];
+static float32 fReadings[READINGS];
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void prvReference(void)
+{
+    uint32 ulRound, ulLevel, ulReading, ulSum = 0;
+
+    for (ulRound = 0; ulRound < ROUNDS; ulRound++)
+    {
+        for (ulLevel = 0; ulLevel < LEVELS; ulLevel++)
+        {
+            for (ulReading = 0; ulReading < READINGS; ulReading++)
+            {
+                ulSum += Reference_Select((float32) xLevels[ulLevel], fReadings[ulReading],
+                                          INTENSITY_LOW_FROM_C, INTENSITY_MEDIUM_FROM_C, INTENSITY_HIGH_FROM_C);
+            }
+        }
+    }
+    ulHostBenchSink = ulSum;
+}
+
+static void prvTable(void)
+{
+    uint32 ulRound, ulLevel, ulReading, ulSum = 0;
+
+    for (ulRound = 0; ulRound < ROUNDS; ulRound++)
+    {
+        for (ulLevel = 0; ulLevel < LEVELS; ulLevel++)
+        {
+            for (ulReading = 0; ulReading < READINGS; ulReading++)
+            {
+                ulSum += Intensity_Select(xLevels[ulLevel], xReadings[ulReading]);
+            }
+        }
+    }
+    ulHostBenchSink = ulSum;
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+int main(void)
+{
+    uint32 ulIndex, ulCount = 1;
+
+    for (ulIndex = 0; ulIndex < READINGS; ulIndex++)
+    {
+        /* Full period LCG over the counts */
+        ulCount = ((ulCount * 1664525UL) + 1013904223UL) & ADC_MAX_COUNT;
+        xReadings[ulIndex] = TEMPERATURE_FROM_COUNTS(ulCount, ADC_MAX_COUNT);
+        fReadings[ulIndex] = (float32) ulCount * (45.0f / ADC_MAX_COUNT);
+    }
+
+    printf("one decision, every ADC reading at every level, %s temperatures\n",
+           (TEMPERATURE_FIXED_POINT == 1U) ? "fixed point" : "float");
+    HOST_BENCH("float if-chain", DECISIONS, prvReference());
+    HOST_BENCH("Intensity_Select()", DECISIONS, prvTable());
+
+    return 0;
+}
@@ -0,0 +1,52 @@
+ /******************************************************************************
+ *
+ * Module: Tools - Host Tests
+ *
+ * File Name: intensity_reference.h
+ *
+ * Description: The float if-chain the heater controllers used before the
+ *              lookup table (Services/Intensity), with its runtime bands,
+ *              kept as the reference of the equivalence test and the
+ *              benchmark
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef INTENSITY_REFERENCE_H_
+#define INTENSITY_REFERENCE_H_
+
+#include "std_types.h"
+
+static inline HeatIntensity Reference_Select(float32 DesiredTemp, float32 CurrentTemp,
+                                             uint8 ucLowBand, uint8 ucMediumBand, uint8 ucHighBand)
+{
+    HeatIntensity heatIntensity;
+
+    if (CurrentTemp < 5 || CurrentTemp > 40)
+    {
+        heatIntensity = ERROR;
+    }
+    else if ((DesiredTemp - CurrentTemp) >= ucHighBand)
+    {
+        heatIntensity = HIGHINTENSITY;
+    }
+    else if ((DesiredTemp - CurrentTemp) >= ucMediumBand
+            && (DesiredTemp - CurrentTemp) < ucHighBand)
+    {
+        heatIntensity = MEDIUMINTENSITY;
+    }
+    else if ((DesiredTemp - CurrentTemp) >= ucLowBand
+            && (DesiredTemp - CurrentTemp) < ucMediumBand)
+    {
+        heatIntensity = LOWINTENSITY;
+    }
+    else
+    {
+        heatIntensity = INTENSITYOFF;
+    }
+
+    return heatIntensity;
+}
+
+#endif /* INTENSITY_REFERENCE_H_ */
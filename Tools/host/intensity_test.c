@@ -0,0 +1,205 @@
+ /******************************************************************************
+ *
+ * Module: Tools - Host Tests
+ *
+ * File Name: intensity_test.c
+ *
+ * Description: Equivalence of Intensity_Select() with the former float
+ *              if-chain at every level, for the bands of intensity_cfg.h
+ *              and for every band set the tune command accepts. Built once
+ *              per TEMPERATURE_FIXED_POINT value.
+ *
+ *              Fixed point: every reading from -10 C to 60 C (each 0.1 C).
+ *              Float: every ADC count, every 0.001 C from -10 C to 60 C and
+ *              the 256 floats around each whole degree, where rounding the
+ *              error down could differ from comparing it.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#include <math.h>
+
+#include "host_test.h"
+#include "intensity.h"
+#include "intensity_reference.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define READING_MIN_C               (-10)
+#define READING_MAX_C               (60)
+
+#define ADC_MAX_COUNT               (4095U)
+
+/* Floats checked on each side of a whole degree */
+#define EDGE_FLOATS                 (128)
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static const UserHeatInput xLevels[] = { OFF, LOW, MEDIUM, HIGH };
+
+static IntensityBands xBands;
+static uint32 ulMismatches = 0;
+static uint32 ulDecisions = 0;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static float32 prvToFloat(Temperature xReading)
+{
+#if (TEMPERATURE_FIXED_POINT == 1U)
+    return (float32) xReading / 10.0f;
+#else
+    return xReading;
+#endif
+}
+
+static void prvCompare(Temperature xReading)
+{
+    uint8 ucLevel;
+    HeatIntensity eExpected, eActual;
+
+    for (ucLevel = 0; ucLevel < (sizeof(xLevels) / sizeof(xLevels[0])); ucLevel++)
+    {
+        eExpected = Reference_Select((float32) xLevels[ucLevel], prvToFloat(xReading),
+                                     xBands.ucLowFrom, xBands.ucMediumFrom, xBands.ucHighFrom);
+        eActual = Intensity_Select(xLevels[ucLevel], xReading);
+        ulDecisions++;
+        if (eActual != eExpected)
+        {
+            if (ulMismatches < 10U)
+            {
+                printf("bands %u %u %u, level %u, reading %.6f: %u instead of %u\n",
+                       xBands.ucLowFrom, xBands.ucMediumFrom, xBands.ucHighFrom, (unsigned) xLevels[ucLevel],
+                       (double) prvToFloat(xReading), (unsigned) eActual, (unsigned) eExpected);
+            }
+            ulMismatches++;
+        }
+    }
+}
+
+/* Readings the ADC conversion produces */
+static void prvCompareCounts(void)
+{
+    uint32 ulCount;
+
+    for (ulCount = 0; ulCount <= ADC_MAX_COUNT; ulCount++)
+    {
+        prvCompare(TEMPERATURE_FROM_COUNTS(ulCount, ADC_MAX_COUNT));
+    }
+}
+
+static void prvCompareRange(void)
+{
+#if (TEMPERATURE_FIXED_POINT == 1U)
+    sint32 slTenths;
+
+    for (slTenths = READING_MIN_C * 10; slTenths <= READING_MAX_C * 10; slTenths++)
+    {
+        prvCompare((Temperature) slTenths);
+    }
+#else
+    sint32 slMilli, slDegree, slStep;
+    float32 fReading;
+
+    for (slMilli = READING_MIN_C * 1000; slMilli <= READING_MAX_C * 1000; slMilli++)
+    {
+        prvCompare((float32) slMilli / 1000.0f);
+    }
+    for (slDegree = READING_MIN_C; slDegree <= READING_MAX_C; slDegree++)
+    {
+        fReading = (float32) slDegree;
+        for (slStep = 0; slStep < EDGE_FLOATS; slStep++)
+        {
+            fReading = nextafterf(fReading, -INFINITY);
+        }
+        for (slStep = 0; slStep <= (2 * EDGE_FLOATS); slStep++)
+        {
+            prvCompare(fReading);
+            fReading = nextafterf(fReading, INFINITY);
+        }
+    }
+#endif
+}
+
+static boolean prvAccepted(uint8 ucLow, uint8 ucMedium, uint8 ucHigh)
+{
+    return ((ucLow > 0) && (ucLow < ucMedium) && (ucMedium < ucHigh) && (ucHigh <= INTENSITY_ERROR_MAX_C) &&
+            ((10 * (ucMedium - ucLow)) > INTENSITY_HYSTERESIS_TENTHS) &&
+            ((10 * (ucHigh - ucMedium)) > INTENSITY_HYSTERESIS_TENTHS)) ? TRUE : FALSE;
+}
+
+/* Every band set of 0..INTENSITY_ERROR_MAX_C + 1: the valid ones replace the
+ * table, the others are refused and keep it */
+static void prvTestTunedBands(void)
+{
+    IntensityBands xTry, xKept;
+    uint8 ucLow, ucMedium, ucHigh;
+    uint32 ulSets = 0;
+
+    for (ucLow = 0; ucLow <= (INTENSITY_ERROR_MAX_C + 1); ucLow++)
+    {
+        for (ucMedium = 0; ucMedium <= (INTENSITY_ERROR_MAX_C + 1); ucMedium++)
+        {
+            for (ucHigh = 0; ucHigh <= (INTENSITY_ERROR_MAX_C + 1); ucHigh++)
+            {
+                xTry.ucLowFrom = ucLow;
+                xTry.ucMediumFrom = ucMedium;
+                xTry.ucHighFrom = ucHigh;
+                Intensity_GetBands(&xKept);
+                if (prvAccepted(ucLow, ucMedium, ucHigh) == FALSE)
+                {
+                    HOST_CHECK(Intensity_SetBands(&xTry) == FALSE);
+                    Intensity_GetBands(&xBands);
+                    HOST_CHECK((xBands.ucLowFrom == xKept.ucLowFrom) && (xBands.ucMediumFrom == xKept.ucMediumFrom) &&
+                               (xBands.ucHighFrom == xKept.ucHighFrom));
+                    continue;
+                }
+                HOST_CHECK(Intensity_SetBands(&xTry) == TRUE);
+                Intensity_GetBands(&xBands);
+                HOST_CHECK((xBands.ucLowFrom == ucLow) && (xBands.ucMediumFrom == ucMedium) &&
+                           (xBands.ucHighFrom == ucHigh));
+                prvCompareCounts();
+#if (TEMPERATURE_FIXED_POINT == 1U)
+                prvCompareRange();
+#endif
+                ulSets++;
+            }
+        }
+    }
+    printf("%lu band sets accepted\n", (unsigned long) ulSets);
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+int main(void)
+{
+    /* The table generated at build time */
+    Intensity_GetBands(&xBands);
+    HOST_CHECK((xBands.ucLowFrom == INTENSITY_LOW_FROM_C) && (xBands.ucMediumFrom == INTENSITY_MEDIUM_FROM_C) &&
+               (xBands.ucHighFrom == INTENSITY_HIGH_FROM_C));
+    prvCompareCounts();
+    prvCompareRange();
+
+    prvTestTunedBands();
+
+    /* Back to the build time bands, the rebuilt table must give the same */
+    HOST_CHECK(Intensity_SetBands(&(IntensityBands) { INTENSITY_LOW_FROM_C, INTENSITY_MEDIUM_FROM_C,
+                                                      INTENSITY_HIGH_FROM_C }) == TRUE);
+    Intensity_GetBands(&xBands);
+    prvCompareRange();
+
+    HOST_CHECK(ulMismatches == 0);
+    printf("%s: %lu decisions compared, %lu mismatches\n",
+           (TEMPERATURE_FIXED_POINT == 1U) ? "fixed point" : "float",
+           (unsigned long) ulDecisions, (unsigned long) ulMismatches);
+
+    return HOST_TEST_RESULT("intensity_test");
+}
@@ -0,0 +1,44 @@
+ /******************************************************************************
+ *
+ * Module: Tools - Host Port
+ *
+ * File Name: FreeRTOSConfig.h
+ *
+ * Description: Kernel configuration of the host tests and benchmarks. The
+ *              scheduler never starts: queue.c, list.c and tasks.c are only
+ *              linked for the queue and heap calls that do not block.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#include "std_types.h"
+
+#define configCPU_CLOCK_HZ                    (80000000UL)
+#define configTICK_RATE_HZ                    ((TickType_t)100)
+#define configMINIMAL_STACK_SIZE              (128)
+#define configMAX_PRIORITIES                  (5)
+#define configUSE_PREEMPTION                  (1)
+#define configUSE_16_BIT_TICKS                0
+#define configUSE_IDLE_HOOK                   0
+#define configUSE_TICK_HOOK                   0
+#define configUSE_MUTEXES                     1
+
+/* Same heap as the firmware, the Makefile selects the allocator */
+#define configTOTAL_HEAP_SIZE                 ((size_t)(22 * 1024))
+#ifndef configHEAP_COALESCING
+#define configHEAP_COALESCING                 1
+#endif
+
+#define INCLUDE_vTaskDelay                    1
+#define INCLUDE_vTaskDelete                   1
+#define INCLUDE_xTaskGetSchedulerState        1
+
+#define configASSERT( x ) if( ( x ) == 0 ) { vHostAssert( __FILE__, __LINE__ ); }
+
+extern void vHostAssert(const char *pcFile, int iLine);
+
+#endif /* FREERTOS_CONFIG_H */
@@ -0,0 +1,92 @@
+ /******************************************************************************
+ *
+ * Module: Tools - Host Port
+ *
+ * File Name: eeprom_mock.c
+ *
+ * Description: EEPROM of the host tests, the MCAL/EEPROM interface on a RAM
+ *              array. Every write is busy for one poll, like the program
+ *              time of the hardware. Once the power is cut the writes are
+ *              lost until the test restores it.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#include "eeprom_mock.h"
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static EepromMock xMock;
+static boolean bBusy = FALSE;
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void EepromMock_Erase(void)
+{
+    uint16 usWord;
+
+    for (usWord = 0; usWord < EEPROM_WORDS; usWord++)
+    {
+        xMock.ulWords[usWord] = EEPROM_MOCK_ERASED;
+    }
+    xMock.ulWrites = 0;
+    xMock.ulBusyPolls = 0;
+    xMock.ulWritesLeft = EEPROM_MOCK_NO_CUT;
+    xMock.bInitFails = FALSE;
+    xMock.bWritesFail = FALSE;
+    xMock.usLastWord = 0;
+    bBusy = FALSE;
+}
+
+EepromMock *EepromMock_Get(void)
+{
+    return &xMock;
+}
+
+boolean EEPROM_Init(void)
+{
+    bBusy = FALSE;
+    return (xMock.bInitFails == TRUE) ? FALSE : TRUE;
+}
+
+uint32 EEPROM_ReadWord(uint16 usWord)
+{
+    return (usWord < EEPROM_WORDS) ? xMock.ulWords[usWord] : EEPROM_MOCK_ERASED;
+}
+
+void EEPROM_StartWrite(uint16 usWord, uint32 ulValue)
+{
+    if ((usWord >= EEPROM_WORDS) || (xMock.ulWritesLeft == 0))
+    {
+        return;
+    }
+    if (xMock.ulWritesLeft != EEPROM_MOCK_NO_CUT)
+    {
+        xMock.ulWritesLeft--;
+    }
+    xMock.ulWords[usWord] = ulValue;
+    xMock.ulWrites++;
+    xMock.usLastWord = usWord;
+    bBusy = TRUE;
+}
+
+boolean EEPROM_IsBusy(void)
+{
+    if (bBusy == TRUE)
+    {
+        bBusy = FALSE;
+        xMock.ulBusyPolls++;
+        return TRUE;
+    }
+    return FALSE;
+}
+
+boolean EEPROM_WriteFailed(void)
+{
+    return xMock.bWritesFail;
+}
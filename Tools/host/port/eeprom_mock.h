@@ -0,0 +1,56 @@
+ /******************************************************************************
+ *
+ * Module: Tools - Host Port
+ *
+ * File Name: eeprom_mock.h
+ *
+ * Description: Controls of the EEPROM mock that replaces MCAL/EEPROM on the
+ *              host. The words live in RAM and start erased. A test can
+ *              corrupt words, cut the power after a number of programmed
+ *              words and make the EEPROM report failures.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef EEPROM_MOCK_H_
+#define EEPROM_MOCK_H_
+
+#include "std_types.h"
+#include "eeprom.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define EEPROM_MOCK_ERASED              (0xFFFFFFFFUL)
+
+/* No power cut: every write is programmed */
+#define EEPROM_MOCK_NO_CUT              (0xFFFFFFFFUL)
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint32 ulWords[EEPROM_WORDS];
+    uint32 ulWrites;                /* Words programmed since the erase */
+    uint32 ulBusyPolls;             /* EEPROM_IsBusy() calls that returned TRUE */
+    uint32 ulWritesLeft;            /* Words programmed before the power is cut */
+    boolean bInitFails;             /* EEPROM_Init() returns FALSE */
+    boolean bWritesFail;            /* EEPROM_WriteFailed() returns TRUE */
+    uint16 usLastWord;              /* Word of the last write */
+}EepromMock;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Erases every word and clears the counts and the faults */
+extern void EepromMock_Erase(void);
+
+/* The mock state, the tests read and change it directly */
+extern EepromMock *EepromMock_Get(void);
+
+#endif /* EEPROM_MOCK_H_ */
@@ -0,0 +1,41 @@
+ /******************************************************************************
+ *
+ * Module: Tools - Host Port
+ *
+ * File Name: host_cycles.h
+ *
+ * Description: Cycle counter of the host benchmarks: the time stamp counter
+ *              on x86, nanoseconds elsewhere. The counts compare the
+ *              implementations with each other, they are not Cortex-M4
+ *              cycles.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef HOST_CYCLES_H_
+#define HOST_CYCLES_H_
+
+#include "std_types.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HOST_CYCLES_UNIT    "cycles"
+#else
+#include <time.h>
+#define HOST_CYCLES_UNIT    "ns"
+#endif
+
+static inline uint64 Host_Cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec xNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &xNow);
+    return ((uint64) xNow.tv_sec * 1000000000ULL) + (uint64) xNow.tv_nsec;
+#endif
+}
+
+#endif /* HOST_CYCLES_H_ */
@@ -0,0 +1,43 @@
+ /******************************************************************************
+ *
+ * Module: Tools - Host Port
+ *
+ * File Name: port.c
+ *
+ * Description: Port functions the kernel links against. The scheduler is
+ *              never started on the host.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+volatile uint32 ulHostDemcr = 0;
+volatile uint32 ulHostDwtCtrl = 0;
+
+void vHostAssert(const char *pcFile, int iLine)
+{
+    fprintf(stderr, "configASSERT failed at %s:%d\n", pcFile, iLine);
+    exit(2);
+}
+
+StackType_t *pxPortInitialiseStack(StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters)
+{
+    (void) pxCode;
+    (void) pvParameters;
+    return pxTopOfStack;
+}
+
+BaseType_t xPortStartScheduler(void)
+{
+    return pdFALSE;
+}
+
+void vPortEndScheduler(void)
+{
+}
@@ -0,0 +1,58 @@
+ /******************************************************************************
+ *
+ * Module: Tools - Host Port
+ *
+ * File Name: std_types.h
+ *
+ * Description: Platform types of Common/std_types.h for the 64-bit host
+ *              build. uint32 is unsigned long on the target, which is 64 bits
+ *              wide on the host, so the free running indices and the 32-bit
+ *              arithmetic would not wrap like on the Cortex-M4. The Makefile
+ *              includes this file first, its guard hides Common/std_types.h.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef STD_TYPES_H_
+#define STD_TYPES_H_
+
+#include <stdint.h>
+
+/* Boolean Values */
+#ifndef FALSE
+#define FALSE       (0u)
+#endif
+#ifndef TRUE
+#define TRUE        (1u)
+#endif
+
+#define LOGIC_HIGH        (1u)
+#define LOGIC_LOW         (0u)
+
+#define NULL_PTR    ((void*)0)
+
+typedef uint8_t               uint8;
+typedef int8_t                sint8;
+typedef uint16_t              uint16;
+typedef int16_t               sint16;
+typedef uint32_t              uint32;
+typedef int32_t               sint32;
+typedef uint64_t              uint64;
+typedef int64_t               sint64;
+typedef float                 float32;
+typedef double                float64;
+
+/* Boolean Data Type */
+typedef uint8 boolean;
+
+/* Enums */
+typedef enum{
+    OFF=0,LOW=25,MEDIUM=30,HIGH=35
+}UserHeatInput; /* Heat level in Display */
+
+typedef enum{
+    INTENSITYOFF,LOWINTENSITY,MEDIUMINTENSITY,HIGHINTENSITY,ERROR
+}HeatIntensity; /* Heat State in Display */
+
+#endif /* STD_TYPES_H_ */
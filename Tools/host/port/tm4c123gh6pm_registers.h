@@ -0,0 +1,28 @@
+ /******************************************************************************
+ *
+ * Module: Tools - Host Port
+ *
+ * File Name: tm4c123gh6pm_registers.h
+ *
+ * Description: The debug registers Services/Heap reads, backed by the host
+ *              cycle counter
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#ifndef TM4C123GH6PM_REGISTERS_H_
+#define TM4C123GH6PM_REGISTERS_H_
+
+#include "host_cycles.h"
+
+extern volatile uint32 ulHostDemcr;
+extern volatile uint32 ulHostDwtCtrl;
+
+#define CORE_DEMCR_REG                  ulHostDemcr
+#define CORE_DEMCR_TRCENA_MASK          (1UL << 24)
+#define DWT_CTRL_REG                    ulHostDwtCtrl
+#define DWT_CTRL_CYCCNTENA_MASK         (1UL << 0)
+#define DWT_CYCCNT_REG                  ((uint32) Host_Cycles())
+
+#endif /* TM4C123GH6PM_REGISTERS_H_ */
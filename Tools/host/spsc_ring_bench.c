@@ -0,0 +1,142 @@
+ /******************************************************************************
+ *
+ * Module: Tools - Host Benchmarks
+ *
+ * File Name: spsc_ring_bench.c
+ *
+ * Description: Cost of moving one element through Common/spsc_ring.h and
+ *              through a FreeRTOS queue of the same length, the two ways the
+ *              interrupts hand data to the tasks. The kernel sources of the
+ *              repository are built with the host port, whose critical
+ *              sections are empty, so the queue figures are a lower bound.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "host_bench.h"
+#include "spsc_ring.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define RING_SIZE                   (64U)
+
+/* Elements a run pushes then pops, a full ring at a time */
+#define ROUNDS                      (20000U)
+#define ELEMENTS                    (ROUNDS * RING_SIZE)
+
+#define BATCH                       (8U)
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static uint32 ulStorage[RING_SIZE];
+static SpscRing xRing = SPSC_RING_INITIALIZER(ulStorage);
+
+static QueueHandle_t xQueue;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void prvRingSingle(void)
+{
+    uint32 ulRound, ulIndex, ulValue = 0, ulSum = 0;
+
+    for (ulRound = 0; ulRound < ROUNDS; ulRound++)
+    {
+        for (ulIndex = 0; ulIndex < RING_SIZE; ulIndex++)
+        {
+            SpscRing_PushU32(&xRing, ulIndex);
+        }
+        for (ulIndex = 0; ulIndex < RING_SIZE; ulIndex++)
+        {
+            SpscRing_PopU32(&xRing, &ulValue);
+            ulSum += ulValue;
+        }
+    }
+    ulHostBenchSink = ulSum;
+}
+
+static void prvRingBatch(void)
+{
+    uint32 ulBatch[BATCH] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    uint32 ulRound, ulIndex, ulSum = 0;
+
+    for (ulRound = 0; ulRound < ROUNDS; ulRound++)
+    {
+        for (ulIndex = 0; ulIndex < RING_SIZE; ulIndex += BATCH)
+        {
+            SpscRing_PushBatchU32(&xRing, ulBatch, BATCH);
+        }
+        for (ulIndex = 0; ulIndex < RING_SIZE; ulIndex += BATCH)
+        {
+            SpscRing_PopBatchU32(&xRing, ulBatch, BATCH);
+            ulSum += ulBatch[0];
+        }
+    }
+    ulHostBenchSink = ulSum;
+}
+
+static void prvQueueTask(void)
+{
+    uint32 ulRound, ulIndex, ulValue = 0, ulSum = 0;
+
+    for (ulRound = 0; ulRound < ROUNDS; ulRound++)
+    {
+        for (ulIndex = 0; ulIndex < RING_SIZE; ulIndex++)
+        {
+            xQueueSend(xQueue, &ulIndex, 0);
+        }
+        for (ulIndex = 0; ulIndex < RING_SIZE; ulIndex++)
+        {
+            xQueueReceive(xQueue, &ulValue, 0);
+            ulSum += ulValue;
+        }
+    }
+    ulHostBenchSink = ulSum;
+}
+
+/* The interrupt side sends, the task side receives, like the ADC path did */
+static void prvQueueFromIsr(void)
+{
+    BaseType_t xWoken = pdFALSE;
+    uint32 ulRound, ulIndex, ulValue = 0, ulSum = 0;
+
+    for (ulRound = 0; ulRound < ROUNDS; ulRound++)
+    {
+        for (ulIndex = 0; ulIndex < RING_SIZE; ulIndex++)
+        {
+            xQueueSendFromISR(xQueue, &ulIndex, &xWoken);
+        }
+        for (ulIndex = 0; ulIndex < RING_SIZE; ulIndex++)
+        {
+            xQueueReceive(xQueue, &ulValue, 0);
+            ulSum += ulValue;
+        }
+    }
+    ulHostBenchSink = ulSum + (uint32) xWoken;
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+int main(void)
+{
+    xQueue = xQueueCreate(RING_SIZE, sizeof(uint32));
+    configASSERT(xQueue != NULL);
+
+    printf("push + pop of one uint32, %u elements deep\n", RING_SIZE);
+    HOST_BENCH("SpscRing_PushU32/PopU32", ELEMENTS, prvRingSingle());
+    HOST_BENCH("SpscRing_PushBatchU32/PopBatchU32 (8)", ELEMENTS, prvRingBatch());
+    HOST_BENCH("xQueueSend/xQueueReceive", ELEMENTS, prvQueueTask());
+    HOST_BENCH("xQueueSendFromISR/xQueueReceive", ELEMENTS, prvQueueFromIsr());
+
+    return 0;
+}
@@ -0,0 +1,277 @@
+ /******************************************************************************
+ *
+ * Module: Tools - Host Tests
+ *
+ * File Name: spsc_ring_test.c
+ *
+ * Description: Tests of Common/spsc_ring.h: index wrap, overflow counting,
+ *              batch push and pop, and a stress run with the producer and
+ *              the consumer on two threads that checks every element
+ *              arrives once and in order.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "host_test.h"
+#include "spsc_ring.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define RING_SIZE                   (16U)
+
+/* Elements of the threaded run */
+#define STRESS_ELEMENTS             (2000000UL)
+
+/* Indices just before the 32-bit wrap */
+#define NEAR_WRAP                   (0xFFFFFFF0UL)
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static uint32 ulStorage[RING_SIZE];
+static SpscRing xRing = SPSC_RING_INITIALIZER(ulStorage);
+
+static uint32 ulStressStorage[64];
+static SpscRing xStressRing = SPSC_RING_INITIALIZER(ulStressStorage);
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void prvReset(uint32 ulIndex)
+{
+    xRing.ulHead = ulIndex;
+    xRing.ulTail = ulIndex;
+    xRing.ulOverflows = 0;
+}
+
+static void prvTestEmptyAndFull(void)
+{
+    uint32 ulValue, ulIndex;
+
+    prvReset(0);
+    HOST_CHECK(SpscRing_Count(&xRing) == 0);
+    HOST_CHECK(SpscRing_Free(&xRing) == RING_SIZE);
+    HOST_CHECK(SpscRing_PopU32(&xRing, &ulValue) == FALSE);
+
+    for (ulIndex = 0; ulIndex < RING_SIZE; ulIndex++)
+    {
+        HOST_CHECK(SpscRing_PushU32(&xRing, ulIndex) == TRUE);
+    }
+    HOST_CHECK(SpscRing_Count(&xRing) == RING_SIZE);
+    HOST_CHECK(SpscRing_Free(&xRing) == 0);
+
+    /* A full ring drops the new element and counts it */
+    HOST_CHECK(SpscRing_PushU32(&xRing, 99) == FALSE);
+    HOST_CHECK(SpscRing_PushU32(&xRing, 99) == FALSE);
+    HOST_CHECK(SpscRing_GetOverflows(&xRing) == 2);
+
+    for (ulIndex = 0; ulIndex < RING_SIZE; ulIndex++)
+    {
+        HOST_CHECK((SpscRing_PopU32(&xRing, &ulValue) == TRUE) && (ulValue == ulIndex));
+    }
+    HOST_CHECK(SpscRing_PopU32(&xRing, &ulValue) == FALSE);
+    HOST_CHECK(SpscRing_GetOverflows(&xRing) == 2);
+}
+
+/* The free running indices cross 0xFFFFFFFF while the ring holds elements */
+static void prvTestWrap(void)
+{
+    uint32 ulValue, ulIndex, ulRound;
+    uint32 ulNext = 0, ulExpected = 0;
+
+    prvReset(NEAR_WRAP);
+    for (ulRound = 0; ulRound < 8; ulRound++)
+    {
+        for (ulIndex = 0; ulIndex < 11; ulIndex++)
+        {
+            HOST_CHECK(SpscRing_PushU32(&xRing, ulNext++) == TRUE);
+        }
+        HOST_CHECK(SpscRing_Count(&xRing) == 11);
+        HOST_CHECK(SpscRing_Free(&xRing) == (RING_SIZE - 11));
+        for (ulIndex = 0; ulIndex < 11; ulIndex++)
+        {
+            HOST_CHECK((SpscRing_PopU32(&xRing, &ulValue) == TRUE) && (ulValue == ulExpected));
+            ulExpected++;
+        }
+    }
+    HOST_CHECK(xRing.ulHead < NEAR_WRAP);
+    HOST_CHECK(SpscRing_Count(&xRing) == 0);
+
+    /* Full across the wrap */
+    prvReset(0xFFFFFFF8UL);
+    for (ulIndex = 0; ulIndex < RING_SIZE; ulIndex++)
+    {
+        HOST_CHECK(SpscRing_PushU32(&xRing, ulIndex) == TRUE);
+    }
+    HOST_CHECK(SpscRing_PushU32(&xRing, 0) == FALSE);
+    HOST_CHECK(SpscRing_Free(&xRing) == 0);
+    HOST_CHECK(SpscRing_GetOverflows(&xRing) == 1);
+}
+
+static void prvTestBatch(void)
+{
+    uint32 ulIn[RING_SIZE + 8];
+    uint32 ulOut[RING_SIZE + 8];
+    uint32 ulIndex;
+
+    for (ulIndex = 0; ulIndex < (RING_SIZE + 8); ulIndex++)
+    {
+        ulIn[ulIndex] = 1000U + ulIndex;
+    }
+
+    /* A batch larger than the free space takes what fits and counts the rest */
+    prvReset(NEAR_WRAP + 4U);
+    HOST_CHECK(SpscRing_PushBatchU32(&xRing, ulIn, 10) == 10);
+    HOST_CHECK(SpscRing_PushBatchU32(&xRing, &ulIn[10], 10) == (RING_SIZE - 10));
+    HOST_CHECK(SpscRing_GetOverflows(&xRing) == (20 - RING_SIZE));
+    HOST_CHECK(SpscRing_PushBatchU32(&xRing, ulIn, 0) == 0);
+
+    /* A batch pop copies at most what is there */
+    HOST_CHECK(SpscRing_PopBatchU32(&xRing, ulOut, 5) == 5);
+    HOST_CHECK(SpscRing_PopBatchU32(&xRing, &ulOut[5], RING_SIZE + 8) == (RING_SIZE - 5));
+    for (ulIndex = 0; ulIndex < RING_SIZE; ulIndex++)
+    {
+        HOST_CHECK(ulOut[ulIndex] == ulIn[ulIndex]);
+    }
+    HOST_CHECK(SpscRing_PopBatchU32(&xRing, ulOut, 4) == 0);
+    HOST_CHECK(SpscRing_Count(&xRing) == 0);
+}
+
+/* The other element types only differ in the width */
+static void prvTestTypes(void)
+{
+    uint8 ucStorage[4];
+    uint16 usStorage[8];
+    SpscRing xRing8 = SPSC_RING_INITIALIZER(ucStorage);
+    SpscRing xRing16 = SPSC_RING_INITIALIZER(usStorage);
+    uint8 ucValue = 0;
+    uint16 usValues[8];
+
+    HOST_CHECK(SPSC_RING_IS_POWER_OF_TWO(4U) && !SPSC_RING_IS_POWER_OF_TWO(12U));
+    HOST_CHECK((SpscRing_PushU8(&xRing8, 0xA5) == TRUE) && (SpscRing_PopU8(&xRing8, &ucValue) == TRUE));
+    HOST_CHECK(ucValue == 0xA5);
+    usValues[0] = 0xFFFF;
+    usValues[1] = 0x1234;
+    HOST_CHECK(SpscRing_PushBatchU16(&xRing16, usValues, 2) == 2);
+    usValues[0] = 0;
+    usValues[1] = 0;
+    HOST_CHECK(SpscRing_PopBatchU16(&xRing16, usValues, 8) == 2);
+    HOST_CHECK((usValues[0] == 0xFFFF) && (usValues[1] == 0x1234));
+}
+
+/* Producer: single and batch pushes of a counter, a rejected element is
+ * pushed again, so the consumer must see every value once. Both sides
+ * yield when they cannot go on, the host may have a single core. */
+static void *prvProducer(void *pvParameters)
+{
+    uint32 ulBatch[8];
+    uint32 ulNext = 0, ulRejected = 0, ulCount, ulIndex, ulTaken;
+
+    while (ulNext < STRESS_ELEMENTS)
+    {
+        if ((ulNext & 0x100U) == 0)
+        {
+            if (SpscRing_PushU32(&xStressRing, ulNext) == TRUE)
+            {
+                ulNext++;
+            }
+            else
+            {
+                ulRejected++;
+                sched_yield();
+            }
+        }
+        else
+        {
+            ulCount = 1U + (ulNext % 8U);
+            if (ulCount > (STRESS_ELEMENTS - ulNext))
+            {
+                ulCount = STRESS_ELEMENTS - ulNext;
+            }
+            for (ulIndex = 0; ulIndex < ulCount; ulIndex++)
+            {
+                ulBatch[ulIndex] = ulNext + ulIndex;
+            }
+            ulTaken = SpscRing_PushBatchU32(&xStressRing, ulBatch, ulCount);
+            ulNext += ulTaken;
+            ulRejected += ulCount - ulTaken;
+            if (ulTaken < ulCount)
+            {
+                sched_yield();
+            }
+        }
+    }
+
+    *(uint32 *) pvParameters = ulRejected;
+    return NULL;
+}
+
+static void prvTestStress(void)
+{
+    pthread_t xProducer;
+    uint32 ulBatch[8];
+    uint32 ulExpected = 0, ulErrors = 0, ulRejected = 0, ulCount, ulIndex, ulValue;
+
+    xStressRing.ulHead = NEAR_WRAP;
+    xStressRing.ulTail = NEAR_WRAP;
+    HOST_CHECK(pthread_create(&xProducer, NULL, prvProducer, &ulRejected) == 0);
+
+    while (ulExpected < STRESS_ELEMENTS)
+    {
+        if ((ulExpected & 0x80U) == 0)
+        {
+            if (SpscRing_PopU32(&xStressRing, &ulValue) == TRUE)
+            {
+                ulErrors += (ulValue != ulExpected) ? 1U : 0U;
+                ulExpected++;
+            }
+            else
+            {
+                sched_yield();
+            }
+        }
+        else
+        {
+            ulCount = SpscRing_PopBatchU32(&xStressRing, ulBatch, 1U + (ulExpected % 8U));
+            for (ulIndex = 0; ulIndex < ulCount; ulIndex++)
+            {
+                ulErrors += (ulBatch[ulIndex] != ulExpected) ? 1U : 0U;
+                ulExpected++;
+            }
+            if (ulCount == 0)
+            {
+                sched_yield();
+            }
+        }
+    }
+    pthread_join(xProducer, NULL);
+
+    HOST_CHECK(ulErrors == 0);
+    HOST_CHECK(SpscRing_Count(&xStressRing) == 0);
+    HOST_CHECK(SpscRing_GetOverflows(&xStressRing) == ulRejected);
+    printf("stress: %lu elements across the index wrap, %lu rejected while full\n",
+           (unsigned long) STRESS_ELEMENTS, (unsigned long) ulRejected);
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+int main(void)
+{
+    prvTestEmptyAndFull();
+    prvTestWrap();
+    prvTestBatch();
+    prvTestTypes();
+    prvTestStress();
+
+    return HOST_TEST_RESULT("spsc_ring_test");
+}
@@ -0,0 +1,383 @@
+ /******************************************************************************
+ *
+ * Module: Tools - Host Tests
+ *
+ * File Name: store_test.c
+ *
+ * Description: Tests of Services/Store on the EEPROM mock of port/. The
+ *              settings and fault records rotate through their slots with
+ *              rising sequences, a restart finds the newest record, and a
+ *              record cut by a power loss or corrupted fails its CRC so the
+ *              older record is used. The kernel calls of the store are
+ *              stubbed: the mutex checks it is taken and given in pairs and
+ *              a delay only moves the tick count.
+ *
+ * Author: Mustafa Tarek
+ *
+ *******************************************************************************/
+
+#include "host_test.h"
+#include "store.h"
+#include "task.h"
+#include "semphr.h"
+#include "eeprom_mock.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* First word of a slot, the layout of store.c */
+#define SETTINGS_SLOT_WORD(SLOT)    ((SLOT) * STORE_RECORD_WORDS)
+#define FAULT_SLOT_WORD(SLOT)       ((STORE_SETTINGS_BLOCKS * EEPROM_WORDS_PER_BLOCK) + ((SLOT) * STORE_RECORD_WORDS))
+
+#define RECORD_SEQUENCE(WORD)       (EepromMock_Get()->ulWords[(WORD) + 1U])
+#define RECORD_CRC_WORD(WORD)       ((WORD) + STORE_RECORD_WORDS - 1U)
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+/* What the kernel handles point to */
+static uint8 ucKernelObject;
+
+static TickType_t xTicks = 0;
+static boolean bMutexHeld = FALSE;
+static uint32 ulNotifications = 0;
+
+/*******************************************************************************
+ *                               Kernel Stubs                                  *
+ *******************************************************************************/
+
+QueueHandle_t xQueueCreateMutex(const uint8_t ucQueueType)
+{
+    (void) ucQueueType;
+    bMutexHeld = FALSE;
+    return (QueueHandle_t) &ucKernelObject;
+}
+
+BaseType_t xQueueSemaphoreTake(QueueHandle_t xQueue, TickType_t xTicksToWait)
+{
+    (void) xQueue;
+    (void) xTicksToWait;
+    HOST_CHECK(bMutexHeld == FALSE);
+    bMutexHeld = TRUE;
+    return pdTRUE;
+}
+
+BaseType_t xQueueGenericSend(QueueHandle_t xQueue, const void * const pvItemToQueue, TickType_t xTicksToWait,
+                             const BaseType_t xCopyPosition)
+{
+    (void) xQueue;
+    (void) pvItemToQueue;
+    (void) xTicksToWait;
+    (void) xCopyPosition;
+    HOST_CHECK(bMutexHeld == TRUE);
+    bMutexHeld = FALSE;
+    return pdTRUE;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return (TaskHandle_t) &ucKernelObject;
+}
+
+uint32_t ulTaskGenericNotifyTake(UBaseType_t uxIndexToWaitOn, BaseType_t xClearCountOnExit, TickType_t xTicksToWait)
+{
+    uint32 ulValue = ulNotifications;
+
+    (void) uxIndexToWaitOn;
+    (void) xTicksToWait;
+    if (xClearCountOnExit == pdTRUE)
+    {
+        ulNotifications = 0;
+    }
+    return ulValue;
+}
+
+BaseType_t xTaskGenericNotify(TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue,
+                              eNotifyAction eAction, uint32_t *pulPreviousNotificationValue)
+{
+    (void) xTaskToNotify;
+    (void) uxIndexToNotify;
+    (void) ulValue;
+    (void) eAction;
+    (void) pulPreviousNotificationValue;
+    ulNotifications++;
+    return pdPASS;
+}
+
+void vTaskDelay(const TickType_t xTicksToDelay)
+{
+    xTicks += xTicksToDelay;
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return xTicks;
+}
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+/* A restart on the EEPROM as it is */
+static boolean prvRestart(void)
+{
+    boolean bResult = Store_Init();
+
+    HOST_CHECK(bMutexHeld == FALSE);
+    return bResult;
+}
+
+static void prvProcess(void)
+{
+    Store_Process();
+    HOST_CHECK(bMutexHeld == FALSE);
+}
+
+static boolean prvSameSettings(const StoreSettings *pxA, const StoreSettings *pxB)
+{
+    return ((pxA->ucDriverLevel == pxB->ucDriverLevel) && (pxA->ucPassengerLevel == pxB->ucPassengerLevel) &&
+            (pxA->ucBudgetPolicy == pxB->ucBudgetPolicy)) ? TRUE : FALSE;
+}
+
+/* Every write differs from the one before it */
+static void prvNthSettings(uint32 ulWrite, StoreSettings *pxSettings)
+{
+    pxSettings->ucDriverLevel = (uint8) (ulWrite % 4U);
+    pxSettings->ucPassengerLevel = (uint8) ((ulWrite / 4U) % 4U);
+    pxSettings->ucBudgetPolicy = (uint8) ((ulWrite / 16U) % 2U);
+}
+
+static void prvTestUnavailable(void)
+{
+    StoreSettings xSettings = { 3, 3, 1 };
+    StoreFault xFault;
+
+    EepromMock_Erase();
+    EepromMock_Get()->bInitFails = TRUE;
+    HOST_CHECK(prvRestart() == FALSE);
+    HOST_CHECK(Store_GetStats()->bAvailable == FALSE);
+
+    /* Nothing is kept, and the store task is never woken */
+    Store_SetSettings(&xSettings);
+    Store_LogFault(0, 1, 250, 3);
+    Store_GetSettings(&xSettings);
+    HOST_CHECK(xSettings.ucDriverLevel == 0U);
+    HOST_CHECK(ulNotifications == 0U);
+    HOST_CHECK(Store_GetFault(0, &xFault) == FALSE);
+}
+
+static void prvTestSettingsRotation(void)
+{
+    StoreSettings xSettings, xRead;
+    uint32 ulWrites = Store_GetStats()->ulSettingsWrites;
+    uint32 ulCoalesced = Store_GetStats()->ulSettingsCoalesced;
+    uint32 ulWrite;
+    uint16 usWord;
+
+    /* Blank EEPROM: no settings, the seats stay off */
+    EepromMock_Erase();
+    HOST_CHECK(prvRestart() == FALSE);
+    HOST_CHECK(Store_GetStats()->bAvailable == TRUE);
+    HOST_CHECK(Store_GetStats()->usFaults == 0U);
+    Store_GetSettings(&xRead);
+    HOST_CHECK((xRead.ucDriverLevel == 0U) && (xRead.ucPassengerLevel == 0U) && (xRead.ucBudgetPolicy == 0U));
+
+    /* Each write goes to the slot after the last one with the next sequence */
+    for (ulWrite = 1; ulWrite <= (2U * STORE_SETTINGS_SLOTS) + 3U; ulWrite++)
+    {
+        prvNthSettings(ulWrite, &xSettings);
+        Store_SetSettings(&xSettings);
+        prvProcess();
+
+        usWord = SETTINGS_SLOT_WORD((ulWrite - 1U) % STORE_SETTINGS_SLOTS);
+        HOST_CHECK(EepromMock_Get()->usLastWord == RECORD_CRC_WORD(usWord));
+        HOST_CHECK(RECORD_SEQUENCE(usWord) == ulWrite);
+        HOST_CHECK(Store_GetStats()->ulSettingsWrites == ulWrites + ulWrite);
+    }
+    HOST_CHECK(EepromMock_Get()->ulBusyPolls == EepromMock_Get()->ulWrites);
+
+    HOST_CHECK(prvRestart() == TRUE);
+    Store_GetSettings(&xRead);
+    HOST_CHECK(prvSameSettings(&xRead, &xSettings) == TRUE);
+
+    /* Changes within the coalescing time are written once, the last one wins */
+    ulWrites = Store_GetStats()->ulSettingsWrites;
+    prvNthSettings(ulWrite++, &xSettings);
+    Store_SetSettings(&xSettings);
+    prvNthSettings(ulWrite, &xSettings);
+    Store_SetSettings(&xSettings);
+    Store_SetSettings(&xSettings);
+    prvProcess();
+    HOST_CHECK(Store_GetStats()->ulSettingsWrites == ulWrites + 1U);
+    HOST_CHECK(Store_GetStats()->ulSettingsCoalesced == ulCoalesced + 1U);
+    HOST_CHECK(prvRestart() == TRUE);
+    Store_GetSettings(&xRead);
+    HOST_CHECK(prvSameSettings(&xRead, &xSettings) == TRUE);
+}
+
+static void prvTestSettingsFallback(void)
+{
+    StoreSettings xOlder, xNewer, xRead;
+    uint32 ulSequence;
+    uint16 usWord;
+    uint8 ucSlot, ucWords;
+
+    EepromMock_Erase();
+    (void) prvRestart();
+    prvNthSettings(1, &xOlder);
+    Store_SetSettings(&xOlder);
+    prvProcess();
+    prvNthSettings(2, &xNewer);
+    Store_SetSettings(&xNewer);
+    prvProcess();
+
+    /* A flipped payload bit fails the CRC of the newest record */
+    usWord = SETTINGS_SLOT_WORD(1U);
+    EepromMock_Get()->ulWords[usWord + 2U] ^= 0x100UL;
+    HOST_CHECK(prvRestart() == TRUE);
+    Store_GetSettings(&xRead);
+    HOST_CHECK(prvSameSettings(&xRead, &xOlder) == TRUE);
+
+    /* The next write takes the slot after the record in use */
+    Store_SetSettings(&xNewer);
+    prvProcess();
+    HOST_CHECK(EepromMock_Get()->usLastWord == RECORD_CRC_WORD(usWord));
+    HOST_CHECK(prvRestart() == TRUE);
+    Store_GetSettings(&xRead);
+    HOST_CHECK(prvSameSettings(&xRead, &xNewer) == TRUE);
+
+    /* Fill every slot, then cut the power in the middle of each word of a
+     * write that overwrites the oldest record */
+    for (ucSlot = 0; ucSlot < STORE_SETTINGS_SLOTS; ucSlot++)
+    {
+        prvNthSettings(3U + ucSlot, &xOlder);
+        Store_SetSettings(&xOlder);
+        prvProcess();
+    }
+    usWord = SETTINGS_SLOT_WORD(((EepromMock_Get()->usLastWord / STORE_RECORD_WORDS) + 1U) % STORE_SETTINGS_SLOTS);
+    ulSequence = RECORD_SEQUENCE(usWord);
+    for (ucWords = 1; ucWords < STORE_RECORD_WORDS; ucWords++)
+    {
+        HOST_CHECK(prvRestart() == TRUE);
+        EepromMock_Get()->ulWritesLeft = ucWords;
+        Store_SetSettings(&xNewer);
+        prvProcess();
+        EepromMock_Get()->ulWritesLeft = EEPROM_MOCK_NO_CUT;
+
+        /* The sequence of the cut record is new, the CRC is not */
+        HOST_CHECK(EepromMock_Get()->usLastWord == usWord + ucWords - 1U);
+        HOST_CHECK((ucWords < 2U) || (RECORD_SEQUENCE(usWord) != ulSequence));
+        HOST_CHECK(prvRestart() == TRUE);
+        Store_GetSettings(&xRead);
+        HOST_CHECK(prvSameSettings(&xRead, &xOlder) == TRUE);
+    }
+
+    /* The write after the restart completes */
+    Store_SetSettings(&xNewer);
+    prvProcess();
+    HOST_CHECK(prvRestart() == TRUE);
+    Store_GetSettings(&xRead);
+    HOST_CHECK(prvSameSettings(&xRead, &xNewer) == TRUE);
+}
+
+static void prvTestFaults(void)
+{
+    const StoreStats *pxStats = Store_GetStats();
+    StoreFault xFault, xNewest;
+    uint32 ulCoalesced = pxStats->ulFaultsCoalesced;
+    uint32 ulDropped = pxStats->ulFaultsDropped;
+    uint32 ulWrite;
+
+    EepromMock_Erase();
+    (void) prvRestart();
+    HOST_CHECK(Store_GetFault(0, &xFault) == FALSE);
+
+    /* A repeat of a waiting fault only counts, a fifth fault is dropped */
+    xTicks = 5U * configTICK_RATE_HZ;
+    Store_LogFault(0, 1, 250, 3);
+    Store_LogFault(0, 1, 260, 2);
+    Store_LogFault(1, 2, -15, 1);
+    Store_LogFault(1, 3, 410, 1);
+    Store_LogFault(0, 4, 300, 3);
+    Store_LogFault(1, 5, 300, 3);
+    HOST_CHECK(pxStats->ulFaultsCoalesced == ulCoalesced + 1U);
+    HOST_CHECK(pxStats->ulFaultsDropped == ulDropped + 1U);
+    prvProcess();
+    HOST_CHECK(pxStats->usFaults == STORE_PENDING_FAULTS);
+
+    /* Newest first */
+    HOST_CHECK(Store_GetFault(0, &xFault) == TRUE);
+    HOST_CHECK((xFault.ucSeat == 0U) && (xFault.ucCode == 4U) && (xFault.ulSequence == 4U));
+    HOST_CHECK(Store_GetFault(2, &xFault) == TRUE);
+    HOST_CHECK((xFault.ucSeat == 1U) && (xFault.ucCode == 2U) && (xFault.sReading == -15));
+    HOST_CHECK(Store_GetFault(3, &xFault) == TRUE);
+    HOST_CHECK((xFault.ucCode == 1U) && (xFault.usCount == 2U) && (xFault.sReading == 260) &&
+               (xFault.ucLevel == 2U) && (xFault.ulTime == 5U));
+    HOST_CHECK(Store_GetFault(STORE_PENDING_FAULTS, &xFault) == FALSE);
+
+    /* The ring wraps: the count stops at the slots, the oldest is overwritten */
+    for (ulWrite = 0; ulWrite < STORE_FAULT_SLOTS; ulWrite++)
+    {
+        Store_LogFault((uint8) (ulWrite % 2U), (uint8) (ulWrite / 2U), (sint16) ulWrite, 1);
+        if ((ulWrite % STORE_PENDING_FAULTS) == (STORE_PENDING_FAULTS - 1U))
+        {
+            prvProcess();
+        }
+    }
+    HOST_CHECK(pxStats->usFaults == STORE_FAULT_SLOTS);
+    HOST_CHECK(Store_GetFault(0, &xNewest) == TRUE);
+    HOST_CHECK(xNewest.ulSequence == STORE_PENDING_FAULTS + STORE_FAULT_SLOTS);
+    HOST_CHECK(Store_GetFault(STORE_FAULT_SLOTS - 1U, &xFault) == TRUE);
+    HOST_CHECK(xFault.ulSequence == xNewest.ulSequence - (STORE_FAULT_SLOTS - 1U));
+    HOST_CHECK(Store_GetFault(STORE_FAULT_SLOTS, &xFault) == FALSE);
+    HOST_CHECK(FAULT_SLOT_WORD(STORE_FAULT_SLOTS) == EEPROM_WORDS);
+
+    /* A restart finds the newest fault and continues after it */
+    HOST_CHECK(prvRestart() == FALSE);
+    HOST_CHECK(pxStats->usFaults == STORE_FAULT_SLOTS);
+    HOST_CHECK(Store_GetFault(0, &xFault) == TRUE);
+    HOST_CHECK(xFault.ulSequence == xNewest.ulSequence);
+    Store_LogFault(1, 7, 0, 0);
+    prvProcess();
+    HOST_CHECK(Store_GetFault(0, &xFault) == TRUE);
+    HOST_CHECK((xFault.ucCode == 7U) && (xFault.ulSequence == xNewest.ulSequence + 1U));
+
+    /* A corrupted record is skipped by index and not counted after a restart */
+    EepromMock_Get()->ulWords[FAULT_SLOT_WORD((xNewest.ulSequence - 1U) % STORE_FAULT_SLOTS) + 4U] ^= 1UL;
+    HOST_CHECK(Store_GetFault(1, &xFault) == FALSE);
+    HOST_CHECK(Store_GetFault(2, &xFault) == TRUE);
+    HOST_CHECK(prvRestart() == FALSE);
+    HOST_CHECK(pxStats->usFaults == STORE_FAULT_SLOTS - 1U);
+}
+
+static void prvTestWriteErrors(void)
+{
+    StoreSettings xSettings;
+    uint32 ulErrors = Store_GetStats()->ulWriteErrors;
+
+    EepromMock_Erase();
+    (void) prvRestart();
+    EepromMock_Get()->bWritesFail = TRUE;
+    prvNthSettings(1, &xSettings);
+    Store_SetSettings(&xSettings);
+    Store_LogFault(0, 1, 0, 0);
+    prvProcess();
+    HOST_CHECK(Store_GetStats()->ulWriteErrors == ulErrors + 2U);
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+int main(void)
+{
+    prvTestUnavailable();
+    prvTestSettingsRotation();
+    prvTestSettingsFallback();
+    prvTestFaults();
+    prvTestWriteErrors();
+
+    return HOST_TEST_RESULT("store_test");
+}
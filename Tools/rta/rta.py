@@ -0,0 +1,481 @@
+#!/usr/bin/env python3
+"""
+Offline response-time analysis for the Seat Heater Control System.
+
+The task model below mirrors the tasks created in main.c (priorities, how each
+task is released and which mutexes it takes). Execution times are taken from
+simso.xml unless a measurement file overrides them, so the same model can be
+used both to check the current simso.xml and to regenerate it from WCETs
+measured on target.
+
+Analysis: fixed-priority preemptive scheduling, classic iterative RTA
+
+    R = C + B + sum_{j in hp(i)} ceil((R + J_j) / T_j) * C_j
+
+where hp(i) also contains the other tasks of the same priority (FreeRTOS
+time slices them, so they can always interfere) and B is the priority
+inheritance blocking bound: for every mutex whose ceiling is >= P_i, the
+longest critical section of a strictly lower priority task on that mutex.
+
+The release phases of the periodic tasks are not part of this analysis, it
+assumes they are all released together. "releases" plans the phases like
+Services/ReleasePlanner and simulates the periodic tasks and the sporadic
+tasks they release, once with every phase 0 (RELEASE_PHASES_ENABLE = 0) and
+once with the planned phases. It prints the worst release lateness (release
+to first execution, what the runtime report histograms) and response time of
+each task in both cases.
+
+Usage:
+    rta.py analyze    [--simso simso.xml] [--measured wcet.json] [--risk 0.8]
+    rta.py regenerate [--simso simso.xml] [--measured wcet.json] [-o out.xml]
+                      [--margin 1.2]
+    rta.py releases   [--simso simso.xml] [--measured wcet.json] [--plan-wcet]
+
+The measurement file is JSON:
+    {
+      "ReadTempForDriver": {"wcet": 1.4, "cs": {"CurrentTempMutexDriver": 0.02}},
+      "DisplayForDriver":  {"wcet": 96.0, "jitter": 0.0}
+    }
+All times are in milliseconds.
+"""
+
+import argparse
+import json
+import math
+import sys
+import xml.etree.ElementTree as ET
+
+# FreeRTOS tick in ms (configTICK_RATE_HZ = 100)
+TICK_MS = 10.0
+
+# Services/ReleasePlanner: RELEASE_PLANNER_HORIZON_TICKS and the load units
+# (0.1 ms) of one tick
+PLANNER_HORIZON_TICKS = 100
+PLANNER_UNITS_PER_TICK = int(TICK_MS * 10)
+
+# Time step of the release simulation: 0.1 ms
+SIM_STEPS_PER_MS = 10
+
+PERIODIC = "Periodic"
+SPORADIC = "Sporadic"
+
+# Keep in sync with the xTaskCreate() calls in main.c.
+#   activation: Periodic tasks use a fixed delay, Sporadic tasks are released
+#               by an event (button ISR or a queue) and "period" is their
+#               minimum inter-arrival time.
+#   cs:         default critical section length per mutex, in ms.
+#   load, after: the execution time per release (0.1 ms) and the ucAfter task
+#               of the task table, the input of the release planner.
+#   released_by: tasks whose jobs release a sporadic task in the release
+#               simulation, its "after" task by default.
+TASK_MODEL = [
+    # Button driven through eventTempSet, assume at most one press per 500 ms.
+    dict(name="SetTempForDriver", priority=4, activation=SPORADIC, period=500.0,
+         deadline=500.0, cs={"DesiredTempMutexDriver": 0.05}),
+    dict(name="SetTempForPassenger", priority=4, activation=SPORADIC, period=500.0,
+         deadline=500.0, cs={"DesiredTempMutexPassenger": 0.05}),
+    dict(name="ReadTempForDriver", priority=3, activation=PERIODIC, period=200.0,
+         deadline=200.0, cs={"CurrentTempMutexDriver": 0.05, "AdcMutex": 0.05},
+         load=10),
+    dict(name="ReadTempForPassenger", priority=3, activation=PERIODIC, period=200.0,
+         deadline=200.0, cs={"CurrentTempMutexPassenger": 0.05, "AdcMutex": 0.05},
+         load=10),
+    dict(name="ControlTempForDriver", priority=2, activation=PERIODIC, period=200.0,
+         deadline=200.0, cs={"CurrentTempMutexDriver": 0.05, "DesiredTempMutexDriver": 0.05},
+         load=10, after="ReadTempForDriver"),
+    dict(name="ControlTempForPassenger", priority=2, activation=PERIODIC, period=200.0,
+         deadline=200.0, cs={"CurrentTempMutexPassenger": 0.05, "DesiredTempMutexPassenger": 0.05},
+         load=10, after="ReadTempForPassenger"),
+    # Released by the controller through Controller_Heating* queues.
+    dict(name="ControlLedsForDriver", priority=2, activation=SPORADIC, period=200.0,
+         deadline=200.0, cs={},
+         load=5, after="ControlTempForDriver"),
+    dict(name="ControlLedsForPassenger", priority=2, activation=SPORADIC, period=200.0,
+         deadline=200.0, cs={},
+         load=5, after="ControlTempForPassenger"),
+    # Released by the reading task through Reading_Display* queues. The
+    # telemetry frame is copied into the UART gatekeeper slot of the seat.
+    dict(name="DisplayForDriver", priority=2, activation=SPORADIC, period=200.0,
+         deadline=200.0, cs={"DesiredTempMutexDriver": 0.05},
+         load=10, after="ReadTempForDriver"),
+    dict(name="DisplayForPassenger", priority=2, activation=SPORADIC, period=200.0,
+         deadline=200.0, cs={"DesiredTempMutexPassenger": 0.05},
+         load=10, after="ReadTempForPassenger"),
+    # Released by the display tasks: both seat frames per 200 ms. The UART0
+    # interrupt sends the bytes (2 x 13 bytes take 27 ms at 9600 baud), the
+    # job encodes them into the TX buffer. Sleeping while the line drains
+    # the buffer is not execution, so the 200 ms deadline is met when the
+    # frames are handed to the line before the next ones replace them.
+    dict(name="UartGatekeeper", priority=2, activation=SPORADIC, period=200.0,
+         deadline=200.0, cs={}, released_by=("DisplayForDriver", "DisplayForPassenger")),
+    # vTaskDelayUntil(RUNTIME_MEASUREMENTS_TASK_PERIODICITY) is 1000 ticks. The
+    # report is logged and the clock switch is run by the UART gatekeeper.
+    dict(name="RunTimeMeasurements", priority=1, activation=PERIODIC, period=1000 * TICK_MS,
+         deadline=1000 * TICK_MS, cs={},
+         load=10),
+    # Released by the log records of the runtime report, queues the log
+    # frames to the UART gatekeeper (waiting on its full FIFO is not execution).
+    dict(name="Logger", priority=1, activation=SPORADIC, period=1000 * TICK_MS,
+         deadline=1000 * TICK_MS, cs={},
+         load=10, after="RunTimeMeasurements"),
+    # Released by the command lines typed on the terminal (assumed at most one
+    # every 10 s), the reply lines are queued to the UART gatekeeper.
+    dict(name="Console", priority=1, activation=SPORADIC, period=1000 * TICK_MS,
+         deadline=1000 * TICK_MS, cs={}),
+    # Released by a settings change or a fault, at most one batch per
+    # STORE_COALESCE_MS. It sleeps while the EEPROM programs a word.
+    dict(name="Store", priority=1, activation=SPORADIC, period=200 * TICK_MS,
+         deadline=200 * TICK_MS, cs={}),
+]
+
+
+class Task(object):
+    def __init__(self, model, wcet, cs, jitter, simso_attrs):
+        self.name = model["name"]
+        self.priority = model["priority"]
+        self.activation = model["activation"]
+        self.period = model["period"]
+        self.deadline = model["deadline"]
+        self.wcet = wcet
+        self.cs = cs
+        self.jitter = jitter
+        self.load = model.get("load", 0)
+        self.after = model.get("after")
+        self.released_by = model.get("released_by", (self.after,) if self.after else ())
+        self.simso_attrs = simso_attrs
+        self.blocking = 0.0
+        self.response = None
+
+
+def load_simso(path):
+    tree = ET.parse(path)
+    tasks = {}
+    for node in tree.getroot().iter("task"):
+        tasks[node.get("name")] = dict(node.attrib)
+    return tree, tasks
+
+
+def load_measured(path):
+    if path is None:
+        return {}
+    with open(path) as fp:
+        return json.load(fp)
+
+
+def build_taskset(simso_tasks, measured):
+    taskset = []
+    for model in TASK_MODEL:
+        attrs = simso_tasks.get(model["name"], {})
+        meas = measured.get(model["name"], {})
+        if "wcet" in meas:
+            wcet = float(meas["wcet"])
+        elif "WCET" in attrs:
+            wcet = float(attrs["WCET"])
+        else:
+            sys.exit("no WCET for task %s in simso.xml or the measurement file" % model["name"])
+        cs = dict(model["cs"])
+        cs.update(meas.get("cs", {}))
+        taskset.append(Task(model, wcet, cs, float(meas.get("jitter", 0.0)), attrs))
+    return taskset
+
+
+def compute_blocking(taskset):
+    """Priority inheritance bound: one critical section per mutex of ceiling >= P_i."""
+    ceilings = {}
+    for t in taskset:
+        for res in t.cs:
+            ceilings[res] = max(ceilings.get(res, 0), t.priority)
+    for t in taskset:
+        blocking = 0.0
+        for res, ceiling in ceilings.items():
+            if ceiling < t.priority:
+                continue
+            lower = [l.cs[res] for l in taskset if l.priority < t.priority and res in l.cs]
+            if lower:
+                blocking += max(lower)
+        t.blocking = blocking
+
+
+def compute_response_times(taskset):
+    for t in taskset:
+        interferers = [j for j in taskset if j is not t and j.priority >= t.priority]
+        limit = max(t.deadline, t.period) * 10.0
+        response = t.wcet + t.blocking
+        while True:
+            demand = t.wcet + t.blocking
+            for j in interferers:
+                demand += math.ceil((response + j.jitter) / j.period) * j.wcet
+            if demand == response:
+                break
+            response = demand
+            if response > limit:
+                response = float("inf")
+                break
+        t.response = response + t.jitter
+
+
+def analyze(taskset):
+    compute_blocking(taskset)
+    compute_response_times(taskset)
+
+
+def plan_phases(taskset, plan_wcet=False):
+    """Phases in ticks of the periodic tasks, ReleasePlanner_ComputePhases().
+    With plan_wcet the loads are the WCETs instead of the task table loads."""
+    index = dict((t.name, i) for i, t in enumerate(taskset))
+    load = [int(round(t.wcet * 10)) if plan_wcet else t.load for t in taskset]
+    loads = [load[i] if t.activation == PERIODIC else 0 for i, t in enumerate(taskset)]
+    # The work of an event driven task is charged to the task releasing it
+    for i, t in enumerate(taskset):
+        if t.activation != PERIODIC and t.after is not None:
+            loads[index[t.after]] += load[i]
+
+    demand = [0] * PLANNER_HORIZON_TICKS
+    phases = {}
+
+    def place(period, load, phase, commit):
+        peak = 0
+        releases = PLANNER_HORIZON_TICKS // period if period <= PLANNER_HORIZON_TICKS else 1
+        for release in range(releases):
+            tick = (phase + release * period) % PLANNER_HORIZON_TICKS
+            remaining = load
+            while True:
+                chunk = min(remaining, PLANNER_UNITS_PER_TICK)
+                if commit:
+                    demand[tick] += chunk
+                else:
+                    peak = max(peak, demand[tick] + chunk)
+                remaining -= chunk
+                tick = (tick + 1) % PLANNER_HORIZON_TICKS
+                if remaining <= 0:
+                    break
+        return peak
+
+    for i, t in enumerate(taskset):
+        if t.activation != PERIODIC:
+            continue
+        period = int(round(t.period / TICK_MS))
+        after = index.get(t.after, len(taskset))
+        base = phases[taskset[after].name] if after < i else 0
+        span = min(period, PLANNER_HORIZON_TICKS)
+        best_phase, best_peak = base % span, None
+        for offset in range(span):
+            candidate = (base + offset) % span
+            peak = place(period, loads[i], candidate, False)
+            if best_peak is None or peak < best_peak:
+                best_peak, best_phase = peak, candidate
+        phases[t.name] = best_phase
+        place(period, loads[i], best_phase, True)
+    return phases
+
+
+def simulate_releases(taskset, phases, duration_ms):
+    """Fixed priority preemptive schedule of the periodic tasks and the
+    sporadic tasks they release, time sliced per tick between equal
+    priorities. Every job runs for its WCET. Returns the worst lateness and
+    response time of each task, in ms."""
+    steps_per_tick = int(TICK_MS * SIM_STEPS_PER_MS)
+    releases = {}
+    for t in taskset:
+        if t.activation == PERIODIC:
+            period = int(round(t.period * SIM_STEPS_PER_MS))
+            first = phases.get(t.name, 0) * steps_per_tick
+            releases[t.name] = set(range(first, int(duration_ms * SIM_STEPS_PER_MS), period))
+    released = dict((t.name, [u for u in taskset if t.name in u.released_by]) for t in taskset)
+    ready = dict((p, []) for p in set(t.priority for t in taskset))
+    worst = dict((t.name, [0.0, 0.0]) for t in taskset if t.name in releases or t.released_by)
+
+    def release(task, step):
+        ready[task.priority].append(dict(task=task, release=step, start=None,
+                                         left=max(1, int(round(task.wcet * SIM_STEPS_PER_MS)))))
+
+    for step in range(int(duration_ms * SIM_STEPS_PER_MS)):
+        for t in taskset:
+            if step in releases.get(t.name, ()):
+                release(t, step)
+        busy = [p for p in ready if ready[p]]
+        if not busy:
+            continue
+        queue = ready[max(busy)]
+        if (step % steps_per_tick == 0) and (queue[0]["start"] is not None):
+            # The tick moves the running task behind the others of its priority
+            queue.append(queue.pop(0))
+        job = queue[0]
+        if job["start"] is None:
+            job["start"] = step
+        job["left"] -= 1
+        if job["left"] == 0:
+            ready[job["task"].priority].pop(0)
+            entry = worst[job["task"].name]
+            entry[0] = max(entry[0], float(job["start"] - job["release"]) / SIM_STEPS_PER_MS)
+            entry[1] = max(entry[1], float(step + 1 - job["release"]) / SIM_STEPS_PER_MS)
+            for follower in released[job["task"].name]:
+                release(follower, step + 1)
+    return worst
+
+
+def print_releases(taskset, plan_wcet):
+    phases = plan_phases(taskset, plan_wcet)
+    duration = max(t.period for t in taskset if t.activation == PERIODIC)
+    together = simulate_releases(taskset, {}, duration)
+    planned = simulate_releases(taskset, phases, duration)
+    print("%-24s %6s  %19s  %19s" % ("", "", "phases 0", "planned phases"))
+    print("%-24s %6s  %9s %9s  %9s %9s"
+          % ("task", "phase", "lateness", "R", "lateness", "R"))
+    for t in taskset:
+        if t.name not in planned:
+            continue
+        phase = "%d" % phases[t.name] if t.name in phases else "-"
+        print("%-24s %6s  %9.1f %9.1f  %9.1f %9.1f"
+              % ((t.name, phase) + tuple(together[t.name]) + tuple(planned[t.name])))
+    print("\nphases in ticks, times in ms over %.0f ms" % duration)
+
+
+def stale_entries(taskset):
+    """Differences between simso.xml and the task model taken from main.c."""
+    notes = []
+    for t in taskset:
+        attrs = t.simso_attrs
+        if not attrs:
+            notes.append("%s: missing from simso.xml" % t.name)
+            continue
+        if attrs.get("task_type") != t.activation:
+            notes.append("%s: simso.xml says %s, main.c is %s"
+                         % (t.name, attrs.get("task_type"), t.activation))
+        if float(attrs.get("period", 0)) != t.period:
+            notes.append("%s: simso.xml period %s ms, main.c %g ms"
+                         % (t.name, attrs.get("period"), t.period))
+        if float(attrs.get("deadline", 0)) != t.deadline:
+            notes.append("%s: simso.xml deadline %s ms, model %g ms"
+                         % (t.name, attrs.get("deadline"), t.deadline))
+        # A task executes for the whole of its critical sections.
+        if t.wcet < sum(t.cs.values()):
+            notes.append("%s: WCET %.2f ms is shorter than its critical sections (%.2f ms)"
+                         % (t.name, t.wcet, sum(t.cs.values())))
+    return notes
+
+
+def print_report(taskset, risk):
+    order = sorted(taskset, key=lambda t: -t.priority)
+    print("%-24s %4s %-9s %8s %8s %8s %8s %9s  %s"
+          % ("task", "prio", "type", "C", "T", "D", "B", "R", "status"))
+    worst = 0
+    for t in order:
+        if t.response == float("inf") or t.response > t.deadline:
+            status, level = "DEADLINE MISS", 2
+        elif t.response > risk * t.deadline:
+            status, level = "at risk (%.0f%% of D)" % (100.0 * t.response / t.deadline), 1
+        else:
+            status, level = "ok", 0
+        worst = max(worst, level)
+        print("%-24s %4d %-9s %8.2f %8.1f %8.1f %8.2f %9.2f  %s"
+              % (t.name, t.priority, t.activation, t.wcet, t.period, t.deadline,
+                 t.blocking, t.response, status))
+    util = sum(t.wcet / t.period for t in taskset)
+    print("\ntotal utilization: %.1f%%" % (100.0 * util))
+    return worst
+
+
+def write_simso(tree, taskset, path, margin):
+    root = tree.getroot()
+    tasks_node = root.find("tasks")
+    fields = [f for f in tasks_node.findall("field")]
+    for node in list(tasks_node):
+        tasks_node.remove(node)
+    for f in fields:
+        tasks_node.append(f)
+
+    duration_ms = float(root.get("duration")) / float(root.get("cycles_per_ms"))
+    for index, t in enumerate(taskset):
+        attrs = dict(t.simso_attrs)
+        attrs.update({
+            "id": str(index + 1),
+            "name": t.name,
+            "WCET": "%.1f" % (t.wcet * margin),
+            "period": "%.1f" % t.period,
+            "deadline": "%.1f" % t.deadline,
+            "priority": str(t.priority),
+            "task_type": t.activation,
+        })
+        attrs.setdefault("ACET", "0.0")
+        attrs.setdefault("abort_on_miss", "no")
+        attrs.setdefault("activationDate", "0.0")
+        attrs.setdefault("base_cpi", "1.0")
+        attrs.setdefault("et_stddev", "0.0")
+        attrs.setdefault("instructions", "0")
+        attrs.setdefault("mix", "0.5")
+        attrs.setdefault("preemption_cost", "0")
+        if t.activation == SPORADIC:
+            # Worst case for a sporadic task: released at its minimum inter-arrival time.
+            count = int(duration_ms // t.period)
+            attrs["list_activation_dates"] = " ".join("%.1f" % (k * t.period) for k in range(count))
+        else:
+            attrs["list_activation_dates"] = ""
+        ET.SubElement(tasks_node, "task", attrs)
+
+    lines = ['<?xml version="1.0" ?>']
+    lines.append(_open_tag(root))
+    for child in root:
+        if child.tag == "tasks":
+            lines.append("\t<tasks>")
+            for node in child:
+                lines.append("\t\t" + _empty_tag(node))
+            lines.append("\t</tasks>")
+        elif len(child):
+            lines.append("\t" + _open_tag(child))
+            for node in child:
+                lines.append("\t\t" + _empty_tag(node))
+            lines.append("\t</%s>" % child.tag)
+        else:
+            lines.append("\t" + _empty_tag(child))
+    lines.append("</%s>" % root.tag)
+    with open(path, "w", newline="\r\n") as fp:
+        fp.write("\n".join(lines) + "\n")
+
+
+def _attrs(node):
+    return "".join(' %s="%s"' % (k, node.get(k)) for k in sorted(node.keys()))
+
+
+def _open_tag(node):
+    return "<%s%s>" % (node.tag, _attrs(node))
+
+
+def _empty_tag(node):
+    return "<%s%s/>" % (node.tag, _attrs(node))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("command", choices=["analyze", "regenerate", "releases"])
+    parser.add_argument("--simso", default="simso.xml")
+    parser.add_argument("--measured", help="JSON file with measured WCETs and critical sections")
+    parser.add_argument("--risk", type=float, default=0.8,
+                        help="flag tasks whose response time exceeds this fraction of the deadline")
+    parser.add_argument("--margin", type=float, default=1.0,
+                        help="safety factor applied to WCETs written by regenerate")
+    parser.add_argument("-o", "--output", help="output file for regenerate (default: --simso)")
+    parser.add_argument("--plan-wcet", action="store_true",
+                        help="releases: plan the phases with the WCETs instead of the task table loads")
+    args = parser.parse_args()
+
+    tree, simso_tasks = load_simso(args.simso)
+    taskset = build_taskset(simso_tasks, load_measured(args.measured))
+
+    if args.command == "analyze":
+        for note in stale_entries(taskset):
+            print("stale: " + note)
+        analyze(taskset)
+        worst = print_report(taskset, args.risk)
+        return 1 if worst == 2 else 0
+
+    if args.command == "releases":
+        print_releases(taskset, args.plan_wcet)
+        return 0
+
+    write_simso(tree, taskset, args.output or args.simso, args.margin)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
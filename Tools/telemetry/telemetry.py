@@ -0,0 +1,308 @@
+#!/usr/bin/env python3
+"""Decoder and pretty-printer of the telemetry frames sent on UART0.
+
+Every frame (Services/Telemetry) is:
+
+    payload  version, type, sequence, body
+    crc      CRC-16/CCITT-FALSE of the payload, little endian
+    frame    COBS(payload + crc) followed by a 0x00 delimiter
+
+Frame types:
+
+    seat state  seat, temperature (sint16 LE, 0.1 C), desired level (C),
+                heat intensity, flags
+    log         records of message identifier, argument count and the
+                arguments as base-128 varints (Services/Log). The format
+                strings are read from Services/Log/log_messages.h.
+    seat delta  seat, field mask, then the value of every field in the mask
+                in the seat state order (Services/Display). It is applied to
+                the last state of the seat, a seat state is a keyframe.
+
+Printable text in front of a frame (the text display format is not
+delimited) is passed through as is.
+
+Usage:
+    telemetry.py [capture.bin]           decode a capture file (or stdin)
+    telemetry.py --port /dev/ttyACM0     decode a serial port (needs pyserial)
+                 [--baud 9600] [--raw] [--dict log_messages.h]
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+VERSION = 1
+TYPE_SEAT_STATE = 0x01
+TYPE_LOG = 0x02
+TYPE_SEAT_DELTA = 0x03
+HEADER_SIZE = 3
+SEAT_STATE_BODY = 6
+FLAG_SLOW_SAMPLING = 0x01
+
+# Seat delta fields: mask bit, name, struct format
+FIELDS = [(0x01, "temperature", "<h"), (0x02, "desired", "<B"),
+          (0x04, "intensity", "<B"), (0x08, "flags", "<B")]
+
+SEATS = {0: "Driver", 1: "Passenger"}
+LEVELS = {0: "OFF", 25: "LOW", 30: "MEDIUM", 35: "HIGH"}
+INTENSITIES = {0: "OFF", 1: "LOW", 2: "MEDIUM", 3: "HIGH", 4: "ERROR"}
+
+DEFAULT_DICTIONARY = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                  "..", "..", "Services", "Log", "log_messages.h")
+
+MESSAGE_RE = re.compile(r'X\(\s*(\w+)\s*,\s*"((?:[^"\\]|\\.)*)"\s*\)')
+CONVERSION_RE = re.compile(r"%(%|u|d|x|t|e\{[^}]*\})")
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(frame):
+    out = bytearray()
+    index = 0
+    while index < len(frame):
+        code = frame[index]
+        if code == 0 or index + code > len(frame) + 1:
+            raise ValueError("bad COBS code")
+        out += frame[index + 1:index + code]
+        index += code
+        if code < 0xFF and index < len(frame):
+            out.append(0)
+    return bytes(out)
+
+
+def is_text(data):
+    return all(32 <= b < 127 or b in (9, 10, 13) for b in data)
+
+
+def checked_payload(frame):
+    """Payload of a COBS frame whose CRC matches, None otherwise"""
+    try:
+        data = cobs_decode(frame)
+    except ValueError:
+        return None
+    if len(data) < HEADER_SIZE + 2 or crc16(data[:-2]) != struct.unpack("<H", data[-2:])[0]:
+        return None
+    return data[:-2]
+
+
+def load_dictionary(path):
+    """Format strings of the log messages, the identifier is the position"""
+    with open(path) as fp:
+        text = fp.read()
+    text = text[text.index("#define LOG_MESSAGES(X)"):]
+    return MESSAGE_RE.findall(text)
+
+
+def format_message(fmt, args):
+    args = list(args)
+
+    def convert(match):
+        spec = match.group(1)
+        if spec == "%":
+            return "%"
+        if not args:
+            return "<missing>"
+        value = args.pop(0)
+        if spec == "u":
+            return str(value)
+        if spec == "d":
+            return str(value - (1 << 32) if value & 0x80000000 else value)
+        if spec == "x":
+            return "0x%X" % value
+        if spec == "t":
+            return "%d.%d" % (value // 10, value % 10)
+        names = spec[2:-1].split("|")
+        return names[value] if value < len(names) else str(value)
+
+    text = CONVERSION_RE.sub(convert, fmt)
+    if args:
+        text += " " + " ".join(str(a) for a in args)
+    return text
+
+
+def read_varint(data, index):
+    value = shift = 0
+    while True:
+        if index >= len(data):
+            raise ValueError("truncated varint")
+        byte = data[index]
+        index += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, index
+
+
+class Decoder:
+    def __init__(self, dictionary, raw=False):
+        self.dictionary = dictionary
+        self.raw = raw
+        self.frames = 0
+        self.crc_errors = 0
+        self.bad_frames = 0
+        self.lost = 0
+        self.last_sequence = None
+        self.seats = {}
+
+    def feed(self, chunk, out):
+        # Leading text ends where the frame starts, try every split point
+        for start in range(len(chunk) + 1):
+            if not is_text(chunk[:start]):
+                break
+            payload = checked_payload(chunk[start:])
+            if payload is not None:
+                out.write(chunk[:start].decode("ascii"))
+                self.frame(payload, out)
+                return
+        if is_text(chunk):
+            out.write(chunk.decode("ascii"))
+            return
+        self.crc_errors += 1
+        out.write("! CRC error or undecodable frame %s\n" % chunk.hex())
+
+    def frame(self, payload, out):
+        version, kind, sequence = struct.unpack("<BBB", payload[:HEADER_SIZE])
+        body = payload[HEADER_SIZE:]
+        if version != VERSION or kind not in (TYPE_SEAT_STATE, TYPE_LOG, TYPE_SEAT_DELTA):
+            self.bad_frames += 1
+            out.write("! unsupported frame version %d type %d\n" % (version, kind))
+            return
+        self.frames += 1
+        # The gatekeeper numbers the frames as it sends them, so a gap is
+        # a frame lost on the line.
+        if self.last_sequence is not None:
+            self.lost += (sequence - self.last_sequence - 1) & 0xFF
+        self.last_sequence = sequence
+        if self.raw:
+            out.write("#%03d type %d %s\n" % (sequence, kind, body.hex()))
+        elif kind == TYPE_SEAT_STATE:
+            self.seat_state(sequence, body, out)
+        elif kind == TYPE_SEAT_DELTA:
+            self.seat_delta(sequence, body, out)
+        else:
+            self.log(body, out)
+
+    def seat_state(self, sequence, body, out):
+        if len(body) != SEAT_STATE_BODY:
+            self.bad_frames += 1
+            out.write("! unexpected seat state %s\n" % body.hex())
+            return
+        seat, temperature, desired, intensity, flags = struct.unpack("<BhBBB", body)
+        self.seats[seat] = dict(temperature=temperature, desired=desired,
+                                intensity=intensity, flags=flags)
+        self.print_seat(sequence, seat, "", out)
+
+    def seat_delta(self, sequence, body, out):
+        if len(body) < 2:
+            self.bad_frames += 1
+            out.write("! unexpected seat delta %s\n" % body.hex())
+            return
+        seat, mask = body[0], body[1]
+        index = 2
+        state = self.seats.setdefault(seat, {})
+        changed = []
+        try:
+            for bit, name, fmt in FIELDS:
+                if mask & bit:
+                    state[name] = struct.unpack_from(fmt, body, index)[0]
+                    index += struct.calcsize(fmt)
+                    changed.append(name)
+        except struct.error:
+            self.bad_frames += 1
+            out.write("! truncated seat delta %s\n" % body.hex())
+            return
+        self.print_seat(sequence, seat, "  (%s)" % ", ".join(changed), out)
+
+    def print_seat(self, sequence, seat, suffix, out):
+        state = self.seats[seat]
+        if len(state) < len(FIELDS):
+            out.write("#%03d %-9s %s, waiting for a keyframe\n"
+                      % (sequence, SEATS.get(seat, "seat%d" % seat), suffix.strip()))
+            return
+        out.write("#%03d %-9s %5.1f C  level %-6s heater %-6s %s%s\n" % (
+            sequence, SEATS.get(seat, "seat%d" % seat), state["temperature"] / 10.0,
+            LEVELS.get(state["desired"], str(state["desired"])),
+            INTENSITIES.get(state["intensity"], str(state["intensity"])),
+            "slow" if state["flags"] & FLAG_SLOW_SAMPLING else "fast", suffix))
+
+    def log(self, body, out):
+        index = 0
+        try:
+            while index < len(body):
+                message, count = body[index], body[index + 1]
+                index += 2
+                args = []
+                for _ in range(count):
+                    value, index = read_varint(body, index)
+                    args.append(value)
+                if message < len(self.dictionary):
+                    out.write(format_message(self.dictionary[message][1], args) + "\n")
+                else:
+                    out.write("log #%d %s\n" % (message, " ".join(str(a) for a in args)))
+        except (IndexError, ValueError):
+            self.bad_frames += 1
+            out.write("! truncated log record in %s\n" % body.hex())
+
+    def summary(self, out):
+        out.write("frames %d, lost %d, crc errors %d, bad frames %d\n"
+                  % (self.frames, self.lost, self.crc_errors, self.bad_frames))
+
+
+def read_chunks(stream):
+    pending = bytearray()
+    while True:
+        data = stream.read(1)
+        if not data:
+            break
+        if data[0] == 0:
+            yield bytes(pending)
+            pending.clear()
+        else:
+            pending += data
+    if pending:
+        yield bytes(pending)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("capture", nargs="?", help="binary capture file, stdin if omitted")
+    parser.add_argument("--port", help="serial port of the board")
+    parser.add_argument("--baud", type=int, default=9600)
+    parser.add_argument("--raw", action="store_true", help="print the frame bodies in hex")
+    parser.add_argument("--dict", default=DEFAULT_DICTIONARY,
+                        help="log message dictionary (default: Services/Log/log_messages.h)")
+    args = parser.parse_args()
+
+    if args.port:
+        import serial  # pyserial, only needed for live decoding
+        stream = serial.Serial(args.port, args.baud)
+    elif args.capture:
+        stream = open(args.capture, "rb")
+    else:
+        stream = sys.stdin.buffer
+
+    decoder = Decoder(load_dictionary(args.dict), args.raw)
+    try:
+        for chunk in read_chunks(stream):
+            if chunk:
+                decoder.feed(chunk, sys.stdout)
+                sys.stdout.flush()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        decoder.summary(sys.stderr)
+    return 1 if decoder.crc_errors or decoder.bad_frames else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
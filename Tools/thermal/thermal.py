@@ -0,0 +1,228 @@
+#!/usr/bin/env python3
+"""
+Thermal simulation of the seat heaters, for tuning the boost profiles.
+
+Every seat is a first-order thermal mass heated from the ambient temperature:
+
+    tau * dT/dt = rise * duty - (T - ambient)
+
+where rise is how far full power heats the seat above the ambient and duty is
+the share of the PWM frame the power budget granted the seat. The controller
+is stepped every 200 ms like vHeaterControllerTask: the reading is rounded
+down to 0.1 C, then the intensity bands with hysteresis and dwell time, the
+boost profile and the power budget are applied as in the firmware. Their
+parameters are read from the headers, so the simulation follows the build:
+
+    Services/Intensity/intensity_cfg.h      bands, hysteresis, dwell time
+    Services/Profile/profile_cfg.h          profile steps, early exit
+    Services/HeaterBudget/heater_budget.h   slots per intensity, power limit
+
+For every level the time to comfort (the error below the OFF band edge) is
+printed with and without the profiles, for one seat heating alone and for
+both seats heating at once under the budget policy.
+
+Usage:
+    thermal.py [--ambient 10] [--rise 60] [--tau 300] [--policy fair|driver]
+               [--duration 1200] [--trace LEVEL]
+"""
+
+import argparse
+import math
+import os
+import re
+import sys
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "..")
+
+# UserHeatInput and HeatIntensity of std_types.h
+LEVELS = {"LOW": 25, "MEDIUM": 30, "HIGH": 35}
+INTENSITIES = ["INTENSITYOFF", "LOWINTENSITY", "MEDIUMINTENSITY", "HIGHINTENSITY", "ERROR"]
+OFF, LOW, MEDIUM, HIGH, ERROR = range(5)
+
+CONTROLLER_PERIOD_S = 0.2
+
+DEFINE_RE = re.compile(r"^#define\s+(\w+)\s+(.+?)\s*$", re.M)
+STEP_RE = re.compile(r"\{\s*(\d+)U?\s*,\s*(\w+)\s*\}")
+
+
+def read_defines(*paths):
+    """Integer macros of the headers, references to earlier macros resolved"""
+    values = {}
+    for path in paths:
+        with open(os.path.join(ROOT, path)) as fp:
+            text = fp.read()
+        for name, body in DEFINE_RE.findall(text):
+            if "{" in body:
+                values[name] = body
+                continue
+            expr = re.sub(r"(\d+)U?L*\b", r"\1", body)
+            expr = re.sub(r"\b([A-Z_][A-Z0-9_]*)\b", lambda m: str(values.get(m.group(1), m.group(1))), expr)
+            try:
+                values[name] = int(eval(expr, {"__builtins__": {}}))
+            except Exception:
+                pass
+    return values
+
+
+def read_config():
+    cfg = read_defines("Services/Intensity/intensity_cfg.h",
+                       "Services/Profile/profile_cfg.h",
+                       "Services/HeaterBudget/heater_budget.h")
+    cfg["COMFORT_C"] = cfg["INTENSITY_LOW_FROM_C"]
+    cfg["STEPS"] = {}
+    for level in LEVELS:
+        steps = []
+        for seconds, intensity in STEP_RE.findall(cfg["PROFILE_STEPS_" + level]):
+            if intensity == "PROFILE_BANDS":
+                break
+            steps.append((int(seconds), INTENSITIES.index(intensity)))
+        cfg["STEPS"][level] = steps
+    cfg["DEMAND"] = [0, cfg["HEATER_BUDGET_LOW_SLOTS"], cfg["HEATER_BUDGET_MEDIUM_SLOTS"],
+                     cfg["HEATER_BUDGET_HIGH_SLOTS"], 0]
+    return cfg
+
+
+def select(cfg, desired, tenths):
+    """Intensity_Select() on a reading in 0.1 C"""
+    if tenths < cfg["INTENSITY_SENSOR_MIN_C"] * 10 or tenths > cfg["INTENSITY_SENSOR_MAX_C"] * 10:
+        return ERROR
+    error = math.floor((desired * 10 - tenths) / 10)
+    if error >= cfg["INTENSITY_HIGH_FROM_C"]:
+        return HIGH
+    if error >= cfg["INTENSITY_MEDIUM_FROM_C"]:
+        return MEDIUM
+    if error >= cfg["INTENSITY_LOW_FROM_C"]:
+        return LOW
+    return OFF
+
+
+class Seat:
+    """Intensity_Update() and Profile_Evaluate() of one seat"""
+
+    def __init__(self, cfg, level, ambient, use_profile):
+        self.cfg = cfg
+        self.desired = LEVELS[level]
+        self.steps = cfg["STEPS"][level] if use_profile else []
+        self.temp = ambient
+        self.state = OFF
+        self.entered = -1e9
+        self.step = 0
+        self.step_start = 0.0
+        self.comfort_at = None
+        self.peak = ambient
+
+    def decide(self, now):
+        cfg = self.cfg
+        tenths = math.floor(self.temp * 10)
+        raw = select(cfg, self.desired, tenths)
+        nxt = raw
+        if raw < self.state and self.state != ERROR:
+            shifted = max(tenths - cfg["INTENSITY_HYSTERESIS_TENTHS"], cfg["INTENSITY_SENSOR_MIN_C"] * 10)
+            nxt = select(cfg, self.desired, shifted)
+        if nxt != self.state and nxt != ERROR and now - self.entered < cfg["INTENSITY_MIN_DWELL_MS"] / 1000.0:
+            nxt = self.state
+        if nxt != self.state:
+            self.state = nxt
+            self.entered = now
+        bands = self.state
+
+        error = self.desired * 10 - tenths
+        if self.comfort_at is None and error < cfg["COMFORT_C"] * 10:
+            self.comfort_at = now
+        if bands == ERROR:
+            self.step = len(self.steps)
+            return ERROR
+        while self.step < len(self.steps):
+            if error < cfg["PROFILE_EXIT_C"] * 10:
+                self.step = len(self.steps)
+                break
+            seconds, intensity = self.steps[self.step]
+            if now - self.step_start < seconds:
+                return intensity
+            self.step_start += seconds
+            self.step += 1
+        return bands
+
+
+def arbitrate(cfg, demands, policy):
+    """prvArbitrate() of the power budget"""
+    remaining = cfg["HEATER_BUDGET_LIMIT_SLOTS"]
+    granted = [0] * len(demands)
+    if policy == "driver":
+        for seat, demand in enumerate(demands):
+            granted[seat] = min(demand, remaining)
+            remaining -= granted[seat]
+        return granted
+    open_seats = sum(1 for demand in demands if demand > 0)
+    while open_seats > 0:
+        share = remaining // open_seats
+        if share == 0:
+            break
+        for seat, demand in enumerate(demands):
+            if granted[seat] < demand:
+                give = min(demand - granted[seat], share)
+                granted[seat] += give
+                remaining -= give
+                if granted[seat] == demand:
+                    open_seats -= 1
+    for seat, demand in enumerate(demands):
+        if remaining > 0 and granted[seat] < demand:
+            granted[seat] += 1
+            remaining -= 1
+    return granted
+
+
+def simulate(cfg, args, level, seats, use_profile, trace=False):
+    heaters = [Seat(cfg, level, args.ambient, use_profile) for _ in range(seats)]
+    slots = cfg["HEATER_BUDGET_SLOTS"]
+    energy = 0.0
+    steps = int(args.duration / CONTROLLER_PERIOD_S)
+    for k in range(steps):
+        now = k * CONTROLLER_PERIOD_S
+        intensities = [seat.decide(now) for seat in heaters]
+        granted = arbitrate(cfg, [cfg["DEMAND"][i] for i in intensities], args.policy)
+        for seat, grant in zip(heaters, granted):
+            duty = grant / slots
+            energy += duty * CONTROLLER_PERIOD_S
+            seat.temp += (args.rise * duty - (seat.temp - args.ambient)) * CONTROLLER_PERIOD_S / args.tau
+            seat.peak = max(seat.peak, seat.temp)
+        if trace and k % int(5 / CONTROLLER_PERIOD_S) == 0:
+            print("%7.1f s  %s" % (now, "  ".join("%5.1f C %-15s %2d slots" % (s.temp, INTENSITIES[i], g)
+                                                  for s, i, g in zip(heaters, intensities, granted))))
+    return heaters, energy
+
+
+def describe(heaters, energy):
+    times = [seat.comfort_at for seat in heaters]
+    shown = "  ".join("never" if t is None else "%5.0f s" % t for t in times)
+    return "%-16s peak %5.1f C  %6.0f full-power s" % (shown, max(seat.peak for seat in heaters), energy)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Seat heater thermal simulation")
+    parser.add_argument("--ambient", type=float, default=10.0, help="ambient temperature, C")
+    parser.add_argument("--rise", type=float, default=60.0, help="rise above ambient at full power, C")
+    parser.add_argument("--tau", type=float, default=300.0, help="thermal time constant, s")
+    parser.add_argument("--policy", choices=["fair", "driver"], default="fair", help="power budget policy")
+    parser.add_argument("--duration", type=float, default=1200.0, help="simulated time, s")
+    parser.add_argument("--trace", choices=sorted(LEVELS), help="print one seat every 5 s at this level")
+    args = parser.parse_args()
+
+    cfg = read_config()
+    if args.trace:
+        simulate(cfg, args, args.trace, 1, True, trace=True)
+        return 0
+
+    print("Ambient %.1f C, full power +%.1f C, tau %.0f s, comfort within %d C, %s budget of %d slots"
+          % (args.ambient, args.rise, args.tau, cfg["COMFORT_C"], args.policy, cfg["HEATER_BUDGET_LIMIT_SLOTS"]))
+    for level in LEVELS:
+        for seats in (1, 2):
+            for use_profile in (False, True):
+                heaters, energy = simulate(cfg, args, level, seats, use_profile)
+                print("%-6s %-11s %-8s %s" % (level, "one seat" if seats == 1 else "both seats",
+                                              "profile" if use_profile else "bands", describe(heaters, energy)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -12,16 +12,68 @@
 #include "GPTM.h"
 #include "tm4c123gh6pm_registers.h"
 
+/***************** Services includes. *****************/
+#include "task_monitor.h"
+#include "release_planner.h"
+#include "power.h"
+#include "clock.h"
+#include "sampling.h"
+#include "telemetry.h"
+#include "log.h"
+#include "console.h"
+#include "uart_gatekeeper.h"
+#include "display.h"
+#include "dashboard.h"
+#include "spsc_ring.h"
+#include "temperature.h"
+#include "heap.h"
+#include "stack_profile.h"
+#include "intensity.h"
+#include "context_switch.h"
+#include "heater_budget.h"
+#include "profile.h"
+#include "store.h"
+#include "dtc.h"
+
 /***************** Definitions *******************/
-#define MAXVOLTAGEADC 3.3f  //ADC
-#define MAXTEMPERATURE 45  //ADC
+#define MAXVOLTAGEADC_TENTHS 33U  //ADC, the count is scaled by 45 / 3.3
 #define ISDRIVER 0
 #define ISPASSENGER 1
-#define NUMBER_OF_ITERATIONS_PER_ONE_MILI_SECOND 369  //DELAY
 #define mainSW1_INTERRUPT_BIT ( 1UL << 0UL )
 #define mainSW2_INTERRUPT_BIT ( 1UL << 1UL )
+#define BUTTON_EVENTS_SIZE (8U) /* Seat button presses waiting for the setting task, power of two */
 #define RUNTIME_MEASUREMENTS_TASK_PERIODICITY (1000U)
 
+/* Periodic tasks release periods and relative deadlines */
+#define TEMP_READING_TASK_PERIOD_MS (200UL)
+#define TEMP_READING_TASK_DEADLINE_MS (200UL)
+#define HEATER_CONTROLLER_TASK_PERIOD_MS (200UL)
+#define HEATER_CONTROLLER_TASK_DEADLINE_MS (200UL)
+
+/* The terminal dashboard is drawn at this period (DISPLAY_FORMAT_DASHBOARD) */
+#define DASHBOARD_TASK_PERIOD_MS (500UL)
+
+/* Execution time per release in 0.1 ms, used to spread the release phases.
+ * The UART0 interrupt sends the bytes, so a 13-byte telemetry frame (14 ms
+ * on the 9600 baud line) and the ~200 bytes of log frames of the runtime
+ * report only cost their encoding and the copy into the TX buffer. The
+ * display figure is the keyframe case, most releases only compare the state
+ * with the shown one. */
+#define TEMP_READING_TASK_LOAD (10U)
+#define HEATER_CONTROLLER_TASK_LOAD (10U)
+#define HEATER_LEDS_TASK_LOAD (5U)
+#define DISPLAY_TASK_LOAD (10U)
+#define RUNTIME_MEASUREMENTS_TASK_LOAD (10U)
+#define LOGGER_TASK_LOAD (10U)
+
+/* LOG_TASK_LATENESS carries the eight bins of the lateness histogram */
+#if (TASK_MONITOR_HISTOGRAM_BINS != 8U)
+#error "Update LOG_TASK_LATENESS in log_messages.h and its call in the runtime task"
+#endif
+
+/* Set to 0 to release all periodic tasks together (no phase offsets) */
+#define RELEASE_PHASES_ENABLE (1U)
+
 /***************** FreeRTOS tasks *****************/
 void vTempSettingTask(void *pvParameters);
 void vTempReadingTask(void *pvParameters); //Sensor Task
@@ -29,6 +81,13 @@ void vHeaterControllerTask(void *pvParameters);
 void vHeaterLedsControllerTask(void *pvParameters);
 void vDisplayTask(void *pvParameters);
 void vRunTimeMeasurementsTask(void *pvParameters);
+void vLoggerTask(void *pvParameters);
+void vConsoleTask(void *pvParameters);
+void vUartGatekeeperTask(void *pvParameters);
+void vStoreTask(void *pvParameters);
+#if (DISPLAY_FORMAT == DISPLAY_FORMAT_DASHBOARD)
+void vDashboardTask(void *pvParameters);
+#endif
 
 /***************** Task Handles *****************/
 TaskHandle_t vTemperatureSetTaskDrivertHandle;
@@ -42,6 +101,11 @@ TaskHandle_t vHeaterLedsControllerTaskPassengerHandle;
 TaskHandle_t vDisplayTaskDriverHandle;
 TaskHandle_t vDisplayTaskPassengerHandle;
 TaskHandle_t vRunTimeMeasurementsTaskHandle;
+TaskHandle_t vLoggerTaskHandle;
+TaskHandle_t vConsoleTaskHandle;
+TaskHandle_t vUartGatekeeperTaskHandle;
+TaskHandle_t vStoreTaskHandle;
+TaskHandle_t vDashboardTaskHandle;
 
 /*************************** Variables ***************************/
 /* General Variables */
@@ -49,8 +113,8 @@ uint8 DriverState = 0;
 uint8 PassengerState = 0;
 UserHeatInput DesiredTempDriver; /* Carries Desired Value entered by user */
 UserHeatInput DesiredTempPassenger;
-float32 CurrentTempDriver; /* Carries Value generated by ADC */
-float32 CurrentTempPassenger;
+Temperature CurrentTempDriver; /* Carries Value generated by ADC */
+Temperature CurrentTempPassenger;
 HeatIntensity heatIntensity;
 
 /* Semaphores & Mutexes */
@@ -58,7 +122,7 @@ xSemaphoreHandle CurrentTempMutexDriver;
 xSemaphoreHandle CurrentTempMutexPassenger;
 xSemaphoreHandle DesiredTempMutexDriver;
 xSemaphoreHandle DesiredTempMutexPassenger;
-xSemaphoreHandle UARTMutex;
+xSemaphoreHandle AdcMutex; /* Both reading tasks pop the ADC0 sample ring, one at a time */
 
 /* Queues */
 QueueHandle_t Reading_DisplayDriver;
@@ -71,10 +135,37 @@ QueueHandle_t Controller_DisplayPassenger;
 /* Events */
 EventGroupHandle_t eventTempSet;
 
-/* Runtime measurements */
-uint32 ullTasksOutTime[13];
-uint32 ullTasksInTime[13];
-uint32 ullTasksExecutionTime[13];
+/* Button presses of each seat: the GPIO handlers are the producer (same
+ * priority, they never nest), the setting task of the seat the only consumer */
+uint8 ButtonEventsStorageDriver[BUTTON_EVENTS_SIZE];
+uint8 ButtonEventsStoragePassenger[BUTTON_EVENTS_SIZE];
+SpscRing xButtonEvents[2] = { SPSC_RING_INITIALIZER(ButtonEventsStorageDriver),
+                              SPSC_RING_INITIALIZER(ButtonEventsStoragePassenger) };
+
+/* Release and deadline monitors of the periodic tasks */
+TaskMonitor xTempReadingMonitor[2];
+TaskMonitor xHeaterControllerMonitor[2];
+TaskMonitor xRunTimeMeasurementsMonitor;
+
+/* Adaptive sampling rate of each seat temperature */
+SamplingPolicy xSamplingPolicy[2];
+
+/* Values shown by the display of each seat */
+DisplaySeat xDisplaySeat[2];
+
+/* Heater intensity state machine of each seat */
+IntensitySeat xIntensitySeat[2];
+
+/* Boost profile of each seat */
+ProfileSeat xProfileSeat[2];
+
+#if (DISPLAY_FORMAT == DISPLAY_FORMAT_DASHBOARD)
+/* Last state of each seat, drawn by the dashboard task */
+TelemetrySeatState xDashboardSeat[2];
+#endif
+
+/* CPU load of the last runtime measurements window */
+uint8 ucLastCpuLoad = 0;
 
 /* LockTime variables per task for each resource */
 TickType_t CurrentTempReadingTaskDriverLT = 0;
@@ -92,22 +183,108 @@ TickType_t DesiredTempControllerTaskPassengerLT = 0;
 TickType_t DesiredTempDisplayTaskDriverLT = 0;
 TickType_t DesiredTempDisplayTaskPassengerLT = 0;
 
-TickType_t UARTDisplayTaskDriverLT = 0;
-TickType_t UARTDisplayTaskPassengerLT = 0;
-
-TickType_t UARTRunTimeMeasurementsTaskLT = 0;
-TickType_t UARTOneTimeRunTimeMeasurementsTaskLT = 0;
+/***************** Task Table *****************/
+typedef struct
+{
+    TaskFunction_t pxTaskCode;
+    const char *pcName;
+    uint16 usStackDepth;        /* Words, from stack_sizes.h when STACK_PROFILE_APPLY is 1 */
+    uint32 ulSeat;              /* Passed to the task as pvParameters */
+    UBaseType_t uxPriority;
+    TaskHandle_t *pxHandle;
+    TaskMonitor *pxMonitor;     /* Periodic tasks only */
+    TickType_t xPeriod;         /* 0 for event driven tasks */
+    TickType_t xDeadline;
+    uint8 ucAfter;              /* Event driven: task whose job releases this one, periodic: task to follow */
+    uint16 usLoad;              /* Execution time per release in 0.1 ms */
+}TaskConfig;
+
+/* Index of each task in xTaskTable, ordered by priority. The task tag is the
+ * index + 1 and ucAfter names a task by its index. */
+typedef enum
+{
+    TASK_SET_TEMP_DRIVER,
+    TASK_SET_TEMP_PASSENGER,
+    TASK_READ_TEMP_DRIVER,
+    TASK_READ_TEMP_PASSENGER,
+    TASK_CONTROL_TEMP_DRIVER,
+    TASK_CONTROL_TEMP_PASSENGER,
+    TASK_CONTROL_LEDS_DRIVER,
+    TASK_CONTROL_LEDS_PASSENGER,
+    TASK_DISPLAY_DRIVER,
+    TASK_DISPLAY_PASSENGER,
+    TASK_UART_GATEKEEPER,
+    TASK_RUNTIME_MEASUREMENTS,
+    TASK_LOGGER,
+    TASK_CONSOLE,
+    TASK_STORE,
+#if (DISPLAY_FORMAT == DISPLAY_FORMAT_DASHBOARD)
+    TASK_DASHBOARD,
+#endif
+    TASKS_COUNT
+}TaskIndex;
+
+static const TaskConfig xTaskTable[TASKS_COUNT] = {
+    [TASK_SET_TEMP_DRIVER] = { vTempSettingTask, "SetTempForDriver", STACK_PROFILE_DEPTH(SetTempForDriver, 256), ISDRIVER, (configMAX_PRIORITIES - 1),
+      &vTemperatureSetTaskDrivertHandle, NULL, 0, 0, RELEASE_PLANNER_NO_TASK, 0 },
+    [TASK_SET_TEMP_PASSENGER] = { vTempSettingTask, "SetTempForPassenger", STACK_PROFILE_DEPTH(SetTempForPassenger, 256), ISPASSENGER, (configMAX_PRIORITIES - 1),
+      &vTemperatureSetTaskPassengertHandle, NULL, 0, 0, RELEASE_PLANNER_NO_TASK, 0 },
+    [TASK_READ_TEMP_DRIVER] = { vTempReadingTask, "ReadTempForDriver", STACK_PROFILE_DEPTH(ReadTempForDriver, 256), ISDRIVER, 3,
+      &vTemperatureReadTaskDriverHandle, &xTempReadingMonitor[ISDRIVER],
+      pdMS_TO_TICKS(TEMP_READING_TASK_PERIOD_MS), pdMS_TO_TICKS(TEMP_READING_TASK_DEADLINE_MS),
+      RELEASE_PLANNER_NO_TASK, TEMP_READING_TASK_LOAD },
+    [TASK_READ_TEMP_PASSENGER] = { vTempReadingTask, "ReadTempForPassenger", STACK_PROFILE_DEPTH(ReadTempForPassenger, 256), ISPASSENGER, 3,
+      &vTemperatureReadTaskPassengerHandle, &xTempReadingMonitor[ISPASSENGER],
+      pdMS_TO_TICKS(TEMP_READING_TASK_PERIOD_MS), pdMS_TO_TICKS(TEMP_READING_TASK_DEADLINE_MS),
+      RELEASE_PLANNER_NO_TASK, TEMP_READING_TASK_LOAD },
+    [TASK_CONTROL_TEMP_DRIVER] = { vHeaterControllerTask, "ControlTempForDriver", STACK_PROFILE_DEPTH(ControlTempForDriver, 256), ISDRIVER, 2,
+      &vHeaterControllerTaskDriverHandle, &xHeaterControllerMonitor[ISDRIVER],
+      pdMS_TO_TICKS(HEATER_CONTROLLER_TASK_PERIOD_MS), pdMS_TO_TICKS(HEATER_CONTROLLER_TASK_DEADLINE_MS),
+      TASK_READ_TEMP_DRIVER, HEATER_CONTROLLER_TASK_LOAD },
+    [TASK_CONTROL_TEMP_PASSENGER] = { vHeaterControllerTask, "ControlTempForPassenger", STACK_PROFILE_DEPTH(ControlTempForPassenger, 256), ISPASSENGER, 2,
+      &vHeaterControllerTaskPassengerHandle, &xHeaterControllerMonitor[ISPASSENGER],
+      pdMS_TO_TICKS(HEATER_CONTROLLER_TASK_PERIOD_MS), pdMS_TO_TICKS(HEATER_CONTROLLER_TASK_DEADLINE_MS),
+      TASK_READ_TEMP_PASSENGER, HEATER_CONTROLLER_TASK_LOAD },
+    [TASK_CONTROL_LEDS_DRIVER] = { vHeaterLedsControllerTask, "ControlLedsForDriver", STACK_PROFILE_DEPTH(ControlLedsForDriver, 256), ISDRIVER, 2,
+      &vHeaterLedsControllerTaskDriverHandle, NULL, 0, 0, TASK_CONTROL_TEMP_DRIVER, HEATER_LEDS_TASK_LOAD },
+    [TASK_CONTROL_LEDS_PASSENGER] = { vHeaterLedsControllerTask, "ControlLedsForPassenger", STACK_PROFILE_DEPTH(ControlLedsForPassenger, 256), ISPASSENGER, 2,
+      &vHeaterLedsControllerTaskPassengerHandle, NULL, 0, 0, TASK_CONTROL_TEMP_PASSENGER, HEATER_LEDS_TASK_LOAD },
+    [TASK_DISPLAY_DRIVER] = { vDisplayTask, "DisplayForDriver", STACK_PROFILE_DEPTH(DisplayForDriver, 256), ISDRIVER, 2,
+      &vDisplayTaskDriverHandle, NULL, 0, 0, TASK_READ_TEMP_DRIVER, DISPLAY_TASK_LOAD },
+    [TASK_DISPLAY_PASSENGER] = { vDisplayTask, "DisplayForPassenger", STACK_PROFILE_DEPTH(DisplayForPassenger, 256), ISPASSENGER, 2,
+      &vDisplayTaskPassengerHandle, NULL, 0, 0, TASK_READ_TEMP_PASSENGER, DISPLAY_TASK_LOAD },
+    /* The UART0 interrupt sends the bytes, so its jobs are short enough to
+     * run with the display tasks whose frames it sends */
+    [TASK_UART_GATEKEEPER] = { vUartGatekeeperTask, "UartGatekeeper", STACK_PROFILE_DEPTH(UartGatekeeper, 256), 0, 2,
+      &vUartGatekeeperTaskHandle, NULL, 0, 0, RELEASE_PLANNER_NO_TASK, 0 },
+    [TASK_RUNTIME_MEASUREMENTS] = { vRunTimeMeasurementsTask, "RunTimeMeasurements", STACK_PROFILE_DEPTH(RunTimeMeasurements, 256), 0, 1,
+      &vRunTimeMeasurementsTaskHandle, &xRunTimeMeasurementsMonitor,
+      RUNTIME_MEASUREMENTS_TASK_PERIODICITY, RUNTIME_MEASUREMENTS_TASK_PERIODICITY,
+      RELEASE_PLANNER_NO_TASK, RUNTIME_MEASUREMENTS_TASK_LOAD },
+    [TASK_LOGGER] = { vLoggerTask, "Logger", STACK_PROFILE_DEPTH(Logger, 256), 0, 1,
+      &vLoggerTaskHandle, NULL, 0, 0, TASK_RUNTIME_MEASUREMENTS, LOGGER_TASK_LOAD },
+    [TASK_CONSOLE] = { vConsoleTask, "Console", STACK_PROFILE_DEPTH(Console, 256), 0, 1,
+      &vConsoleTaskHandle, NULL, 0, 0, RELEASE_PLANNER_NO_TASK, 0 },
+    [TASK_STORE] = { vStoreTask, "Store", STACK_PROFILE_DEPTH(Store, 256), 0, 1,
+      &vStoreTaskHandle, NULL, 0, 0, RELEASE_PLANNER_NO_TASK, 0 },
+#if (DISPLAY_FORMAT == DISPLAY_FORMAT_DASHBOARD)
+    [TASK_DASHBOARD] = { vDashboardTask, "Dashboard", STACK_PROFILE_DEPTH(Dashboard, 256), 0, 1,
+      &vDashboardTaskHandle, NULL, 0, 0, RELEASE_PLANNER_NO_TASK, 0 },
+#endif
+};
 
 /***************** The HW setup function *****************/
 static void prvSetupHardware(void)
 {
     /* Place here any needed HW initialization such as GPIO, UART, etc.  */
+    Clock_Init(); /* First: the drivers are timed from the system clock */
     GPIO_BuiltinButtonsLedsInit();
     GPIO_SW1EdgeTriggeredInterruptInit();
     GPIO_SW2EdgeTriggeredInterruptInit();
     GPIO_SW3EdgeTriggeredInterruptInit();
-    GPTM_WTimer0Init();
-    UART0_Init();
+    GPTM_WTimer0Init(Clock_GetFrequency());
+    Power_Init();
+    UART0_Init(Clock_GetFrequency());
     ADC_Init();
 }
 
@@ -115,13 +292,858 @@ static void prvSetupHardware(void)
 void Delay_MS(unsigned long long n)
 {
     volatile unsigned long long count = 0;
-    while (count++ < (NUMBER_OF_ITERATIONS_PER_ONE_MILI_SECOND * n))
+    while (count++ < (Clock_GetDelayIterationsPerMs() * n))
         ;
 }
 
+/* Log the runtime report: CPU load, timing of the periodic tasks, sleep and sampling statistics */
+static void prvLogRuntimeReport(uint8 ucCPU_Load)
+{
+    uint8 ucCounter, ucMode;
+    uint8 ucDtcIds[DTC_COUNT];
+    const TaskMonitor *pxMonitor;
+    SamplingUtilization xUtilization;
+    const PowerStats *pxPower = Power_GetStats();
+    const DtcStats *pxDtc = Dtc_GetStats();
+
+    LOG(LOG_CPU_LOAD, ucCPU_Load, Clock_GetFrequency() / 1000000UL, Clock_GetSwitches());
+
+    /* Release lateness, response time and deadline misses per periodic task (times in ms) */
+    for (ucCounter = 0; ucCounter < TaskMonitor_GetCount(); ucCounter++)
+    {
+        pxMonitor = TaskMonitor_Get(ucCounter);
+        LOG(LOG_TASK_TIMING, ucCounter, pxMonitor->xPhase * (1000U / configTICK_RATE_HZ),
+            pxMonitor->ulReleases, pxMonitor->ulDeadlineMisses,
+            pxMonitor->ulReleases ? pxMonitor->ulMinLateness : 0,
+            pxMonitor->ulMaxLateness, pxMonitor->ulMaxResponse);
+        LOG(LOG_TASK_LATENESS, ucCounter,
+            pxMonitor->ulHistogram[0], pxMonitor->ulHistogram[1], pxMonitor->ulHistogram[2],
+            pxMonitor->ulHistogram[3], pxMonitor->ulHistogram[4], pxMonitor->ulHistogram[5],
+            pxMonitor->ulHistogram[6], pxMonitor->ulHistogram[7]);
+    }
+
+    /* Tickless idle: ticks slept through and wake-up latency of WTimer1 */
+    LOG(LOG_SLEEP_STATS, pxPower->ulSleeps, pxPower->ulSuppressedTicks,
+        pxPower->ulTimerWakeups, pxPower->ulEarlyWakeups, pxPower->ulAborted,
+        pxPower->ulMaxWakeLatency,
+        pxPower->ulTimerWakeups ? (pxPower->ulTotalWakeLatency / pxPower->ulTimerWakeups) : 0);
+
+    /* Deep sleep with all seats OFF: button wake-up to first heater output (in ms) */
+    LOG(LOG_DEEP_SLEEP_STATS, pxPower->ulDeepSleeps, pxPower->ulWakeToOutput,
+        pxPower->ulMaxWakeToOutput);
+
+    /* Sampling rate per seat: time spent in each mode and what it used */
+    for (ucCounter = ISDRIVER; ucCounter <= ISPASSENGER; ucCounter++)
+    {
+        for (ucMode = SAMPLING_FAST; ucMode < SAMPLING_MODES; ucMode++)
+        {
+            Sampling_GetUtilization(&xSamplingPolicy[ucCounter], (SamplingMode) ucMode,
+                                    TEMP_READING_TASK_PERIOD_MS, UART0_BAUD_RATE, &xUtilization);
+            LOG(LOG_SAMPLING_STATS, ucCounter, ucMode, xUtilization.ulTimeMs / 1000U,
+                xUtilization.ucCpuLoad, xUtilization.ulAdcRate, xUtilization.ucUartLoad);
+        }
+    }
+
+    /* Display updates per seat: what was sent and what the change tracking saved */
+    for (ucCounter = ISDRIVER; ucCounter <= ISPASSENGER; ucCounter++)
+    {
+        LOG(LOG_DISPLAY_STATS, ucCounter, xDisplaySeat[ucCounter].ulKeyframes,
+            xDisplaySeat[ucCounter].ulUpdates, xDisplaySeat[ucCounter].ulUnchanged,
+            xDisplaySeat[ucCounter].ulDeferred);
+    }
+
+    /* Intensity changes per seat against the ones the bands alone would have made, boost profiles */
+    for (ucCounter = ISDRIVER; ucCounter <= ISPASSENGER; ucCounter++)
+    {
+        LOG(LOG_INTENSITY_STATS, ucCounter, xIntensitySeat[ucCounter].ulTransitions,
+            xIntensitySeat[ucCounter].usTransitionsPerMinute, xIntensitySeat[ucCounter].ulRawTransitions,
+            xIntensitySeat[ucCounter].usRawTransitionsPerMinute, xIntensitySeat[ucCounter].ulHeldBack);
+        LOG(LOG_PROFILE_STATS, ucCounter, xProfileSeat[ucCounter].ulBoosts, xProfileSeat[ucCounter].ulEarlyExits,
+            xProfileSeat[ucCounter].ulTimeToComfort / 100U);
+    }
+
+    /* Diagnostic trouble codes and the worst sensor evaluation time */
+    LOG(LOG_DTC_STATS, Dtc_Find(DTC_STATUS_CONFIRMED, ucDtcIds), pxDtc->ulConfirmed,
+        pxDtc->ulAged, pxDtc->ulReports, pxDtc->ulMaxCycles);
+}
+
+/* Show the state of a seat, only what changed since the last update is sent.
+ * Returns the bytes handed to the UART gatekeeper. */
+static uint8 prvDisplaySeat(uint8 SeatSelect, Temperature xCurrentTemp,
+                            UserHeatInput eHeatLevel, HeatIntensity eHeatState)
+{
+    TelemetrySeatState xState;
+
+    xState.ucSeat = SeatSelect;
+    xState.sTemperature = TEMPERATURE_TO_TENTHS(xCurrentTemp);
+    xState.ucDesired = (uint8) eHeatLevel;
+    xState.ucIntensity = (uint8) eHeatState;
+    xState.ucFlags = (xSamplingPolicy[SeatSelect].eMode == SAMPLING_SLOW) ?
+                     TELEMETRY_FLAG_SLOW_SAMPLING : 0;
+
+#if (DISPLAY_FORMAT == DISPLAY_FORMAT_DASHBOARD)
+    /* Drawn by the dashboard task at its own period */
+    taskENTER_CRITICAL();
+    xDashboardSeat[SeatSelect] = xState;
+    taskEXIT_CRITICAL();
+    return 0;
+#else
+    return Display_Update(&xDisplaySeat[SeatSelect], &xState);
+#endif
+}
+
+/* Heater output of a seat, called by the power budget at the slot edges. The
+ * LEDs stand for the heater: the intensity color while it is on in its slots,
+ * red for a sensor fault. */
+static void prvDriveHeater(uint8 ucSeat, HeatIntensity eIntensity, boolean bOn)
+{
+    if ((bOn == FALSE) && (eIntensity != ERROR))
+    {
+        eIntensity = INTENSITYOFF;
+    }
+
+    if (ucSeat == ISDRIVER)
+    {
+        switch (eIntensity)
+        {
+        case ERROR:
+            GPIO_RedLed1On();
+            GPIO_BlueLed1Off();
+            GPIO_GreenLed1Off();
+            break;
+
+        case INTENSITYOFF:
+            GPIO_RedLed1Off();
+            GPIO_BlueLed1Off();
+            GPIO_GreenLed1Off();
+            break;
+
+        case LOWINTENSITY:
+            GPIO_RedLed1Off();
+            GPIO_BlueLed1Off();
+            GPIO_GreenLed1On();
+            break;
+
+        case MEDIUMINTENSITY:
+            GPIO_RedLed1Off();
+            GPIO_BlueLed1On();
+            GPIO_GreenLed1Off();
+            break;
+
+        case HIGHINTENSITY:
+            GPIO_RedLed1Off();
+            GPIO_BlueLed1On();
+            GPIO_GreenLed1On();
+            break;
+        }
+    }
+    else
+    {
+        switch (eIntensity)
+        {
+        case ERROR:
+            GPIO_RedLed2On();
+            GPIO_BlueLed2Off();
+            GPIO_GreenLed2Off();
+            break;
+
+        case INTENSITYOFF:
+            GPIO_RedLed2Off();
+            GPIO_BlueLed2Off();
+            GPIO_GreenLed2Off();
+            break;
+
+        case LOWINTENSITY:
+            GPIO_RedLed2Off();
+            GPIO_BlueLed2Off();
+            GPIO_GreenLed2On();
+            break;
+
+        case MEDIUMINTENSITY:
+            GPIO_RedLed2Off();
+            GPIO_BlueLed2On();
+            GPIO_GreenLed2Off();
+            break;
+
+        case HIGHINTENSITY:
+            GPIO_RedLed2Off();
+            GPIO_BlueLed2On();
+            GPIO_GreenLed2On();
+            break;
+        }
+    }
+}
+
+/* Run by the UART gatekeeper between two messages, so no byte is cut in half */
+static void prvUpdateClock(uint32 ulLoad)
+{
+    Clock_UpdateLoad((uint8) ulLoad);
+}
+
+/* Freeze frame of a qualified fault, called from the reading task of the
+ * seat. The values are single words read without the mutexes. */
+static void prvReadDtcSnapshot(DtcSnapshot *pxSnapshot)
+{
+    pxSnapshot->sTemperature[ISDRIVER] = TEMPERATURE_TO_TENTHS(CurrentTempDriver);
+    pxSnapshot->sTemperature[ISPASSENGER] = TEMPERATURE_TO_TENTHS(CurrentTempPassenger);
+    pxSnapshot->ucLevel[ISDRIVER] = DriverState;
+    pxSnapshot->ucLevel[ISPASSENGER] = PassengerState;
+}
+
+/* Seat levels and power policy for the next boot, written later by the store task */
+static void prvSaveSettings(void)
+{
+    StoreSettings xSettings;
+
+    xSettings.ucDriverLevel = DriverState;
+    xSettings.ucPassengerLevel = PassengerState;
+    xSettings.ucBudgetPolicy = (uint8) HeaterBudget_GetPolicy();
+    Store_SetSettings(&xSettings);
+}
+
+#if (DISPLAY_FORMAT == DISPLAY_FORMAT_DASHBOARD)
+/* Fixed text of the dashboard, drawn once */
+static void prvDrawDashboardLabels(void)
+{
+    static const struct
+    {
+        uint8 ucRow;
+        uint8 ucCol;
+        const char *pcText;
+    } xLabels[] = {
+        { 0, 0, "Seat Heater Control" }, { 0, 46, "uptime" }, { 0, 62, "s" },
+        { 2, 0, "Seat" }, { 2, 10, "Temp C" }, { 2, 20, "Target C" }, { 2, 30, "Heater" }, { 2, 38, "Sampling" },
+        { 3, 0, "Driver" }, { 4, 0, "Passenger" },
+        { 6, 0, "CPU" }, { 6, 8, "%" }, { 6, 12, "Clock" }, { 6, 22, "MHz" },
+        { 6, 28, "Switches" }, { 6, 46, "Deep sleeps" },
+        { 7, 0, "Deadline misses" }, { 7, 24, "Max lateness" }, { 7, 44, "ms" }, { 7, 46, "Log dropped" },
+        { 8, 0, "UART msgs" }, { 8, 18, "bytes" }, { 8, 34, "coalesced" }, { 8, 52, "wait" }, { 8, 62, "ms" },
+        { 9, 0, "Refresh bytes last" }, { 9, 25, "max" }, { 9, 35, "total" },
+    };
+    uint8 ucIndex;
+
+    for (ucIndex = 0; ucIndex < (sizeof(xLabels) / sizeof(xLabels[0])); ucIndex++)
+    {
+        Dashboard_PutText(xLabels[ucIndex].ucRow, xLabels[ucIndex].ucCol, xLabels[ucIndex].pcText, DASHBOARD_COLS);
+    }
+    for (ucIndex = 0; ucIndex < DASHBOARD_COLS; ucIndex++)
+    {
+        Dashboard_PutText(1, ucIndex, "-", 1);
+        Dashboard_PutText(5, ucIndex, "-", 1);
+    }
+}
+
+/* Values of the dashboard, only the cells that changed reach the terminal */
+static void prvDrawDashboard(void)
+{
+    static const char *const pcIntensities[] = { "off", "low", "medium", "high", "error" };
+    const PowerStats *pxPower = Power_GetStats();
+    const UartGatekeeperStats *pxUart = UartGatekeeper_GetStats();
+    const DashboardStats *pxDashboard = Dashboard_GetStats();
+    const TaskMonitor *pxMonitor;
+    TelemetrySeatState xState;
+    uint32 ulMisses = 0, ulMaxLateness = 0;
+    uint8 ucIndex;
+
+    Dashboard_PutUnsigned(0, 53, xTaskGetTickCount() / configTICK_RATE_HZ, 8);
+
+    for (ucIndex = 0; ucIndex < 2; ucIndex++)
+    {
+        taskENTER_CRITICAL();
+        xState = xDashboardSeat[ucIndex];
+        taskEXIT_CRITICAL();
+
+        Dashboard_PutFixed(3 + ucIndex, 10, xState.sTemperature, 1, 6);
+        if (xState.ucDesired == OFF)
+        {
+            Dashboard_PutText(3 + ucIndex, 20, "off", 8);
+        }
+        else
+        {
+            Dashboard_PutUnsigned(3 + ucIndex, 20, xState.ucDesired, 3);
+            Dashboard_PutText(3 + ucIndex, 23, "", 5);
+        }
+        Dashboard_PutText(3 + ucIndex, 30, (xState.ucIntensity <= ERROR) ? pcIntensities[xState.ucIntensity] : "?", 8);
+        Dashboard_PutText(3 + ucIndex, 38, (xState.ucFlags & TELEMETRY_FLAG_SLOW_SAMPLING) ? "slow" : "fast", 8);
+    }
+
+    for (ucIndex = 0; ucIndex < TaskMonitor_GetCount(); ucIndex++)
+    {
+        pxMonitor = TaskMonitor_Get(ucIndex);
+        ulMisses += pxMonitor->ulDeadlineMisses;
+        if (pxMonitor->ulMaxLateness > ulMaxLateness)
+        {
+            ulMaxLateness = pxMonitor->ulMaxLateness;
+        }
+    }
+
+    Dashboard_PutUnsigned(6, 4, ucLastCpuLoad, 3);
+    Dashboard_PutUnsigned(6, 18, Clock_GetFrequency() / 1000000UL, 3);
+    Dashboard_PutUnsigned(6, 37, Clock_GetSwitches(), 6);
+    Dashboard_PutUnsigned(6, 58, pxPower->ulDeepSleeps, 6);
+    Dashboard_PutUnsigned(7, 16, ulMisses, 6);
+    Dashboard_PutFixed(7, 37, (sint32) ulMaxLateness, 1, 6);
+    Dashboard_PutUnsigned(7, 58, Log_GetDropped(), 6);
+    Dashboard_PutUnsigned(8, 10, pxUart->ulMessages, 6);
+    Dashboard_PutUnsigned(8, 24, pxUart->ulBytes, 8);
+    Dashboard_PutUnsigned(8, 44, pxUart->ulCoalesced, 6);
+    Dashboard_PutFixed(8, 57, (sint32) pxUart->ulMaxWait, 1, 5);
+    Dashboard_PutUnsigned(9, 19, pxDashboard->ulLastBytes, 5);
+    Dashboard_PutUnsigned(9, 29, pxDashboard->ulMaxBytes, 5);
+    Dashboard_PutUnsigned(9, 41, pxDashboard->ulTotalBytes, 9);
+}
+#endif
+
+/* Give every periodic task a release phase so the co-periodic seat tasks do
+ * not all wake on the same tick, then arm their monitors. The work of event
+ * driven tasks is charged to the task whose job releases them. */
+static void prvPlanReleases(void)
+{
+    ReleasePlannerTask xPlan[TASKS_COUNT];
+    TickType_t xPhases[TASKS_COUNT];
+    uint8 ucIndex;
+
+    for (ucIndex = 0; ucIndex < TASKS_COUNT; ucIndex++)
+    {
+        xPlan[ucIndex].xPeriod = xTaskTable[ucIndex].xPeriod;
+        xPlan[ucIndex].ulLoad = xTaskTable[ucIndex].usLoad;
+        xPlan[ucIndex].ucAfter = xTaskTable[ucIndex].ucAfter;
+    }
+    for (ucIndex = 0; ucIndex < TASKS_COUNT; ucIndex++)
+    {
+        if ((xTaskTable[ucIndex].xPeriod == 0) && (xTaskTable[ucIndex].ucAfter < TASKS_COUNT))
+        {
+            xPlan[xTaskTable[ucIndex].ucAfter].ulLoad += xTaskTable[ucIndex].usLoad;
+        }
+    }
+
+    ReleasePlanner_ComputePhases(xPlan, TASKS_COUNT, xPhases);
+
+    for (ucIndex = 0; ucIndex < TASKS_COUNT; ucIndex++)
+    {
+        if (xTaskTable[ucIndex].pxMonitor != NULL)
+        {
+            TaskMonitor_Init(xTaskTable[ucIndex].pxMonitor, xTaskTable[ucIndex].pcName,
+                             xTaskTable[ucIndex].xPeriod, xTaskTable[ucIndex].xDeadline,
+                             (RELEASE_PHASES_ENABLE ? xPhases[ucIndex] : 0));
+        }
+    }
+}
+
+/*------------------------- Console Commands ---------------------------*/
+static const char *const pcSeatNames[] = { "driver", "passenger" };
+static const char *const pcLevelNames[] = { "off", "low", "medium", "high" };
+
+/* Same path as the seat buttons: set the button state and let the setting task apply it */
+static void prvCommandLevel(uint8 ucArgc, char *pcArgv[])
+{
+    uint8 ucSeat, ucLevel;
+
+    ucSeat = (ucArgc == 3) ? Console_ParseChoice(pcArgv[1], pcSeatNames, 2) : 2;
+    ucLevel = (ucArgc == 3) ? Console_ParseChoice(pcArgv[2], pcLevelNames, 4) : 4;
+    if ((ucSeat >= 2) || (ucLevel >= 4))
+    {
+        Console_Append("usage: level driver|passenger off|low|medium|high");
+        Console_Flush();
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    if (ucSeat == ISDRIVER)
+    {
+        DriverState = ucLevel;
+    }
+    else
+    {
+        PassengerState = ucLevel;
+    }
+    taskEXIT_CRITICAL();
+    xEventGroupSetBits(eventTempSet, (ucSeat == ISDRIVER) ? mainSW1_INTERRUPT_BIT : mainSW2_INTERRUPT_BIT);
+
+    Console_Append(pcSeatNames[ucSeat]);
+    Console_Append(" set to ");
+    Console_Append(pcLevelNames[ucLevel]);
+    Console_Flush();
+}
+
+/* The report goes out through the logger like the periodic one */
+static void prvCommandStats(uint8 ucArgc, char *pcArgv[])
+{
+    (void) ucArgc;
+    (void) pcArgv;
+
+    prvLogRuntimeReport(ucLastCpuLoad);
+}
+
+/* Accumulated mutex lock times of every task, the UART output, the heap and the lost console and log data */
+static void prvCommandTrace(uint8 ucArgc, char *pcArgv[])
+{
+    const UartGatekeeperStats *pxUart = UartGatekeeper_GetStats();
+    const Pool *pxUartPool = UartGatekeeper_GetPool();
+#if (configHEAP_COALESCING == 1)
+    const HeapLatency *pxHeapLatency = Heap_GetLatency();
+    HeapStats_t xHeapStats;
+#endif
+    static const struct
+    {
+        const char *pcName;
+        const TickType_t *pxLockTime;
+    } xLockTimes[] = {
+        { "ReadTempForDriver CurrentTemp", &CurrentTempReadingTaskDriverLT },
+        { "ReadTempForPassenger CurrentTemp", &CurrentTempReadingTaskPassengerLT },
+        { "SetTempForDriver DesiredTemp", &DesiredTempSettingTaskDriverLT },
+        { "SetTempForPassenger DesiredTemp", &DesiredTempSettingTaskPassengerLT },
+        { "ControlTempForDriver CurrentTemp", &CurrentTempControllerTaskDriverLT },
+        { "ControlTempForPassenger CurrentTemp", &CurrentTempControllerTaskPassengerLT },
+        { "ControlTempForDriver DesiredTemp", &DesiredTempControllerTaskDriverLT },
+        { "ControlTempForPassenger DesiredTemp", &DesiredTempControllerTaskPassengerLT },
+        { "DisplayForDriver DesiredTemp", &DesiredTempDisplayTaskDriverLT },
+        { "DisplayForPassenger DesiredTemp", &DesiredTempDisplayTaskPassengerLT },
+    };
+    uint8 ucIndex;
+
+    (void) ucArgc;
+    (void) pcArgv;
+
+    for (ucIndex = 0; ucIndex < (sizeof(xLockTimes) / sizeof(xLockTimes[0])); ucIndex++)
+    {
+        Console_Append(xLockTimes[ucIndex].pcName);
+        Console_Append(" lock ");
+        Console_AppendUnsigned(*xLockTimes[ucIndex].pxLockTime * (1000U / configTICK_RATE_HZ));
+        Console_Append(" ms");
+        Console_Flush();
+    }
+
+    Console_Append("UART messages ");
+    Console_AppendUnsigned(pxUart->ulMessages);
+    Console_Append(" bytes ");
+    Console_AppendUnsigned(pxUart->ulBytes);
+    Console_Append(" coalesced ");
+    Console_AppendUnsigned(pxUart->ulCoalesced);
+    Console_Append(" max wait ");
+    Console_AppendFixed((sint32) pxUart->ulMaxWait, 1);
+    Console_Append(" ms");
+    Console_Flush();
+
+    Console_Append("UART pool used ");
+    Console_AppendUnsigned(pxUartPool->usUsed);
+    Console_Append(" high ");
+    Console_AppendUnsigned(pxUartPool->usHighWater);
+    Console_Append(" of ");
+    Console_AppendUnsigned(pxUartPool->usBlocks);
+    Console_Append(" failed ");
+    Console_AppendUnsigned(pxUartPool->ulFailures);
+    Console_Flush();
+
+#if (DISPLAY_FORMAT == DISPLAY_FORMAT_DASHBOARD)
+    Console_Append("Dashboard refreshes ");
+    Console_AppendUnsigned(Dashboard_GetStats()->ulRefreshes);
+    Console_Append(" bytes last ");
+    Console_AppendUnsigned(Dashboard_GetStats()->ulLastBytes);
+    Console_Append(" max ");
+    Console_AppendUnsigned(Dashboard_GetStats()->ulMaxBytes);
+    Console_Flush();
+#endif
+
+#if (configHEAP_COALESCING == 1)
+    /* Free bytes and blocks show the fragmentation, the cycles the allocation latency */
+    vPortGetHeapStats(&xHeapStats);
+    Console_Append("Heap free ");
+    Console_AppendUnsigned(xHeapStats.xAvailableHeapSpaceInBytes);
+    Console_Append(" min ");
+    Console_AppendUnsigned(xHeapStats.xMinimumEverFreeBytesRemaining);
+    Console_Append(" largest ");
+    Console_AppendUnsigned(xHeapStats.xSizeOfLargestFreeBlockInBytes);
+    Console_Append(" blocks ");
+    Console_AppendUnsigned(xHeapStats.xNumberOfFreeBlocks);
+    Console_Flush();
+
+    Console_Append("Heap alloc cycles max ");
+    Console_AppendUnsigned(pxHeapLatency->ulMaxAllocCycles);
+    Console_Append(" avg ");
+    Console_AppendUnsigned(pxHeapLatency->ulTotalAllocCycles /
+                           (xHeapStats.xNumberOfSuccessfulAllocations + pxHeapLatency->ulFailures));
+    Console_Append(" free ");
+    Console_AppendUnsigned(pxHeapLatency->ulMaxFreeCycles);
+    Console_Append(" failed ");
+    Console_AppendUnsigned(pxHeapLatency->ulFailures);
+    Console_Flush();
+#endif
+
+    Console_Append("UART RX overruns ");
+    Console_AppendUnsigned(UART0_GetRxOverruns());
+    Console_Append(" log records dropped ");
+    Console_AppendUnsigned(Log_GetDropped());
+    Console_Flush();
+
+    Console_Append("Button presses lost ");
+    Console_AppendUnsigned(SpscRing_GetOverflows(&xButtonEvents[ISDRIVER]) +
+                           SpscRing_GetOverflows(&xButtonEvents[ISPASSENGER]));
+    Console_Append(" ADC samples lost ");
+    Console_AppendUnsigned(ADC_GetOverflows());
+    Console_Flush();
+}
+
+/* Show or set the error bands of the heater intensities */
+static void prvCommandTune(uint8 ucArgc, char *pcArgv[])
+{
+    IntensityBands xBands;
+    uint32 ulLow, ulMedium, ulHigh;
+    boolean bValid;
+
+    if (ucArgc == 4)
+    {
+        /* Rising up to the largest error, so all three fit the band bytes */
+        bValid = ((Console_ParseUnsigned(pcArgv[1], &ulLow) == TRUE) &&
+                  (Console_ParseUnsigned(pcArgv[2], &ulMedium) == TRUE) &&
+                  (Console_ParseUnsigned(pcArgv[3], &ulHigh) == TRUE) &&
+                  (ulLow < ulMedium) && (ulMedium < ulHigh) && (ulHigh <= INTENSITY_ERROR_MAX_C)) ? TRUE : FALSE;
+        if (bValid == TRUE)
+        {
+            xBands.ucLowFrom = (uint8) ulLow;
+            xBands.ucMediumFrom = (uint8) ulMedium;
+            xBands.ucHighFrom = (uint8) ulHigh;
+            bValid = Intensity_SetBands(&xBands);
+        }
+        if (bValid == FALSE)
+        {
+            Console_Append("usage: tune <low> <medium> <high> rising (C)");
+            Console_Flush();
+            return;
+        }
+    }
+    else if (ucArgc != 1)
+    {
+        Console_Append("usage: tune [<low> <medium> <high>]");
+        Console_Flush();
+        return;
+    }
+
+    Intensity_GetBands(&xBands);
+    Console_Append("bands low ");
+    Console_AppendUnsigned(xBands.ucLowFrom);
+    Console_Append(" medium ");
+    Console_AppendUnsigned(xBands.ucMediumFrom);
+    Console_Append(" high ");
+    Console_AppendUnsigned(xBands.ucHighFrom);
+    Console_Flush();
+}
+
+/* Stack peak and recommended depth of every task in words, or the
+ * definitions of stack_sizes.h that apply them */
+static void prvCommandStacks(uint8 ucArgc, char *pcArgv[])
+{
+    static const char *const pcFormats[] = { "defines" };
+    const StackProfileTask *pxTask;
+    uint32 ulDepths = 0, ulRecommended = 0;
+    boolean bDefines;
+    uint8 ucIndex;
+
+    if ((ucArgc > 2) || ((ucArgc == 2) && (Console_ParseChoice(pcArgv[1], pcFormats, 1) != 0)))
+    {
+        Console_Append("usage: stacks [defines]");
+        Console_Flush();
+        return;
+    }
+    bDefines = (ucArgc == 2) ? TRUE : FALSE;
+
+    StackProfile_Sample();
+    for (ucIndex = 0; ucIndex < StackProfile_GetCount(); ucIndex++)
+    {
+        pxTask = StackProfile_Get(ucIndex);
+        if (bDefines == TRUE)
+        {
+            Console_Append("#define STACK_DEPTH_");
+            Console_Append(pcTaskGetName(pxTask->xTask));
+            Console_Append(" ");
+        }
+        else
+        {
+            Console_Append(pcTaskGetName(pxTask->xTask));
+            Console_Append(" ");
+            Console_AppendUnsigned(pxTask->usPeak);
+            Console_Append("/");
+            Console_AppendUnsigned(pxTask->usDepth);
+            Console_Append(" at ");
+            Console_AppendUnsigned(pxTask->xPeakTick / configTICK_RATE_HZ);
+            Console_Append(" s rec ");
+        }
+        Console_AppendUnsigned(StackProfile_GetRecommended(pxTask));
+        Console_Flush();
+
+        ulDepths += pxTask->usDepth;
+        ulRecommended += StackProfile_GetRecommended(pxTask);
+    }
+
+    if (bDefines == FALSE)
+    {
+        Console_Append("Stacks ");
+        Console_AppendUnsigned(ulDepths);
+        Console_Append(" words, recommended ");
+        Console_AppendUnsigned(ulRecommended);
+        Console_Flush();
+    }
+    else
+    {
+        Console_Append("#define STACK_SIZES_MEASURED 1");
+        Console_Flush();
+    }
+}
+
+/* Cycles and stack words of a context switch between integer tasks and between FPU tasks */
+static void prvCommandCswitch(uint8 ucArgc, char *pcArgv[])
+{
+    static const char *const pcVariants[] = { "Integer", "FPU" };
+    ContextSwitchCost xCost;
+    uint8 ucVariant;
+
+    (void) ucArgc;
+    (void) pcArgv;
+
+    for (ucVariant = 0; ucVariant < 2; ucVariant++)
+    {
+        if (ContextSwitch_Measure((ucVariant == 1) ? TRUE : FALSE, &xCost) == FALSE)
+        {
+            Console_Append("not enough heap for the measurement tasks");
+            Console_Flush();
+            return;
+        }
+        Console_Append(pcVariants[ucVariant]);
+        Console_Append(" switch ");
+        Console_AppendUnsigned(xCost.ulCyclesPerSwitch);
+        Console_Append(" cycles, stack ");
+        Console_AppendUnsigned(xCost.usStackUsed);
+        Console_Append(" words");
+        Console_Flush();
+    }
+
+    Console_Append("Seat pipeline ");
+    Console_Append((TEMPERATURE_FIXED_POINT == 1U) ? "fixed point (no FPU)" : "float");
+    Console_Flush();
+}
+
+/* Heater power policy, then the slots of every seat in the current frame */
+static void prvCommandBudget(uint8 ucArgc, char *pcArgv[])
+{
+    static const char *const pcPolicyNames[] = { "fair", "driver" };
+    static const char *const pcIntensityNames[] = { "off", "low", "medium", "high", "error" };
+    const HeaterBudgetStats *pxStats = HeaterBudget_GetStats();
+    HeaterBudgetSeat xSeat;
+    uint8 ucPolicy, ucSeat;
+
+    if (ucArgc == 2)
+    {
+        ucPolicy = Console_ParseChoice(pcArgv[1], pcPolicyNames, 2);
+        if (ucPolicy >= 2)
+        {
+            Console_Append("usage: budget [fair|driver]");
+            Console_Flush();
+            return;
+        }
+        HeaterBudget_SetPolicy((HeaterBudgetPolicy) ucPolicy);
+        prvSaveSettings();
+    }
+
+    Console_Append("Policy ");
+    Console_Append(pcPolicyNames[HeaterBudget_GetPolicy()]);
+    Console_Append(", limit ");
+    Console_AppendUnsigned(HEATER_BUDGET_LIMIT_SLOTS);
+    Console_Append(" slots per ");
+    Console_AppendUnsigned(HEATER_BUDGET_SLOTS);
+    Console_Append(" x ");
+    Console_AppendUnsigned(HEATER_BUDGET_SLOT_MS);
+    Console_Append(" ms");
+    Console_Flush();
+
+    for (ucSeat = ISDRIVER; ucSeat <= ISPASSENGER; ucSeat++)
+    {
+        HeaterBudget_GetSeat(ucSeat, &xSeat);
+        Console_Append(pcSeatNames[ucSeat]);
+        Console_Append(" ");
+        Console_Append(pcIntensityNames[xSeat.eIntensity]);
+        Console_Append(": ");
+        Console_AppendUnsigned(xSeat.ucGranted);
+        Console_Append(" of ");
+        Console_AppendUnsigned(xSeat.ucDemand);
+        Console_Append(" slots from slot ");
+        Console_AppendUnsigned(xSeat.ucFirstSlot);
+        Console_Flush();
+    }
+
+    Console_AppendUnsigned(pxStats->ulArbitrations);
+    Console_Append(" arbitrations, ");
+    Console_AppendUnsigned(pxStats->ulLimited);
+    Console_Append(" limited, max ");
+    Console_AppendUnsigned(pxStats->ulMaxCycles);
+    Console_Append(" cycles");
+    Console_Flush();
+}
+
+/* EEPROM store figures, then the fault log from the newest record */
+static void prvCommandFaults(uint8 ucArgc, char *pcArgv[])
+{
+    const StoreStats *pxStats = Store_GetStats();
+    StoreFault xFault;
+    uint16 usIndex;
+
+    (void) ucArgc;
+    (void) pcArgv;
+
+    if (pxStats->bAvailable == FALSE)
+    {
+        Console_Append("EEPROM not available, settings are not kept");
+        Console_Flush();
+        return;
+    }
+
+    Console_Append("Writes settings ");
+    Console_AppendUnsigned(pxStats->ulSettingsWrites);
+    Console_Append(" faults ");
+    Console_AppendUnsigned(pxStats->ulFaultWrites);
+    Console_Append(" errors ");
+    Console_AppendUnsigned(pxStats->ulWriteErrors);
+    Console_Append(" max ");
+    Console_AppendUnsigned(pxStats->ulMaxFlushMs);
+    Console_Append(" ms");
+    Console_Flush();
+
+    Console_Append("Coalesced settings ");
+    Console_AppendUnsigned(pxStats->ulSettingsCoalesced);
+    Console_Append(" faults ");
+    Console_AppendUnsigned(pxStats->ulFaultsCoalesced);
+    Console_Append(" dropped ");
+    Console_AppendUnsigned(pxStats->ulFaultsDropped);
+    Console_Flush();
+
+    Console_AppendUnsigned(pxStats->usFaults);
+    Console_Append(" of ");
+    Console_AppendUnsigned(STORE_FAULT_SLOTS);
+    Console_Append(" fault records");
+    Console_Flush();
+
+    for (usIndex = 0; usIndex < pxStats->usFaults; usIndex++)
+    {
+        if (Store_GetFault(usIndex, &xFault) == FALSE)
+        {
+            continue;
+        }
+        Console_Append("#");
+        Console_AppendUnsigned(xFault.ulSequence);
+        Console_Append(" ");
+        Console_Append(Dtc_GetName(xFault.ucCode));
+        Console_Append(" ");
+        Console_AppendFixed(xFault.sReading, 1);
+        Console_Append(" C ");
+        Console_Append((xFault.ucLevel < 4U) ? pcLevelNames[xFault.ucLevel] : "?");
+        Console_Append(" at ");
+        Console_AppendUnsigned(xFault.ulTime);
+        Console_Append(" s x");
+        Console_AppendUnsigned(xFault.usCount);
+        Console_Flush();
+    }
+}
+
+/* Occurrences, aging and freeze frames (both seats) of the DTCs with a status, or clear them */
+static void prvCommandDtc(uint8 ucArgc, char *pcArgv[])
+{
+    static const char *const pcActions[] = { "clear" };
+    static const char *const pcFrames[] = { "  first at ", "  last at " };
+    uint8 ucIds[DTC_COUNT];
+    const DtcSnapshot *pxFrame;
+    DtcRecord xRecord;
+    uint8 ucFound, ucIndex, ucFrame, ucSeat;
+
+    if ((ucArgc > 2) || ((ucArgc == 2) && (Console_ParseChoice(pcArgv[1], pcActions, 1) != 0)))
+    {
+        Console_Append("usage: dtc [clear]");
+        Console_Flush();
+        return;
+    }
+    if (ucArgc == 2)
+    {
+        Dtc_Clear();
+        Console_Append("DTCs cleared, the EEPROM fault log is kept");
+        Console_Flush();
+        return;
+    }
+
+    ucFound = Dtc_Find(DTC_STATUS_ALL, ucIds);
+    Console_AppendUnsigned(ucFound);
+    Console_Append(" of ");
+    Console_AppendUnsigned(DTC_COUNT);
+    Console_Append(" DTCs set");
+    Console_Flush();
+
+    for (ucIndex = 0; ucIndex < ucFound; ucIndex++)
+    {
+        Dtc_GetRecord(ucIds[ucIndex], &xRecord);
+        Console_Append(Dtc_GetName(ucIds[ucIndex]));
+        Console_Append(":");
+        Console_Append((xRecord.ucStatus & DTC_STATUS_TEST_FAILED) ? " failed" : " passed");
+        Console_Append((xRecord.ucStatus & DTC_STATUS_PENDING) ? " pending" : "");
+        Console_Append((xRecord.ucStatus & DTC_STATUS_CONFIRMED) ? " confirmed" : "");
+        Console_Flush();
+
+        Console_Append("  x");
+        Console_AppendUnsigned(xRecord.ucOccurrences);
+        Console_Append(", ");
+        Console_AppendUnsigned(xRecord.ucAging);
+        Console_Append(" of ");
+        Console_AppendUnsigned(DTC_AGING_CYCLES);
+        Console_Append(" cycles to age");
+        Console_Flush();
+
+        for (ucFrame = 0; ucFrame < 2; ucFrame++)
+        {
+            pxFrame = (ucFrame == 0) ? &xRecord.xFirst : &xRecord.xLast;
+            Console_Append(pcFrames[ucFrame]);
+            Console_AppendUnsigned(pxFrame->ulTime);
+            Console_Append(" s:");
+            for (ucSeat = ISDRIVER; ucSeat <= ISPASSENGER; ucSeat++)
+            {
+                Console_Append(" ");
+                Console_AppendFixed(pxFrame->sTemperature[ucSeat], 1);
+                Console_Append(" C ");
+                Console_Append(pcLevelNames[pxFrame->ucLevel[ucSeat] & 3U]);
+            }
+            Console_Flush();
+        }
+    }
+}
+
+#if (DISPLAY_FORMAT == DISPLAY_FORMAT_DASHBOARD)
+/* Clear the terminal and send the whole dashboard with the next refresh */
+static void prvCommandRedraw(uint8 ucArgc, char *pcArgv[])
+{
+    (void) ucArgc;
+    (void) pcArgv;
+
+    Dashboard_Invalidate();
+}
+#endif
+
+static const ConsoleCommand xConsoleCommands[] = {
+    { "budget", "[fair|driver] heater power policy and slots", prvCommandBudget },
+    { "cswitch", "context switch cost, integer and FPU tasks", prvCommandCswitch },
+    { "dtc", "[clear] trouble codes with their freeze frames", prvCommandDtc },
+    { "faults", "EEPROM writes and the stored fault log", prvCommandFaults },
+    { "level", "driver|passenger off|low|medium|high", prvCommandLevel },
+#if (DISPLAY_FORMAT == DISPLAY_FORMAT_DASHBOARD)
+    { "redraw", "clear the terminal and draw the dashboard again", prvCommandRedraw },
+#endif
+    { "stacks", "[defines] stack peaks and recommended depths", prvCommandStacks },
+    { "stats", "log the runtime report now", prvCommandStats },
+    { "trace", "lock times, UART output, heap and lost data", prvCommandTrace },
+    { "tune", "[<low> <medium> <high>] heater error bands (C)", prvCommandTune },
+};
+
 /*----------------------------- Main --------------------------------*/
 int main()
 {
+    static const UserHeatInput xLevelTemps[] = { OFF, LOW, MEDIUM, HIGH };
+    StoreSettings xSettings;
+    uint8 ucIndex;
+
     /* Setup the hardware for use with the Tiva C board. */
     prvSetupHardware();
 
@@ -130,76 +1152,78 @@ int main()
     CurrentTempMutexPassenger = xSemaphoreCreateMutex();
     DesiredTempMutexDriver = xSemaphoreCreateMutex();
     DesiredTempMutexPassenger = xSemaphoreCreateMutex();
-    UARTMutex = xSemaphoreCreateMutex();
+    AdcMutex = xSemaphoreCreateMutex();
 
     /* QUEUE CREATION */
-    Reading_DisplayDriver = xQueueCreate(1, sizeof(uint8));
-    Reading_DisplayPassenger = xQueueCreate(1, sizeof(uint8));
+    Reading_DisplayDriver = xQueueCreate(1, sizeof(Temperature));
+    Reading_DisplayPassenger = xQueueCreate(1, sizeof(Temperature));
     Controller_HeatingDriver = xQueueCreate(1, sizeof(uint8));
     Controller_HeatingPassenger = xQueueCreate(1, sizeof(uint8));
-    Controller_DisplayDriver = xQueueCreate(1, sizeof(uint8));
-    Controller_DisplayPassenger = xQueueCreate(1, sizeof(uint8));
+    Controller_DisplayDriver = xQueueCreate(1, sizeof(HeatIntensity));
+    Controller_DisplayPassenger = xQueueCreate(1, sizeof(HeatIntensity));
 
     /* EVENT CREATION */
     eventTempSet = xEventGroupCreate();
 
+    Sampling_Init(&xSamplingPolicy[ISDRIVER]);
+    Sampling_Init(&xSamplingPolicy[ISPASSENGER]);
+
+    Display_Init(&xDisplaySeat[ISDRIVER]);
+    Display_Init(&xDisplaySeat[ISPASSENGER]);
+
+    Intensity_InitSeat(&xIntensitySeat[ISDRIVER]);
+    Intensity_InitSeat(&xIntensitySeat[ISPASSENGER]);
+    Profile_InitSeat(&xProfileSeat[ISDRIVER]);
+    Profile_InitSeat(&xProfileSeat[ISPASSENGER]);
+
+    /* Heaters off, the slot timer starts with the first partial grant */
+    HeaterBudget_Init(prvDriveHeater);
+
+    Dtc_Init(prvReadDtcSnapshot);
+
+    /* Seat levels and power policy of the last run, all seats OFF without them */
+    (void) Store_Init();
+    Store_GetSettings(&xSettings);
+    if ((xSettings.ucDriverLevel < 4U) && (xSettings.ucPassengerLevel < 4U) &&
+        (xSettings.ucBudgetPolicy <= (uint8) HEATER_BUDGET_DRIVER_PRIORITY))
+    {
+        DriverState = xSettings.ucDriverLevel;
+        PassengerState = xSettings.ucPassengerLevel;
+        DesiredTempDriver = xLevelTemps[DriverState];
+        DesiredTempPassenger = xLevelTemps[PassengerState];
+        HeaterBudget_SetPolicy((HeaterBudgetPolicy) xSettings.ucBudgetPolicy);
+    }
+#if (DISPLAY_FORMAT == DISPLAY_FORMAT_DASHBOARD)
+    Dashboard_Init();
+    prvDrawDashboardLabels();
+#endif
+
+    /* Only the gatekeeper task writes to UART0 */
+    UartGatekeeper_Init();
+    Console_Init(xConsoleCommands, sizeof(xConsoleCommands) / sizeof(xConsoleCommands[0]));
+
     /* Tasks Creation */
-    xTaskCreate(vTempSettingTask, /* Pointer to the function that implements the task. */
-                "SetTempForDriver", /* Text name for the task.  This is to facilitate debugging only. */
-                256, /* Stack depth - most small micro controllers will use much less stack than this. */
-                NULL, /* pvParameters */
-                (configMAX_PRIORITIES - 1), /* This task will run at priority 4. */
-                &vTemperatureSetTaskDrivertHandle); /* We are using the task handle. */
-    xTaskCreate(vTempSettingTask, "SetTempForPassenger", 256, NULL,
-                (configMAX_PRIORITIES - 1),
-                &vTemperatureSetTaskPassengertHandle);
-
-    xTaskCreate(vTempReadingTask, "ReadTempForDriver", 256, ((void*) 0), 3,
-                &vTemperatureReadTaskDriverHandle); // 0 => Driver
-    xTaskCreate(vTempReadingTask, "ReadTempForPassenger", 256, ((void*) 1), 3,
-                &vTemperatureReadTaskPassengerHandle); // 1 => Passenger
-
-    xTaskCreate(vHeaterControllerTask, "ControlTempForDriver", 256, ((void*) 0),
-                2, &vHeaterControllerTaskDriverHandle);
-    xTaskCreate(vHeaterControllerTask, "ControlTempForPassenger", 256,
-                ((void*) 1), 2, &vHeaterControllerTaskPassengerHandle);
-
-    xTaskCreate(vHeaterLedsControllerTask, "ControlLedsForDriver", 256,
-                ((void*) 0), 2, &vHeaterLedsControllerTaskDriverHandle);
-    xTaskCreate(vHeaterLedsControllerTask, "ControlLedsForPassenger", 256,
-                ((void*) 1), 2, &vHeaterLedsControllerTaskPassengerHandle);
-
-    xTaskCreate(vDisplayTask, "DisplayForDriver", 256, ((void*) 0), 2,
-                &vDisplayTaskDriverHandle);
-    xTaskCreate(vDisplayTask, "DisplayForPassenger", 256, ((void*) 1), 2,
-                &vDisplayTaskPassengerHandle);
-
-    xTaskCreate(vRunTimeMeasurementsTask, "RunTimeMeasurements", 256, NULL, 1,
-                &vRunTimeMeasurementsTaskHandle);
-
-    /* Tasks' Tags  */
-    vTaskSetApplicationTaskTag(vTemperatureSetTaskDrivertHandle,
-                               (TaskHookFunction_t) 1);
-    vTaskSetApplicationTaskTag(vTemperatureSetTaskPassengertHandle,
-                               (TaskHookFunction_t) 2);
-    vTaskSetApplicationTaskTag(vTemperatureReadTaskDriverHandle,
-                               (TaskHookFunction_t) 3);
-    vTaskSetApplicationTaskTag(vTemperatureReadTaskPassengerHandle,
-                               (TaskHookFunction_t) 4);
-    vTaskSetApplicationTaskTag(vHeaterControllerTaskDriverHandle,
-                               (TaskHookFunction_t) 5);
-    vTaskSetApplicationTaskTag(vHeaterControllerTaskPassengerHandle,
-                               (TaskHookFunction_t) 6);
-    vTaskSetApplicationTaskTag(vHeaterLedsControllerTaskDriverHandle,
-                               (TaskHookFunction_t) 7);
-    vTaskSetApplicationTaskTag(vHeaterLedsControllerTaskPassengerHandle,
-                               (TaskHookFunction_t) 8);
-    vTaskSetApplicationTaskTag(vDisplayTaskDriverHandle,
-                               (TaskHookFunction_t) 9);
-    vTaskSetApplicationTaskTag(vDisplayTaskPassengerHandle,
-                               (TaskHookFunction_t) 10);
-    vTaskSetApplicationTaskTag(vRunTimeMeasurementsTaskHandle,
-                               (TaskHookFunction_t) 11);
+    for (ucIndex = 0; ucIndex < TASKS_COUNT; ucIndex++)
+    {
+        xTaskCreate(xTaskTable[ucIndex].pxTaskCode, /* Pointer to the function that implements the task. */
+                    xTaskTable[ucIndex].pcName, /* Text name for the task.  This is to facilitate debugging only. */
+                    xTaskTable[ucIndex].usStackDepth, /* Stack depth in words. */
+                    (void*) xTaskTable[ucIndex].ulSeat, /* pvParameters: 0 => Driver, 1 => Passenger */
+                    xTaskTable[ucIndex].uxPriority,
+                    xTaskTable[ucIndex].pxHandle);
+
+        /* Tasks' Tags  */
+        vTaskSetApplicationTaskTag(*xTaskTable[ucIndex].pxHandle,
+                                   (TaskHookFunction_t) (ucIndex + 1));
+
+        StackProfile_Register(*xTaskTable[ucIndex].pxHandle, xTaskTable[ucIndex].usStackDepth);
+    }
+
+    /* Release phases and deadline monitors of the periodic tasks */
+    prvPlanReleases();
+
+    /* Start parked in deep sleep if no seat is heating */
+    Power_UpdateSeatLevels(DesiredTempDriver, DesiredTempPassenger);
 
     vTaskStartScheduler();
 
@@ -209,26 +1233,45 @@ int main()
         ;
 }
 
+/*------------------------- Hook Functions ---------------------------*/
+void vApplicationTickHook(void)
+{
+    TaskMonitor_TickHook();
+}
+
+/* A task ran past its stack (configCHECK_FOR_STACK_OVERFLOW), the other
+ * data is corrupted: stop here for the debugger like configASSERT */
+void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName)
+{
+    /* Nothing can be logged from here, the debugger shows the task name */
+    (void) xTask;
+    (void) pcTaskName;
+
+    taskDISABLE_INTERRUPTS();
+    for (;;)
+        ;
+}
+
 /*------------------------ Handler Functions -------------------------*/
 void GPIOPortF_Handler(void)
 {
     BaseType_t pxHigherPriorityTaskWoken = pdFALSE;
     if (GPIO_PORTF_RIS_REG & (1 << 0))
     { /* PF0 handler code for the DRIVER SEAT  */
+        (void) SpscRing_PushU8(&xButtonEvents[ISDRIVER], ISDRIVER);
         xEventGroupSetBitsFromISR(eventTempSet, mainSW1_INTERRUPT_BIT,
                                   &pxHigherPriorityTaskWoken);
-        DriverState++;
-        DriverState %= 4;
         GPIO_PORTF_ICR_REG |= (1 << 0); /* Clear Trigger flag for PF0 (Interrupt Flag) */
     }
     else if (GPIO_PORTF_RIS_REG & (1 << 4))
     { /* PF4 handler code for the PASSENGER SEAT */
+        (void) SpscRing_PushU8(&xButtonEvents[ISPASSENGER], ISPASSENGER);
         xEventGroupSetBitsFromISR(eventTempSet, mainSW2_INTERRUPT_BIT,
                                   &pxHigherPriorityTaskWoken);
-        PassengerState++;
-        PassengerState %= 4;
         GPIO_PORTF_ICR_REG |= (1 << 4); /* Clear Trigger flag for PF4 (Interrupt Flag) */
     }
+    Power_SeatButtonFromISR();
+    portYIELD_FROM_ISR(pxHigherPriorityTaskWoken);
 }
 
 void GPIOPortB_Handler(void)
@@ -236,12 +1279,13 @@ void GPIOPortB_Handler(void)
     BaseType_t pxHigherPriorityTaskWoken = pdFALSE;
     if (GPIO_PORTB_RIS_REG & (1 << 0))
     { /* PB0 handler code for the DRIVER SEAT  */
+        (void) SpscRing_PushU8(&xButtonEvents[ISDRIVER], ISDRIVER);
         xEventGroupSetBitsFromISR(eventTempSet, mainSW1_INTERRUPT_BIT,
                                   &pxHigherPriorityTaskWoken);
-        DriverState++;
-        DriverState %= 4;
         GPIO_PORTB_ICR_REG |= (1 << 0); /* Clear Trigger flag for PB0 (Interrupt Flag) */
     }
+    Power_SeatButtonFromISR();
+    portYIELD_FROM_ISR(pxHigherPriorityTaskWoken);
 }
 
 /*---------------------------- Functions -------------------------------*/
@@ -249,16 +1293,35 @@ void GPIOPortB_Handler(void)
 //Sensor Reading Function
 void vTempReadingTask(void *pvParameters)
 {
-    const TickType_t xDelay = pdMS_TO_TICKS(200UL);
+    uint8 SeatSelect = (uint8) ((uint32) pvParameters);
+    TaskMonitor *pxMonitor = &xTempReadingMonitor[SeatSelect];
+    SamplingPolicy *pxPolicy = &xSamplingPolicy[SeatSelect];
+    Temperature adc_value;
+    uint32 ulJobStart;
 
-    uint8 SeatSelect = *((uint8*) pvParameters);
-    float32 adc_value;
-
-    TickType_t xStartTime, xEndTime;
+    TickType_t xStartTime, xEndTime, xWakeTick;
     for (;;)
     {
-        adc_value = ((float32) ADC0_readChannel())
-                * ((float) MAXTEMPERATURE / MAXVOLTAGEADC);
+        /* Parked while all seats are OFF, a new operation cycle of the seat DTCs after it */
+        if (Power_WaitActive(&xWakeTick))
+        {
+            TaskMonitor_Restart(pxMonitor, xWakeTick);
+            Dtc_StartCycle(SeatSelect);
+        }
+
+        TaskMonitor_WaitForRelease(pxMonitor);
+
+        /* Slow rate while the seat is stable at its target */
+        if (Sampling_IsDue(pxPolicy) == FALSE)
+        {
+            TaskMonitor_JobDone(pxMonitor);
+            continue;
+        }
+        ulJobStart = GPTM_WTimer0Read();
+
+        (void) xSemaphoreTake(AdcMutex, portMAX_DELAY);
+        adc_value = TEMPERATURE_FROM_COUNTS(ADC0_readChannel() * 10U, MAXVOLTAGEADC_TENTHS);
+        xSemaphoreGive(AdcMutex);
 
         xStartTime = xTaskGetTickCount();
         if (SeatSelect == ISDRIVER)
@@ -287,15 +1350,24 @@ void vTempReadingTask(void *pvParameters)
             xQueueSend(Reading_DisplayPassenger, &adc_value, portMAX_DELAY);
         }
 
-        vTaskDelay(xDelay);
+        /* Debounced sensor range faults, a fixed number of counter updates per sample */
+        Dtc_ReportSensor(SeatSelect, adc_value);
+
+        Sampling_Update(pxPolicy, adc_value,
+                        (SeatSelect == ISDRIVER) ? DesiredTempDriver : DesiredTempPassenger,
+                        GPTM_WTimer0Read() - ulJobStart);
+        TaskMonitor_JobDone(pxMonitor);
     }
 }
 
 void vTempSettingTask(void *pvParameters)
 {
+    uint8 SeatSelect = (uint8) ((uint32) pvParameters);
     EventBits_t xEventGroupValue;
-    const EventBits_t xBitsToWaitFor = ( mainSW1_INTERRUPT_BIT
-            | mainSW2_INTERRUPT_BIT);
+    /* Every instance only handles its own seat */
+    const EventBits_t xBitsToWaitFor = (SeatSelect == ISDRIVER) ? mainSW1_INTERRUPT_BIT : mainSW2_INTERRUPT_BIT;
+    uint8 ucSeats[BUTTON_EVENTS_SIZE];
+    uint32 ulCount, ulIndex;
 
     TickType_t xStartTime, xEndTime;
     for (;;)
@@ -307,6 +1379,23 @@ void vTempSettingTask(void *pvParameters)
                                                pdFALSE, /* Dont't Wait for all bits. */
                                                portMAX_DELAY); /* Don't time out. */
 
+        /* Step the level by the button presses of the seat, the console sets
+         * it directly in a critical section as well */
+        ulCount = SpscRing_PopBatchU8(&xButtonEvents[SeatSelect], ucSeats, BUTTON_EVENTS_SIZE);
+        taskENTER_CRITICAL();
+        for (ulIndex = 0; ulIndex < ulCount; ulIndex++)
+        {
+            if (SeatSelect == ISDRIVER)
+            {
+                DriverState = (DriverState + 1U) % 4U;
+            }
+            else
+            {
+                PassengerState = (PassengerState + 1U) % 4U;
+            }
+        }
+        taskEXIT_CRITICAL();
+
         if ((xEventGroupValue & mainSW1_INTERRUPT_BIT) != 0)
         { /*Driver*/
             xStartTime = xTaskGetTickCount();
@@ -329,6 +1418,7 @@ void vTempSettingTask(void *pvParameters)
                 }
                 xSemaphoreGive(DesiredTempMutexDriver); /* Release the resource */
             }
+            Sampling_SetPointChanged(&xSamplingPolicy[ISDRIVER]);
             xEndTime = xTaskGetTickCount();
             DesiredTempSettingTaskDriverLT += xEndTime - xStartTime;
         }
@@ -356,24 +1446,31 @@ void vTempSettingTask(void *pvParameters)
                 }
                 xSemaphoreGive(DesiredTempMutexPassenger); /* Release the resource */
             }
+            Sampling_SetPointChanged(&xSamplingPolicy[ISPASSENGER]);
             xEndTime = xTaskGetTickCount();
             DesiredTempSettingTaskPassengerLT += xEndTime - xStartTime;
         }
+
+        /* Deep sleep when both seats are OFF, wake up the pipeline otherwise */
+        Power_UpdateSeatLevels(DesiredTempDriver, DesiredTempPassenger);
+
+        prvSaveSettings();
     }
 }
 
 void vHeaterControllerTask(void *pvParameters)
 {
-    const TickType_t xDelay = pdMS_TO_TICKS(200UL);
-
-    float32 CurrentTemp = 0;
+    Temperature CurrentTemp = 0;
     UserHeatInput DesiredTemp = OFF;
 
-    uint8 SeatSelect = *((uint8*) pvParameters);
+    uint8 SeatSelect = (uint8) ((uint32) pvParameters);
+    TaskMonitor *pxMonitor = &xHeaterControllerMonitor[SeatSelect];
 
-    TickType_t xStartTime, xEndTime;
+    TickType_t xStartTime, xEndTime, xWakeTick;
     for (;;)
     {
+        TaskMonitor_WaitForRelease(pxMonitor);
+
         if (SeatSelect == ISDRIVER)
         {
             xStartTime = xTaskGetTickCount();
@@ -394,31 +1491,14 @@ void vHeaterControllerTask(void *pvParameters)
             xEndTime = xTaskGetTickCount();
             DesiredTempControllerTaskDriverLT += xEndTime - xStartTime;
 
-            if (CurrentTemp < 5 || CurrentTemp > 40)
-            {
-                heatIntensity = ERROR;
-            }
-            else if ((DesiredTemp - CurrentTemp) >= 10)
-            {
-                heatIntensity = HIGHINTENSITY;
-            }
-            else if ((DesiredTemp - CurrentTemp) >= 5
-                    && (DesiredTemp - CurrentTemp) < 10)
-            {
-                heatIntensity = MEDIUMINTENSITY;
-            }
-            else if ((DesiredTemp - CurrentTemp) >= 2
-                    && (DesiredTemp - CurrentTemp) < 5)
-            {
-                heatIntensity = LOWINTENSITY;
-            }
-            else
-            {
-                heatIntensity = INTENSITYOFF;
-            }
+            /* Bands of intensity_cfg.h with hysteresis and dwell time, ERROR outside of the sensor range */
+            heatIntensity = Intensity_Update(&xIntensitySeat[ISDRIVER], DesiredTemp, CurrentTemp);
+            /* The boost steps of the level profile come first, then the bands */
+            heatIntensity = Profile_Evaluate(&xProfileSeat[ISDRIVER], DesiredTemp, CurrentTemp, heatIntensity);
 
             xQueueSend(Controller_HeatingDriver, &heatIntensity, portMAX_DELAY);
-            xQueueSend(Controller_DisplayDriver, &heatIntensity, portMAX_DELAY); /* Send Heat State to Display */
+            /* The display only follows the samples, so it gets the latest state */
+            xQueueOverwrite(Controller_DisplayDriver, &heatIntensity); /* Send Heat State to Display */
         }
         else if (SeatSelect == ISPASSENGER)
         {
@@ -442,134 +1522,52 @@ void vHeaterControllerTask(void *pvParameters)
             xEndTime = xTaskGetTickCount();
             DesiredTempControllerTaskPassengerLT += xEndTime - xStartTime;
 
-            if (CurrentTemp < 5 || CurrentTemp > 40)
-            {
-                heatIntensity = ERROR;
-                //EEPROMWrite((uint32)Reading, 1, 1) ;
-            }
-            else if ((DesiredTemp - CurrentTemp) >= 10)
-            {
-                heatIntensity = HIGHINTENSITY;
-            }
-            else if ((DesiredTemp - CurrentTemp) >= 5
-                    && (DesiredTemp - CurrentTemp) < 10)
-            {
-                heatIntensity = MEDIUMINTENSITY;
-            }
-            else if ((DesiredTemp - CurrentTemp) >= 2
-                    && (DesiredTemp - CurrentTemp) < 5)
-            {
-                heatIntensity = LOWINTENSITY;
-            }
-            else
-            {
-                heatIntensity = INTENSITYOFF;
-            }
+            heatIntensity = Intensity_Update(&xIntensitySeat[ISPASSENGER], DesiredTemp, CurrentTemp);
+            heatIntensity = Profile_Evaluate(&xProfileSeat[ISPASSENGER], DesiredTemp, CurrentTemp, heatIntensity);
 
             xQueueSend(Controller_HeatingPassenger, &heatIntensity,
                        portMAX_DELAY);
-            xQueueSend(Controller_DisplayPassenger, &heatIntensity,
-                       portMAX_DELAY); /* Send Heat State to Display */
+            xQueueOverwrite(Controller_DisplayPassenger, &heatIntensity); /* Send Heat State to Display */
         }
 
-        vTaskDelay(xDelay);
+        TaskMonitor_JobDone(pxMonitor);
+
+        /* Parked while all seats are OFF, once a job has seen OFF and turned the heater off */
+        if ((DesiredTemp == OFF) && Power_WaitActive(&xWakeTick))
+        {
+            TaskMonitor_Restart(pxMonitor, xWakeTick);
+        }
     }
 }
 
 void vHeaterLedsControllerTask(void *pvParameters)
 {
 
-    uint8 SeatSelect = *((uint8*) pvParameters);
+    uint8 SeatSelect = (uint8) ((uint32) pvParameters);
     HeatIntensity selectedHeatingIntensity;
 
     for (;;)
     {
-        if (SeatSelect == ISDRIVER)
-        {
-            xQueueReceive(Controller_HeatingDriver, &selectedHeatingIntensity,
-            portMAX_DELAY);
+        xQueueReceive((SeatSelect == ISDRIVER) ? Controller_HeatingDriver : Controller_HeatingPassenger,
+                      &selectedHeatingIntensity, portMAX_DELAY);
 
-            switch (selectedHeatingIntensity)
-            {
-            case ERROR:
-                GPIO_RedLed1On();
-                GPIO_BlueLed1Off();
-                GPIO_GreenLed1Off();
-                break;
-
-            case INTENSITYOFF:
-                GPIO_RedLed1Off();
-                GPIO_BlueLed1Off();
-                GPIO_GreenLed1Off();
-                break;
-
-            case LOWINTENSITY:
-                GPIO_RedLed1Off();
-                GPIO_BlueLed1Off();
-                GPIO_GreenLed1On();
-                break;
-
-            case MEDIUMINTENSITY:
-                GPIO_RedLed1Off();
-                GPIO_BlueLed1On();
-                GPIO_GreenLed1Off();
-                break;
-
-            case HIGHINTENSITY:
-                GPIO_RedLed1Off();
-                GPIO_BlueLed1On();
-                GPIO_GreenLed1On();
-                break;
-            }
-        }
-        else if (SeatSelect == ISPASSENGER)
-        {
-            xQueueReceive(Controller_HeatingPassenger,
-                          &selectedHeatingIntensity, portMAX_DELAY);
+        /* The power budget shares the harness current between the seats and
+         * switches the heater in its slots through prvDriveHeater() */
+        HeaterBudget_Request(SeatSelect, selectedHeatingIntensity);
 
-            switch (selectedHeatingIntensity)
-            {
-            case ERROR:
-                GPIO_RedLed2On();
-                GPIO_BlueLed2Off();
-                GPIO_GreenLed2Off();
-                break;
-
-            case INTENSITYOFF:
-                GPIO_RedLed2Off();
-                GPIO_BlueLed2Off();
-                GPIO_GreenLed2Off();
-                break;
-
-            case LOWINTENSITY:
-                GPIO_RedLed2Off();
-                GPIO_BlueLed2Off();
-                GPIO_GreenLed2On();
-                break;
-
-            case MEDIUMINTENSITY:
-                GPIO_RedLed2Off();
-                GPIO_BlueLed2On();
-                GPIO_GreenLed2Off();
-                break;
-
-            case HIGHINTENSITY:
-                GPIO_RedLed2Off();
-                GPIO_BlueLed2On();
-                GPIO_GreenLed2On();
-                break;
-            }
-        }
+        Power_ControlOutput();
     }
 }
 
 void vDisplayTask(void *pvParameters)
 {
 
-    uint8 SeatSelect = *((uint8*) pvParameters);
+    uint8 SeatSelect = (uint8) ((uint32) pvParameters);
     HeatIntensity DriverHeatState, PassengerHeatState;
-    uint8 DriverCurrentTemp, PassengerCurrentTemp;
+    Temperature DriverCurrentTemp, PassengerCurrentTemp;
     UserHeatInput DriverHeatLevel, PassengerHeatLevel;
+    uint32 ulJobStart;
+    uint8 ucBytes;
 
     TickType_t xStartTime, xEndTime;
     for (;;)
@@ -593,41 +1591,9 @@ void vDisplayTask(void *pvParameters)
                     DesiredTempDisplayTaskDriverLT += xEndTime - xStartTime;
 
                     /********* DISPLAY ON SCREEN USING UART ********/
-                    xStartTime = xTaskGetTickCount();
-                    if (xSemaphoreTake(UARTMutex, portMAX_DELAY) == pdTRUE)
-                    { /* Receive Heat Level to Display */
-                        UART0_SendString("Driver:");
-
-                        UART0_SendString("\nCurrent Temperature = ");
-                        UART0_SendByte(DriverCurrentTemp);
-
-                        UART0_SendString("\nRequired Heat Level = ");
-                        UART0_SendByte(DriverHeatLevel);
-
-                        UART0_SendString("\nThe Heater is Working with ");
-                        switch (DriverHeatState)
-                        {
-                        case (ERROR):
-                            UART0_SendString("NO Intensity due to error");
-                            break;
-                        case (INTENSITYOFF):
-                            UART0_SendString("NO Intensity");
-                            break;
-                        case (LOWINTENSITY):
-                            UART0_SendString("LOW Intensity");
-                            break;
-                        case (MEDIUMINTENSITY):
-                            UART0_SendString("MEDIUM Intensity");
-                            break;
-                        case (HIGHINTENSITY):
-                            UART0_SendString("HIGH Intensity");
-                            break;
-                        }
-
-                        xSemaphoreGive(UARTMutex); /* Release the resource */
-                        xEndTime = xTaskGetTickCount();
-                        UARTDisplayTaskDriverLT += xEndTime - xStartTime;
-                    }
+                    ulJobStart = GPTM_WTimer0Read();
+                    ucBytes = prvDisplaySeat(ISDRIVER, DriverCurrentTemp, DriverHeatLevel, DriverHeatState);
+                    Sampling_AccountDisplay(&xSamplingPolicy[ISDRIVER], GPTM_WTimer0Read() - ulJobStart, ucBytes);
                 }
             }
         }
@@ -650,41 +1616,9 @@ void vDisplayTask(void *pvParameters)
                     DesiredTempDisplayTaskPassengerLT += xEndTime - xStartTime;
 
                     /********* DISPLAY ON SCREEN USING UART ********/
-                    xStartTime = xTaskGetTickCount();
-                    if (xSemaphoreTake(UARTMutex, portMAX_DELAY) == pdTRUE)
-                    { /* Receive Heat Level to Display */
-                        UART0_SendString("Passenger:");
-
-                        UART0_SendString("\nCurrent Temperature = ");
-                        UART0_SendByte(PassengerCurrentTemp);
-
-                        UART0_SendString("\nRequired Heat Level = ");
-                        UART0_SendByte(PassengerHeatLevel);
-
-                        UART0_SendString("\nThe Heater is Working with ");
-                        switch (PassengerHeatState)
-                        {
-                        case (ERROR):
-                            UART0_SendString("NO Intensity due to error");
-                            break;
-                        case (INTENSITYOFF):
-                            UART0_SendString("NO Intensity");
-                            break;
-                        case (LOWINTENSITY):
-                            UART0_SendString("LOW Intensity");
-                            break;
-                        case (MEDIUMINTENSITY):
-                            UART0_SendString("MEDIUM Intensity");
-                            break;
-                        case (HIGHINTENSITY):
-                            UART0_SendString("HIGH Intensity");
-                            break;
-                        }
-
-                        xSemaphoreGive(UARTMutex); /* Release the resource */
-                        xEndTime = xTaskGetTickCount();
-                        UARTDisplayTaskPassengerLT += xEndTime - xStartTime;
-                    }
+                    ulJobStart = GPTM_WTimer0Read();
+                    ucBytes = prvDisplaySeat(ISPASSENGER, PassengerCurrentTemp, PassengerHeatLevel, PassengerHeatState);
+                    Sampling_AccountDisplay(&xSamplingPolicy[ISPASSENGER], GPTM_WTimer0Read() - ulJobStart, ucBytes);
                 }
             }
         }
@@ -693,34 +1627,107 @@ void vDisplayTask(void *pvParameters)
 
 void vRunTimeMeasurementsTask(void *pvParameters)
 {
-    const TickType_t xDelay = pdMS_TO_TICKS(200UL);
-    vTaskDelay(xDelay);
+    uint8 ucCPU_Load;
+    const PowerStats *pxPower = Power_GetStats();
+    /* CPU load window: WTimer0 time (0.1 ms) and tickless sleep time (us) at its start */
+    uint32 ulWindowStart = GPTM_WTimer0Read();
+    uint32 ulSleepStart = pxPower->ulSleepTime;
+    uint32 ulWindow, ulSlept;
+
+    TickType_t xWakeTick;
+    for (;;)
+    {
+        TaskMonitor_WaitForRelease(&xRunTimeMeasurementsMonitor);
 
-    uint8 ucCounter, ucCPU_Load;
-    uint32 ullTotalTasksTime = 0;
+        /* The CPU is loaded whenever the core is not sleeping in the Idle task */
+        ulWindow = GPTM_WTimer0Read() - ulWindowStart;
+        ulSlept = (pxPower->ulSleepTime - ulSleepStart) / 100U;
+        ucCPU_Load = (ulWindow > ulSlept) ? (uint8)(((ulWindow - ulSlept) * 100U) / ulWindow) : 0;
+        ulWindowStart += ulWindow;
+        ulSleepStart = pxPower->ulSleepTime;
 
-    TickType_t xStartTime, xEndTime;
-    TickType_t xLastWakeTime = xTaskGetTickCount();
+        ucLastCpuLoad = ucCPU_Load;
+        prvLogRuntimeReport(ucCPU_Load);
+        StackProfile_Sample();
+
+        /* Scale the system clock to the load, done by the owner of the UART */
+        UartGatekeeper_Call(prvUpdateClock, ucCPU_Load);
+
+        TaskMonitor_JobDone(&xRunTimeMeasurementsMonitor);
+
+        if (Power_WaitActive(&xWakeTick))
+        {
+            TaskMonitor_Restart(&xRunTimeMeasurementsMonitor, xWakeTick);
+        }
+    }
+}
+
+/* Packs the tokenized log records into telemetry frames at the lowest
+ * priority and queues them to the UART gatekeeper. The dashboard terminal
+ * cannot show binary frames, it draws the statistics itself. */
+void vLoggerTask(void *pvParameters)
+{
     for (;;)
     {
-        ullTotalTasksTime = 0;
-        vTaskDelayUntil(&xLastWakeTime, RUNTIME_MEASUREMENTS_TASK_PERIODICITY);
-        for (ucCounter = 1; ucCounter <= 11; ucCounter++)
+        Log_WaitPending();
+
+        while (Log_IsPending() == TRUE)
         {
-            ullTotalTasksTime += ullTasksExecutionTime[ucCounter];
+#if (DISPLAY_FORMAT == DISPLAY_FORMAT_DASHBOARD)
+            Log_Discard();
+#else
+            Log_SendFrame();
+#endif
         }
-        ucCPU_Load = (ullTotalTasksTime * 100) / GPTM_WTimer0Read();
+    }
+}
 
-        xStartTime = xTaskGetTickCount();
-        if (xSemaphoreTake(UARTMutex, portMAX_DELAY) == pdTRUE)
+/* Runs the commands typed on the UART0 terminal at the lowest priority */
+void vConsoleTask(void *pvParameters)
+{
+    for (;;)
+    {
+        Console_ProcessInput();
+    }
+}
+
+/* Owns UART0: sends the messages handed over by the other tasks */
+void vUartGatekeeperTask(void *pvParameters)
+{
+    for (;;)
+    {
+        UartGatekeeper_ProcessOutput();
+    }
+}
+
+/* Writes the changed settings and the new faults to the EEPROM at the lowest
+ * priority, so the control tasks never wait for the programming */
+void vStoreTask(void *pvParameters)
+{
+    for (;;)
+    {
+        Store_Process();
+    }
+}
+
+#if (DISPLAY_FORMAT == DISPLAY_FORMAT_DASHBOARD)
+/* Draws the dashboard and sends the changed cells at the lowest priority,
+ * parked with the pipeline in deep sleep */
+void vDashboardTask(void *pvParameters)
+{
+    TickType_t xLastWakeTime = xTaskGetTickCount();
+    TickType_t xWakeTick;
+
+    for (;;)
+    {
+        prvDrawDashboard();
+        (void) Dashboard_Refresh();
+
+        if (Power_WaitActive(&xWakeTick))
         {
-            UART0_SendString("CPU Load is ");
-            UART0_SendInteger(ucCPU_Load);
-            UART0_SendString("% \r\n");
-            /* Release the peripheral */
-            xSemaphoreGive(UARTMutex);
+            xLastWakeTime = xWakeTick;
         }
-        xEndTime = xTaskGetTickCount();
-        UARTRunTimeMeasurementsTaskLT = xEndTime - xStartTime;
+        vTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(DASHBOARD_TASK_PERIOD_MS));
     }
 }
+#endif